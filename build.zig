@@ -13,6 +13,13 @@ fn makeRuntimeModule(
     });
     module.addIncludePath(b.path("include"));
     module.addCSourceFile(.{ .file = b.path("src/jzx_runtime.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_net.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_file.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_record.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_perf.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_metrics.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_shm.c") });
+    module.addCSourceFile(.{ .file = b.path("src/jzx_node.c") });
     module.linkSystemLibrary("pthread", .{});
     return module;
 }
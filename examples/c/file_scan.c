@@ -0,0 +1,87 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "jzx/file.h"
+#include "jzx/jzx.h"
+
+// Sequential scan through jzx_file_read: checksums every byte of a file from
+// the mapped chunk views without copying.
+//
+//   file_scan <path> [chunk_kib] [credits]
+
+typedef struct {
+    jzx_loop* loop;
+    uint64_t bytes;
+    uint64_t chunks;
+    uint64_t sum;
+    int error;
+} scan_state;
+
+static jzx_behavior_result scan_behavior(jzx_context* ctx, const jzx_message* msg) {
+    scan_state* st = (scan_state*)ctx->state;
+    jzx_file_chunk* chunk = (jzx_file_chunk*)msg->data;
+    if (msg->tag == JZX_TAG_FILE_CHUNK) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < chunk->len; i += 64) {
+            sum += chunk->bytes[i];
+        }
+        st->sum += sum;
+        st->bytes += chunk->len;
+        st->chunks++;
+        jzx_file_chunk_release(st->loop, chunk);
+        return JZX_BEHAVIOR_OK;
+    }
+    if (msg->tag == JZX_TAG_FILE_EOF) {
+        st->error = chunk->error;
+        jzx_file_chunk_release(st->loop, chunk);
+        return JZX_BEHAVIOR_STOP;
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <path> [chunk_kib] [credits]\n", argv[0]);
+        return 1;
+    }
+    int fd = open(argv[1], O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        return 1;
+    }
+    jzx_loop* loop = jzx_loop_create(NULL);
+    scan_state st = {.loop = loop};
+    jzx_spawn_opts opts = {.behavior = scan_behavior, .state = &st};
+    jzx_actor_id owner = 0;
+    jzx_spawn(loop, &opts, &owner);
+    jzx_file_read_opts ropts = {
+        .fd = fd,
+        .owner = owner,
+        .chunk_size = argc > 2 ? (uint32_t)atoi(argv[2]) * 1024u : 0,
+        .credits = argc > 3 ? (uint32_t)atoi(argv[3]) : 0,
+    };
+    if (jzx_file_read(loop, &ropts, NULL) != JZX_OK) {
+        fprintf(stderr, "jzx_file_read failed\n");
+        return 1;
+    }
+    close(fd);
+
+    double start = now_s();
+    jzx_loop_run(loop);
+    double elapsed = now_s() - start;
+    printf("bytes=%llu chunks=%llu error=%d elapsed=%.3fs rate=%.1f MiB/s sum=%llu\n",
+           (unsigned long long)st.bytes, (unsigned long long)st.chunks, st.error, elapsed,
+           elapsed > 0 ? (double)st.bytes / elapsed / (1024.0 * 1024.0) : 0.0,
+           (unsigned long long)st.sum);
+    jzx_loop_destroy(loop);
+    return st.error == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "jzx/jzx.h"
+#include "jzx/net.h"
+
+// Loopback echo benchmark: one loop thread serves every connection through
+// jzx_net (LEN32 framing); client threads do blocking request/response.
+//
+//   net_echo_bench [clients] [round_trips_per_client] [payload_bytes]
+
+typedef struct {
+    jzx_net* net;
+} echo_state;
+
+typedef struct {
+    uint16_t port;
+    int round_trips;
+    size_t payload;
+    double elapsed_s;
+    int ok;
+} client_args;
+
+static jzx_loop* g_loop;
+static int g_clients_left;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static jzx_behavior_result echo_behavior(jzx_context* ctx, const jzx_message* msg) {
+    echo_state* st = (echo_state*)ctx->state;
+    jzx_net_frame* frame = (jzx_net_frame*)msg->data;
+    if (msg->tag == JZX_TAG_NET_DATA) {
+        jzx_net_write(st->net, frame->conn, frame->bytes, frame->len);
+    }
+    if (msg->tag == JZX_TAG_NET_DATA || msg->tag == JZX_TAG_NET_OPEN ||
+        msg->tag == JZX_TAG_NET_CLOSED) {
+        jzx_net_frame_release(st->net, frame);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static jzx_actor_id pick_echo(void* ctx, jzx_loop* loop, jzx_actor_id conn) {
+    (void)loop;
+    (void)conn;
+    return *(jzx_actor_id*)ctx;
+}
+
+static int write_all(int fd, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void* client_main(void* arg) {
+    client_args* a = (client_args*)arg;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(a->port)};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        uint8_t* out = (uint8_t*)malloc(a->payload + 4);
+        uint8_t* in = (uint8_t*)malloc(a->payload + 4);
+        uint32_t be = htonl((uint32_t)a->payload);
+        memcpy(out, &be, 4);
+        memset(out + 4, 'x', a->payload);
+        double start = now_s();
+        a->ok = 1;
+        for (int i = 0; i < a->round_trips; ++i) {
+            if (write_all(fd, out, a->payload + 4) != 0 || read_all(fd, in, a->payload + 4) != 0) {
+                a->ok = 0;
+                break;
+            }
+        }
+        a->elapsed_s = now_s() - start;
+        free(out);
+        free(in);
+    }
+    close(fd);
+    pthread_mutex_lock(&g_lock);
+    if (--g_clients_left == 0) {
+        jzx_loop_request_stop(g_loop);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? atoi(argv[1]) : 4;
+    int round_trips = argc > 2 ? atoi(argv[2]) : 20000;
+    size_t payload = argc > 3 ? (size_t)atoi(argv[3]) : 64;
+
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = 0};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t alen = sizeof(addr);
+    if (bind(lfd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(lfd, 128) != 0 ||
+        getsockname(lfd, (struct sockaddr*)&addr, &alen) != 0) {
+        perror("listen");
+        return 1;
+    }
+
+    g_loop = jzx_loop_create(NULL);
+    jzx_net* net = jzx_net_create(g_loop, 0, 0);
+    echo_state st = {.net = net};
+    jzx_spawn_opts opts = {.behavior = echo_behavior, .state = &st};
+    jzx_actor_id echo = 0;
+    jzx_spawn(g_loop, &opts, &echo);
+    jzx_net_listen_opts lopts = {
+        .conn = {.framing = JZX_NET_FRAME_LEN32, .pause_depth = 512},
+        .on_accept = pick_echo,
+        .accept_ctx = &echo,
+    };
+    if (jzx_net_listen(net, lfd, &lopts, NULL) != JZX_OK) {
+        fprintf(stderr, "jzx_net_listen failed\n");
+        return 1;
+    }
+
+    g_clients_left = clients;
+    pthread_t* threads = (pthread_t*)calloc((size_t)clients, sizeof(pthread_t));
+    client_args* args = (client_args*)calloc((size_t)clients, sizeof(client_args));
+    for (int i = 0; i < clients; ++i) {
+        args[i] = (client_args){.port = ntohs(addr.sin_port), .round_trips = round_trips, .payload = payload};
+        pthread_create(&threads[i], NULL, client_main, &args[i]);
+    }
+    jzx_loop_run(g_loop);
+
+    double worst = 0;
+    long total = 0;
+    for (int i = 0; i < clients; ++i) {
+        pthread_join(threads[i], NULL);
+        if (!args[i].ok) {
+            fprintf(stderr, "client %d failed\n", i);
+            continue;
+        }
+        total += args[i].round_trips;
+        if (args[i].elapsed_s > worst) worst = args[i].elapsed_s;
+    }
+    jzx_net_stats ns;
+    jzx_net_get_stats(net, &ns);
+    printf("clients=%d payload=%zu round_trips=%ld elapsed=%.3fs rate=%.0f rt/s avg_rtt=%.1fus\n",
+           clients, payload, total, worst, worst > 0 ? (double)total / worst : 0.0,
+           total > 0 ? worst * 1e6 * clients / (double)total : 0.0);
+    printf("frames_in=%llu writev_calls=%llu bytes_in=%llu bytes_out=%llu read_pauses=%llu\n",
+           (unsigned long long)ns.frames_in, (unsigned long long)ns.writev_calls,
+           (unsigned long long)ns.bytes_in, (unsigned long long)ns.bytes_out,
+           (unsigned long long)ns.read_pauses);
+
+    free(threads);
+    free(args);
+    jzx_net_destroy(net);
+    jzx_loop_destroy(g_loop);
+    return 0;
+}
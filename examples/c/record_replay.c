@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jzx/jzx.h"
+#include "jzx/record.h"
+
+// Records a small fan-out workload to a log, then replays it twice: as fast as
+// the loop drains and with the recorded inter-arrival gaps.
+//
+//   record_replay [path] [messages]
+
+typedef struct {
+    jzx_loop* loop;
+    jzx_actor_id workers[4];
+    uint32_t remaining;
+} source_state;
+
+typedef struct {
+    uint64_t seen;
+    uint64_t bytes;
+} sink_state;
+
+static jzx_behavior_result source_behavior(jzx_context* ctx, const jzx_message* msg) {
+    (void)msg;
+    source_state* s = (source_state*)ctx->state;
+    if (s->remaining == 0) {
+        return JZX_BEHAVIOR_STOP;
+    }
+    s->remaining--;
+    uint32_t* value = (uint32_t*)jzx_loop_alloc(s->loop, sizeof(uint32_t));
+    *value = s->remaining;
+    jzx_send(s->loop, s->workers[s->remaining % 4u], value, sizeof(uint32_t), 1);
+    // Pace the workload so the recording has gaps worth replaying.
+    jzx_send_after(s->loop, ctx->self, 1, NULL, 0, 0, NULL);
+    return JZX_BEHAVIOR_OK;
+}
+
+static jzx_behavior_result sink_behavior(jzx_context* ctx, const jzx_message* msg) {
+    sink_state* s = (sink_state*)ctx->state;
+    s->seen++;
+    s->bytes += msg->len;
+    if (msg->data) {
+        jzx_loop_free(ctx->loop, msg->data);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static sink_state g_replay_sinks[8];
+static uint32_t g_replay_used;
+
+static jzx_err resolve_sink(void* ctx, jzx_actor_id recorded, uint32_t first_tag, jzx_spawn_opts* opts) {
+    (void)ctx;
+    (void)recorded;
+    // Tag 1 goes to workers; the source's own ticks are not replayed.
+    if (first_tag != 1 || g_replay_used == 8) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    sink_state* s = &g_replay_sinks[g_replay_used++];
+    memset(s, 0, sizeof(*s));
+    opts->behavior = sink_behavior;
+    opts->state = s;
+    return JZX_OK;
+}
+
+static int replay(jzx_loop* loop, const char* path, uint8_t realtime) {
+    g_replay_used = 0;
+    jzx_replay_opts opts = {.path = path, .resolve = resolve_sink, .realtime = realtime};
+    jzx_replay_stats stats;
+    jzx_err err = jzx_replay(loop, &opts, &stats);
+    if (err != JZX_OK) {
+        fprintf(stderr, "replay failed: %d\n", (int)err);
+        return 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < g_replay_used; ++i) {
+        seen += g_replay_sinks[i].seen;
+    }
+    printf("replay %-8s records=%llu delivered=%llu skipped=%llu seen=%llu recorded=%.1fms elapsed=%.1fms\n",
+           realtime ? "realtime" : "max", (unsigned long long)stats.records,
+           (unsigned long long)stats.delivered, (unsigned long long)stats.skipped,
+           (unsigned long long)seen, (double)stats.recorded_ns / 1e6, (double)stats.elapsed_ns / 1e6);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "record_replay.jzxrec";
+    uint32_t messages = argc > 2 ? (uint32_t)atoi(argv[2]) : 200;
+
+    jzx_config cfg;
+    jzx_config_init(&cfg);
+    jzx_loop* loop = jzx_loop_create(&cfg);
+    if (!loop) {
+        fprintf(stderr, "jzx_loop_create failed\n");
+        return 1;
+    }
+
+    sink_state sinks[4];
+    memset(sinks, 0, sizeof(sinks));
+    source_state source = {.loop = loop, .remaining = messages};
+    for (uint32_t i = 0; i < 4; ++i) {
+        jzx_spawn_opts opts = {.behavior = sink_behavior, .state = &sinks[i]};
+        jzx_spawn(loop, &opts, &source.workers[i]);
+    }
+    jzx_spawn_opts source_opts = {.behavior = source_behavior, .state = &source};
+    jzx_actor_id source_id = 0;
+    jzx_spawn(loop, &source_opts, &source_id);
+
+    jzx_record_opts rec = {.path = path, .payloads = 1};
+    if (jzx_record_start(loop, &rec) != JZX_OK) {
+        fprintf(stderr, "cannot record to %s\n", path);
+        return 1;
+    }
+    jzx_send(loop, source_id, NULL, 0, 0);
+    while (source.remaining > 0 || jzx_loop_next_deadline(loop) == 0) {
+        jzx_loop_run_once(loop, 10);
+    }
+    jzx_record_stats rs;
+    jzx_record_stop(loop, &rs);
+    printf("recorded records=%llu dropped=%llu bytes=%llu error=%d\n", (unsigned long long)rs.records,
+           (unsigned long long)rs.dropped, (unsigned long long)rs.bytes, rs.error);
+    for (uint32_t i = 0; i < 4; ++i) {
+        jzx_actor_stop(loop, source.workers[i]);
+    }
+    jzx_loop_run_once(loop, 0);
+
+    int rc = replay(loop, path, 0) || replay(loop, path, 1);
+    jzx_loop_destroy(loop);
+    return rc;
+}
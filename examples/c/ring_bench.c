@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "jzx/jzx.h"
+
+// Token ring: N actors pass tokens to their neighbour until each token has
+// gone round the ring `laps` times. The tag carries a token's hop count. With
+// a large ring every hop lands on an actor that is cold in cache, so the cost
+// is dominated by send + dispatch.
+//
+//   ring_bench [actors] [laps] [tokens]
+
+typedef struct {
+    jzx_loop* loop;
+    jzx_actor_id next;
+} ring_node;
+
+static uint64_t g_hops;
+static uint32_t g_hops_per_token;
+
+static jzx_behavior_result ring_behavior(jzx_context* ctx, const jzx_message* msg) {
+    ring_node* node = (ring_node*)ctx->state;
+    g_hops++;
+    if (msg->tag + 1u < g_hops_per_token) {
+        jzx_err err = jzx_send(node->loop, node->next, NULL, 0, msg->tag + 1u);
+        if (err != JZX_OK) {
+            fprintf(stderr, "send failed at hop %llu: %d\n", (unsigned long long)g_hops, (int)err);
+            exit(1);
+        }
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    uint32_t actors = argc > 1 ? (uint32_t)atoi(argv[1]) : 100000;
+    uint32_t laps = argc > 2 ? (uint32_t)atoi(argv[2]) : 10;
+    uint32_t tokens = argc > 3 ? (uint32_t)atoi(argv[3]) : 10;
+    uint64_t per_token = (uint64_t)actors * laps;
+    if (actors < 2 || laps == 0 || tokens == 0 || per_token > UINT32_MAX) {
+        fprintf(stderr, "usage: %s [actors>=2] [laps>0] [tokens>0]\n", argv[0]);
+        return 1;
+    }
+    g_hops_per_token = (uint32_t)per_token;
+
+    jzx_config cfg;
+    jzx_config_init(&cfg);
+    cfg.max_actors = actors;
+    cfg.max_actors_per_tick = actors;
+    // Tokens start evenly spaced but can bunch up when a hop lands on an actor
+    // still queued in the same tick, so size mailboxes for the worst case
+    // while keeping large rings bounded.
+    uint32_t cap = tokens;
+    if ((uint64_t)cap * actors > (16u << 20)) {
+        cap = (16u << 20) / actors;
+    }
+    cfg.default_mailbox_cap = cap < 64 ? 64 : cap;
+    jzx_loop* loop = jzx_loop_create(&cfg);
+    if (!loop) {
+        fprintf(stderr, "jzx_loop_create failed\n");
+        return 1;
+    }
+    ring_node* nodes = (ring_node*)calloc(actors, sizeof(ring_node));
+    jzx_actor_id* ids = (jzx_actor_id*)calloc(actors, sizeof(jzx_actor_id));
+    for (uint32_t i = 0; i < actors; ++i) {
+        nodes[i].loop = loop;
+        jzx_spawn_opts opts = {.behavior = ring_behavior, .state = &nodes[i]};
+        if (jzx_spawn(loop, &opts, &ids[i]) != JZX_OK) {
+            fprintf(stderr, "spawn failed at %u\n", i);
+            return 1;
+        }
+    }
+    for (uint32_t i = 0; i < actors; ++i) {
+        nodes[i].next = ids[(i + 1) % actors];
+    }
+    uint64_t total = per_token * tokens;
+    // Spread the tokens evenly around the ring.
+    for (uint32_t t = 0; t < tokens; ++t) {
+        jzx_send(loop, ids[(uint64_t)t * actors / tokens], NULL, 0, 0);
+    }
+
+    double start = now_s();
+    while (g_hops < total) {
+        jzx_loop_run_once(loop, 0);
+    }
+    double elapsed = now_s() - start;
+    printf("actors=%u tokens=%u hops=%llu elapsed=%.3fs rate=%.2f M msgs/s\n", actors, tokens,
+           (unsigned long long)g_hops, elapsed, elapsed > 0 ? (double)g_hops / elapsed / 1e6 : 0.0);
+    jzx_loop_destroy(loop);
+    free(ids);
+    free(nodes);
+    return 0;
+}
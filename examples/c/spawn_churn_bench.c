@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "jzx/jzx.h"
+
+// Spawn/exit churn on one loop: each round spawns a batch of actors, sends
+// each one message and lets them stop, so every spawn after the first round
+// reuses a pooled actor struct and mailbox buffer.
+//
+//   spawn_churn_bench [total] [batch] [mailbox_cap]
+
+static uint64_t g_handled;
+
+static jzx_behavior_result once_behavior(jzx_context* ctx, const jzx_message* msg) {
+    (void)ctx;
+    (void)msg;
+    g_handled++;
+    return JZX_BEHAVIOR_STOP;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    uint64_t total = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000ull;
+    uint32_t batch = argc > 2 ? (uint32_t)atoi(argv[2]) : 256;
+    uint32_t mailbox_cap = argc > 3 ? (uint32_t)atoi(argv[3]) : 16;
+    if (batch == 0) {
+        batch = 1;
+    }
+
+    jzx_config cfg;
+    jzx_config_init(&cfg);
+    cfg.max_actors = batch;
+    cfg.max_actors_per_tick = batch;
+    cfg.pool_max = batch;
+    jzx_loop* loop = jzx_loop_create(&cfg);
+    if (!loop) {
+        fprintf(stderr, "jzx_loop_create failed\n");
+        return 1;
+    }
+    jzx_spawn_opts opts = {.behavior = once_behavior, .mailbox_cap = mailbox_cap};
+
+    double start = now_s();
+    uint64_t spawned = 0;
+    while (spawned < total) {
+        for (uint32_t i = 0; i < batch && spawned < total; ++i, ++spawned) {
+            jzx_actor_id id = 0;
+            if (jzx_spawn(loop, &opts, &id) != JZX_OK || jzx_send(loop, id, NULL, 0, 1) != JZX_OK) {
+                fprintf(stderr, "spawn/send failed at %llu\n", (unsigned long long)spawned);
+                return 1;
+            }
+        }
+        jzx_loop_run_once(loop, 0);
+    }
+    double elapsed = now_s() - start;
+
+    jzx_loop_stats stats;
+    jzx_loop_get_stats(loop, &stats);
+    printf("actors=%llu handled=%llu elapsed=%.3fs rate=%.2f M spawn+exit/s pool_hits=%llu pool_misses=%llu\n",
+           (unsigned long long)spawned, (unsigned long long)g_handled, elapsed,
+           elapsed > 0 ? (double)spawned / elapsed / 1e6 : 0.0,
+           (unsigned long long)stats.pool_hits, (unsigned long long)stats.pool_misses);
+    jzx_loop_destroy(loop);
+    return g_handled == spawned ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#ifndef JZX_FILE_H
+#define JZX_FILE_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Memory-mapped file reader ---------------------------------------------
+//
+// A reader actor maps a file range one window at a time and sends each window
+// to an owner as a zero-copy chunk view. At most `credits` chunks are in
+// flight; releasing a chunk unmaps it and lets the reader map the next one.
+// The reader and chunk release are loop-thread only. However the reader stops
+// (EOF, cancel, jzx_actor_stop, a supervisor, jzx_loop_destroy) it closes its
+// fd, but only EOF and cancel tell the owner. Its bookkeeping goes with the
+// last chunk released: release every chunk before jzx_loop_destroy, or those
+// mappings stay in place.
+
+#define JZX_TAG_FILE_CHUNK 0xffff0201u
+// Last message of a read: len is 0, error is 0 at end of range, ECANCELED
+// after jzx_file_read_cancel, or the errno of a failed mmap.
+#define JZX_TAG_FILE_EOF   0xffff0202u
+
+// Payload of both tags; hand it back with jzx_file_chunk_release.
+typedef struct {
+    jzx_actor_id reader;
+    const uint8_t* bytes;
+    size_t len;
+    uint64_t offset; // file offset of bytes[0]
+    int error;
+} jzx_file_chunk;
+
+typedef struct {
+    // Only needed until jzx_file_read returns; the reader keeps its own dup.
+    int fd;
+    uint64_t offset;
+    uint64_t length; // 0 = to end of file
+    jzx_actor_id owner;
+    // Window size (0 = 4 MiB), rounded up to the page size.
+    uint32_t chunk_size;
+    // Chunks in flight before the reader waits for releases (0 = 4).
+    uint32_t credits;
+} jzx_file_read_opts;
+
+jzx_err jzx_file_read(jzx_loop* loop, const jzx_file_read_opts* opts, jzx_actor_id* out_reader);
+
+// Unmaps the chunk and returns its credit to the reader. Valid after the
+// reader has stopped as well.
+void jzx_file_chunk_release(jzx_loop* loop, jzx_file_chunk* chunk);
+
+// The owner then receives JZX_TAG_FILE_EOF with error ECANCELED. Chunks already
+// sent stay valid until released.
+jzx_err jzx_file_read_cancel(jzx_loop* loop, jzx_actor_id reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_FILE_H
@@ -22,10 +22,15 @@ typedef enum {
     JZX_ERR_IO_REG_FAILED = -9,
     JZX_ERR_IO_NOT_WATCHED = -10,
     JZX_ERR_MAX_ACTORS = -11,
+    JZX_ERR_OVERLOADED = -12,
+    JZX_ERR_OFFLOAD_INVALID = -13,
+    JZX_ERR_MEMORY_LIMIT = -14,
 } jzx_err;
 
 // --- Core types ------------------------------------------------------------
 
+// The top 8 bits of an actor id name its node (see jzx/node.h); ids from
+// jzx_spawn have them clear.
 typedef uint64_t jzx_actor_id;
 typedef uint64_t jzx_timer_id;
 
@@ -37,6 +42,42 @@ typedef struct {
     void* ctx;
 } jzx_allocator;
 
+struct jzx_message;
+
+// What happens when an actor's accounted memory goes over its limit.
+typedef enum {
+    JZX_MEM_ACTION_DEFAULT = 0, // spawn opts only: use the loop's action
+    JZX_MEM_NOTIFY,             // the actor receives JZX_TAG_SYS_MEM_LIMIT once per crossing
+    JZX_MEM_REJECT,             // sends to it fail with JZX_ERR_MEMORY_LIMIT until it shrinks
+    JZX_MEM_FAIL,               // the actor fails, so a supervisor can restart it
+} jzx_mem_action;
+
+// Invoked when the runtime discards a message whose payload the receiver will
+// never see: a conflated message replaced by a newer one with the same key, an
+// async message whose target is gone, or mail left in a stopped actor's
+// mailbox. Check msg->tag before interpreting the payload.
+typedef void (*jzx_release_fn)(void* ctx, const struct jzx_message* msg);
+
+// Watchdog flags.
+#define JZX_WATCHDOG_STACK 1u // sample the loop thread's stack while a call overruns
+#define JZX_WATCHDOG_FAIL 2u  // fail the actor once its overrunning call returns
+#define JZX_WATCHDOG_STACK_MAX 32
+
+// A behavior call that ran for at least watchdog_threshold_us.
+typedef struct {
+    jzx_actor_id actor;
+    uint32_t tag;
+    uint32_t stack_depth; // 0 when no sample was taken
+    uint64_t duration_ns;
+    // Return addresses captured inside the call, innermost first. The first
+    // frames belong to the sampling signal handler. Feed them to
+    // backtrace_symbols_fd or addr2line.
+    void* stack[JZX_WATCHDOG_STACK_MAX];
+} jzx_watchdog_report;
+
+// Runs on the loop thread right after the offending call returns.
+typedef void (*jzx_watchdog_fn)(void* ctx, const jzx_watchdog_report* report);
+
 typedef struct {
     jzx_allocator allocator;
     uint32_t max_actors;
@@ -45,19 +86,80 @@ typedef struct {
     uint32_t max_actors_per_tick;
     uint32_t max_io_watchers;
     uint32_t io_poll_timeout_ms;
+    jzx_release_fn release;
+    void* release_ctx;
+    // Admission limit for the cross-thread async queue (0 = unbounded). Once
+    // this many messages are pending, jzx_send_async* return JZX_ERR_OVERLOADED
+    // and jzx_send_async_wait blocks until the loop drains the queue.
+    uint32_t async_high_water;
+    // Loop-wide restart token bucket shared by all supervisors (0 = disabled).
+    // Restarts beyond the rate are deferred rather than dropped.
+    uint32_t restart_rate_per_sec;
+    uint32_t restart_burst;
+    // Worker threads for jzx_offload (0 = no pool) and the bound on jobs
+    // waiting for a worker (0 = 256 when the pool is enabled).
+    uint32_t offload_threads;
+    uint32_t offload_queue_cap;
+    // Memory accounting: every runtime allocation carries a 16-byte header
+    // with its size and the actor it is charged to. Implied by a non-zero
+    // actor_mem_limit.
+    uint8_t mem_accounting;
+    // Default per-actor limit in bytes (0 = none) and the action on crossing it
+    // (JZX_MEM_ACTION_DEFAULT = notify).
+    uint64_t actor_mem_limit;
+    jzx_mem_action mem_limit_action;
+    // Freed mailbox buffers are kept for reuse by later spawns, up to
+    // pool_max per size class (0 = 256). The async send queue keeps as many
+    // spare message blocks.
+    uint32_t pool_max;
+    // Simulation mode: the loop clock starts at JZX_VIRTUAL_EPOCH_NS and only
+    // moves when nothing is runnable, jumping straight to the next timer
+    // deadline, or on jzx_loop_advance_ns. Runs are reproducible as long as
+    // all input comes from the loop thread.
+    uint8_t virtual_time;
+    // Non-zero: seeds the loop's RNG (restart jitter) and runs the actors
+    // ready in each tick in a seeded shuffled order instead of FIFO.
+    uint64_t sched_seed;
+    // Watchdog (0 = off): behavior calls lasting at least this many
+    // microseconds of real time are counted and reported to watchdog_fn.
+    uint32_t watchdog_threshold_us;
+    uint32_t watchdog_flags; // JZX_WATCHDOG_*
+    // JZX_WATCHDOG_STACK: a monitor thread sends this signal (0 = SIGPROF) to
+    // the loop thread while a call is still running past the threshold. The
+    // runtime installs the handler, and jzx_loop_create fails if the signal
+    // already has one (a profiler's, say); the previous disposition returns
+    // when the last loop sampling with it is destroyed. The signal must not be
+    // blocked on the loop thread. Needs backtrace() (glibc, macOS).
+    int watchdog_signal;
+    jzx_watchdog_fn watchdog_fn;
+    void* watchdog_ctx;
+    // Per-actor and per-tag hardware counters (see jzx/perf.h), read around
+    // one in every perf_sample_every behavior calls (0 = every call).
+    uint8_t perf_counters;
+    uint32_t perf_sample_every;
 } jzx_config;
 
+#define JZX_VIRTUAL_EPOCH_NS 1000000000ull
+
 void jzx_config_init(jzx_config* cfg);
 
 // --- Messaging -------------------------------------------------------------
 
-typedef struct {
+typedef struct jzx_message {
     void* data;
     size_t len;
     uint32_t tag;
     jzx_actor_id sender;
 } jzx_message;
 
+// FIFO mailboxes queue every message. Conflating mailboxes keep at most one
+// pending message per key: a keyed send replaces the pending payload in place
+// and hands the old one to the loop's release callback.
+typedef enum {
+    JZX_MAILBOX_FIFO = 0,
+    JZX_MAILBOX_CONFLATING = 1,
+} jzx_mailbox_mode;
+
 #define JZX_TAG_SYS_IO 0xFFFF0001u
 
 // --- Behavior --------------------------------------------------------------
@@ -72,6 +174,8 @@ typedef enum {
     JZX_BEHAVIOR_OK = 0,
     JZX_BEHAVIOR_STOP = 1,
     JZX_BEHAVIOR_FAIL = 2,
+    // Like OK, then hibernate the actor once its mailbox is empty.
+    JZX_BEHAVIOR_HIBERNATE = 3,
 } jzx_behavior_result;
 
 // Actor status codes for lifecycle/supervision messages.
@@ -96,6 +200,9 @@ typedef enum {
     JZX_SUP_ONE_FOR_ONE,
     JZX_SUP_ONE_FOR_ALL,
     JZX_SUP_REST_FOR_ONE,
+    // Dynamic supervisor: children[0] is a template and no child starts at
+    // spawn; use jzx_supervisor_start_child / jzx_supervisor_terminate_child.
+    JZX_SUP_SIMPLE_ONE_FOR_ONE,
 } jzx_supervisor_strategy;
 
 typedef enum {
@@ -104,13 +211,43 @@ typedef enum {
     JZX_BACKOFF_EXPONENTIAL,
 } jzx_backoff_type;
 
+// Randomization applied on top of the backoff delay so that supervisors hit
+// by a shared failure do not retry in lockstep.
+typedef enum {
+    JZX_JITTER_NONE,
+    JZX_JITTER_FULL,         // uniform in [0, min(delay, backoff_max_ms)]
+    JZX_JITTER_DECORRELATED, // uniform in [base, min(backoff_max_ms, 3 * previous delay)]
+} jzx_jitter_type;
+
 // --- Spawning --------------------------------------------------------------
 
+// Hibernation hook: receives the actor state and returns the state to keep.
+typedef void* (*jzx_state_fn)(jzx_loop* loop, void* state);
+// Stop hook: receives the actor state once the actor is gone.
+typedef void (*jzx_stop_fn)(jzx_loop* loop, void* state);
+
 typedef struct {
     jzx_behavior_fn behavior;
     void* state;
+    // Receives JZX_TAG_SYS_CHILD_EXIT when the actor stops; must be local.
     jzx_actor_id supervisor;
     uint32_t mailbox_cap;
+    jzx_mailbox_mode mailbox_mode;
+    // A hibernated actor keeps its id but releases its mailbox buffers; the
+    // next message to it reallocates them before it is queued. Actors
+    // hibernate on JZX_BEHAVIOR_HIBERNATE, jzx_actor_hibernate, or after
+    // hibernate_after_ms without a message (0 = never).
+    uint32_t hibernate_after_ms;
+    // Optional: on_hibernate may compact the state, on_wake restores it.
+    jzx_state_fn on_hibernate;
+    jzx_state_fn on_wake;
+    // Optional: runs once however the actor stops (its behavior, jzx_actor_stop,
+    // a supervisor, or jzx_loop_destroy), after its mailbox is emptied. For
+    // state that owns fds or other resources. Must not send.
+    jzx_stop_fn on_stop;
+    // Overrides the loop's actor_mem_limit / mem_limit_action when non-zero.
+    uint64_t mem_limit;
+    jzx_mem_action mem_limit_action;
 } jzx_spawn_opts;
 
 jzx_err jzx_spawn(jzx_loop* loop, const jzx_spawn_opts* opts, jzx_actor_id* out_id);
@@ -130,6 +267,8 @@ typedef struct {
     uint32_t period_ms;
     jzx_backoff_type backoff;
     uint32_t backoff_delay_ms;
+    jzx_jitter_type jitter;
+    uint32_t backoff_max_ms; // 0 = uncapped
 } jzx_supervisor_spec;
 
 typedef struct {
@@ -148,6 +287,22 @@ jzx_err jzx_supervisor_child_id(jzx_loop* loop,
                                 size_t index,
                                 jzx_actor_id* out_id);
 
+// simple_one_for_one only. Starts a child from the template; a non-NULL state
+// overrides the template state for this child.
+jzx_err jzx_supervisor_start_child(jzx_loop* loop,
+                                   jzx_actor_id supervisor,
+                                   void* state,
+                                   jzx_actor_id* out_id);
+
+// simple_one_for_one only. Stops the child without restarting it.
+jzx_err jzx_supervisor_terminate_child(jzx_loop* loop,
+                                       jzx_actor_id supervisor,
+                                       jzx_actor_id child);
+
+jzx_err jzx_supervisor_count_children(jzx_loop* loop,
+                                      jzx_actor_id supervisor,
+                                      size_t* out_count);
+
 // --- Loop management -------------------------------------------------------
 
 jzx_loop* jzx_loop_create(const jzx_config* cfg);
@@ -155,6 +310,104 @@ void jzx_loop_destroy(jzx_loop* loop);
 int jzx_loop_run(jzx_loop* loop);
 void jzx_loop_request_stop(jzx_loop* loop);
 
+// Embedding: drive the loop from a host event loop instead of jzx_loop_run.
+// Runs one bounded tick. If nothing is runnable it first waits up to
+// timeout_ms for async sends, timers or IO. Returns 1 while actors or pending
+// work remain, 0 once the loop has drained, 2 if jzx_loop_request_stop was
+// called (the request is consumed, as when jzx_loop_run returns), or a
+// negative jzx_err.
+int jzx_loop_run_once(jzx_loop* loop, uint32_t timeout_ms);
+
+// Milliseconds until the loop next needs a tick: 0 if work is pending, -1 if
+// nothing is scheduled (wait on the backend fd alone), else the time to the
+// earliest timer.
+int64_t jzx_loop_next_deadline(jzx_loop* loop);
+
+// A pollable fd that becomes readable when the loop has work: async sends,
+// fired timers, stop requests and (on Linux) readiness of watched fds. Owned
+// by the loop; do not read from or close it.
+int jzx_loop_backend_fd(jzx_loop* loop);
+
+// Monotonic milliseconds on the loop's clock. Message deadlines use this clock.
+uint64_t jzx_loop_now_ms(jzx_loop* loop);
+// The same clock (CLOCK_MONOTONIC) in nanoseconds. Timers use this clock.
+// Both report virtual time when cfg.virtual_time is set.
+uint64_t jzx_loop_now_ns(jzx_loop* loop);
+
+// Virtual time only: moves the clock forward by ns. Timers that come due fire
+// on the next tick. Returns JZX_ERR_INVALID_ARG on a real-time loop.
+jzx_err jzx_loop_advance_ns(jzx_loop* loop, uint64_t ns);
+
+typedef struct {
+    uint64_t messages_conflated;
+    uint64_t messages_expired;
+    uint64_t restarts;
+    uint64_t restarts_deferred;
+    uint64_t io_events;
+    uint64_t io_events_coalesced;
+    uint64_t hibernations;
+    uint64_t wakeups;
+    uint32_t actors_hibernated; // currently hibernated
+    // Memory accounting only.
+    uint64_t mem_bytes;
+    uint64_t mem_peak_bytes;
+    uint64_t mem_limit_hits;
+    // Mailbox buffer requests served from / missing the pools.
+    uint64_t pool_hits;
+    uint64_t pool_misses;
+    // Timer batches (one per closed slack window) and timers fired.
+    uint64_t timer_wakeups;
+    uint64_t timers_fired;
+    // Behavior calls over watchdog_threshold_us, and how many of those came
+    // with a stack sample.
+    uint64_t watchdog_overruns;
+    uint64_t watchdog_samples;
+    uint64_t ticks;
+} jzx_loop_stats;
+
+// Loop-thread only: counters accumulated since jzx_loop_create.
+jzx_err jzx_loop_get_stats(jzx_loop* loop, jzx_loop_stats* out);
+
+// Load indicators published by the loop. Safe to read from any thread without
+// taking a lock; values are snapshots and may be slightly stale.
+typedef struct {
+    uint32_t async_depth;
+    uint32_t run_queue_len;
+    uint32_t last_tick_us;
+    uint32_t avg_tick_us;
+} jzx_loop_load;
+
+jzx_err jzx_loop_get_load(jzx_loop* loop, jzx_loop_load* out);
+
+// --- Memory accounting -----------------------------------------------------
+//
+// With cfg.mem_accounting, bytes allocated through the loop allocator are
+// charged to an actor: its mailbox buffers, runtime events addressed to it
+// (IO, signal, child exit) and whatever it allocates with jzx_ctx_alloc or
+// jzx_loop_alloc from inside its behavior. Everything else counts toward the
+// loop total only. Blocks freed off the loop thread credit the loop only.
+
+#define JZX_TAG_SYS_MEM_LIMIT 0xffff0005u
+
+// Released by the receiver with jzx_loop_free.
+typedef struct {
+    jzx_actor_id actor;
+    uint64_t bytes;
+    uint64_t limit;
+} jzx_mem_limit_event;
+
+typedef struct {
+    jzx_actor_id id;
+    uint64_t bytes;
+    uint64_t peak_bytes;
+    uint64_t limit;
+} jzx_actor_mem;
+
+// Loop thread.
+jzx_err jzx_actor_get_mem(jzx_loop* loop, jzx_actor_id id, jzx_actor_mem* out);
+// Fills out with up to cap actors, largest first, and returns how many.
+size_t jzx_loop_mem_top(jzx_loop* loop, jzx_actor_mem* out, size_t cap);
+
 // --- Messaging API ---------------------------------------------------------
 
 jzx_err jzx_send(jzx_loop* loop,
@@ -169,9 +422,78 @@ jzx_err jzx_send_async(jzx_loop* loop,
                        size_t len,
                        uint32_t tag);
 
+// Like jzx_send_async, but when the async queue is at async_high_water, waits
+// up to timeout_ms for the loop to drain it before returning JZX_ERR_OVERLOADED.
+jzx_err jzx_send_async_wait(jzx_loop* loop,
+                            jzx_actor_id target,
+                            void* data,
+                            size_t len,
+                            uint32_t tag,
+                            uint32_t timeout_ms);
+
+// Deadline sends: if the message is still queued when the loop dequeues it
+// after deadline_ms (see jzx_loop_now_ms), it is handed to the release callback
+// and counted in messages_expired instead of being dispatched.
+jzx_err jzx_send_deadline(jzx_loop* loop,
+                          jzx_actor_id target,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          uint64_t deadline_ms);
+
+jzx_err jzx_send_async_deadline(jzx_loop* loop,
+                                jzx_actor_id target,
+                                void* data,
+                                size_t len,
+                                uint32_t tag,
+                                uint64_t deadline_ms);
+
+// Keyed send for conflating mailboxes. If a message with the same key is still
+// pending it is replaced in place; otherwise the message is queued. On FIFO
+// mailboxes the key is ignored and this behaves like jzx_send. Ids on other
+// nodes (jzx/node.h) fail with JZX_ERR_INVALID_ARG.
+jzx_err jzx_send_keyed(jzx_loop* loop,
+                       jzx_actor_id target,
+                       uint64_t key,
+                       void* data,
+                       size_t len,
+                       uint32_t tag);
+
 jzx_err jzx_actor_stop(jzx_loop* loop, jzx_actor_id id);
 jzx_err jzx_actor_fail(jzx_loop* loop, jzx_actor_id id);
 
+// Loop thread. Hibernates the actor now if it is idle, otherwise as soon as
+// its mailbox drains.
+jzx_err jzx_actor_hibernate(jzx_loop* loop, jzx_actor_id id);
+
+// Loop-thread only: number of messages waiting in the actor's mailbox.
+jzx_err jzx_actor_mailbox_depth(jzx_loop* loop, jzx_actor_id id, uint32_t* out_depth);
+
+// Loop-thread only, one-shot: once target's mailbox holds at most depth
+// messages, watcher is sent `tag` with no payload. Checked now and after each
+// batch target processes; a depth at or above the mailbox capacity means half
+// drained. Also fires when target stops, so the watcher's next send to it
+// fails. Lets a producer that hit JZX_ERR_MAILBOX_FULL, or saw a backlog,
+// wait for the consumer instead of polling. Registering the same target,
+// watcher and tag again replaces the depth.
+jzx_err jzx_watch_mailbox(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint32_t depth,
+                          jzx_actor_id watcher,
+                          uint32_t tag);
+
+// Allocate/free through the loop's configured allocator. Runtime-allocated
+// payloads (jzx_io_event, jzx_signal_event, jzx_child_exit, ...) must be
+// released with jzx_loop_free, never the allocator's free directly: under
+// mem_accounting they do not start where the allocator's block does.
+void* jzx_loop_alloc(jzx_loop* loop, size_t size);
+void jzx_loop_free(jzx_loop* loop, void* ptr);
+// Like jzx_loop_alloc, charged to ctx->self under memory accounting.
+void* jzx_ctx_alloc(jzx_context* ctx, size_t size);
+// Loop time (as jzx_loop_now_ns) sampled at the start of the current tick.
+// Costs no clock read, so behaviors can call it per message.
+uint64_t jzx_ctx_now_ns(const jzx_context* ctx);
+
 // --- Timers & IO -----------------------------------------------------------
 
 jzx_err jzx_send_after(jzx_loop* loop,
@@ -182,11 +504,57 @@ jzx_err jzx_send_after(jzx_loop* loop,
                        uint32_t tag,
                        jzx_timer_id* out_timer);
 
+// Like jzx_send_after, but the timer may fire up to slack_ms late so it can
+// share a wakeup with other timers due around the same time.
+jzx_err jzx_send_after_slack(jzx_loop* loop,
+                             jzx_actor_id target,
+                             uint32_t ms,
+                             uint32_t slack_ms,
+                             void* data,
+                             size_t len,
+                             uint32_t tag,
+                             jzx_timer_id* out_timer);
+
+// Sends `tag` to target every period_ms (each fire may be up to slack_ms late)
+// until cancelled with jzx_cancel_timer. Re-arming does not allocate. `data` is
+// delivered by reference on every fire and never passed to cfg.release; it
+// must stay valid until the timer is cancelled. The interval cancels itself
+// once a fire finds the target gone. Missed periods are skipped, not queued.
+jzx_err jzx_send_interval(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint32_t period_ms,
+                          uint32_t slack_ms,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          jzx_timer_id* out_timer);
+
+// Nanosecond forms of jzx_send_after_slack and jzx_send_interval. Timers run on
+// CLOCK_MONOTONIC and, on Linux, wake the loop through a timerfd in its wait,
+// so sub-millisecond delays are honoured up to scheduling latency.
+jzx_err jzx_send_after_ns(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint64_t delay_ns,
+                          uint64_t slack_ns,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          jzx_timer_id* out_timer);
+jzx_err jzx_send_interval_ns(jzx_loop* loop,
+                             jzx_actor_id target,
+                             uint64_t period_ns,
+                             uint64_t slack_ns,
+                             void* data,
+                             size_t len,
+                             uint32_t tag,
+                             jzx_timer_id* out_timer);
+
 jzx_err jzx_cancel_timer(jzx_loop* loop, jzx_timer_id timer);
 
 jzx_err jzx_watch_fd(jzx_loop* loop, int fd, jzx_actor_id owner, uint32_t interest);
 jzx_err jzx_unwatch_fd(jzx_loop* loop, int fd);
 
+// Released by the receiver with jzx_loop_free.
 typedef struct {
     int fd;
     uint32_t readiness;
@@ -195,9 +563,53 @@ typedef struct {
 #define JZX_IO_READ  (1u << 0)
 #define JZX_IO_WRITE (1u << 1)
 
+// Watch modes, OR-ed into the interest passed to jzx_watch_fd.
+// ONESHOT: the watch disarms after delivering one event until jzx_rearm_fd;
+//   readiness still present then is reported again. The loop polls with
+//   poll(), so this is also the way to get edge-style delivery: drain the fd
+//   until EAGAIN, then rearm.
+// COALESCE: at most one event per watch is outstanding; readiness seen before
+//   the owner dequeues it is OR-ed into that event instead of sending another.
+#define JZX_IO_ONESHOT  (1u << 8)
+#define JZX_IO_COALESCE (1u << 10)
+
+jzx_err jzx_rearm_fd(jzx_loop* loop, int fd);
+
+// --- Signals ---------------------------------------------------------------
+//
+// Delivers signo to owner as a JZX_TAG_SYS_SIGNAL message. On Linux the signal
+// is blocked in the calling thread and read from a signalfd in the loop's poll
+// set; elsewhere a minimal handler flags it and wakes the loop. Call from the
+// loop thread before starting threads of your own (or block the signal there
+// too); the runtime's threads block all signals. While an event is waiting in
+// the owner's mailbox, further arrivals bump its count instead of queueing.
+
+#define JZX_TAG_SYS_SIGNAL 0xffff0004u
+// Watchable signals are 1..JZX_SIGNAL_MAX - 1. Elsewhere than Linux pending
+// arrivals live in one 64-bit mask, so the bound is one lower.
+#ifdef __linux__
+#define JZX_SIGNAL_MAX 65
+#else
+#define JZX_SIGNAL_MAX 64
+#endif
+
+// Released by the receiver with jzx_loop_free.
+typedef struct {
+    int signo;
+    uint32_t count;
+    // Sender of the latest arrival (Linux only; 0 elsewhere).
+    int32_t pid;
+} jzx_signal_event;
+
+// Loop thread. Re-watching a signal moves it to the new owner.
+jzx_err jzx_watch_signal(jzx_loop* loop, int signo, jzx_actor_id owner);
+// Restores the signal's previous disposition and mask.
+jzx_err jzx_unwatch_signal(jzx_loop* loop, int signo);
+
 #define JZX_TAG_SYS_CHILD_EXIT 0xffff0002u
 #define JZX_TAG_SYS_CHILD_RESTART 0xffff0003u
 
+// Released by the receiver with jzx_loop_free.
 typedef struct {
     jzx_actor_id child;
     jzx_actor_status status;
@@ -205,8 +617,49 @@ typedef struct {
 
 typedef struct {
     uint32_t child_index;
+    uint32_t generation;
 } jzx_child_restart;
 
+// --- Offload pool ----------------------------------------------------------
+
+typedef uint64_t jzx_offload_id;
+
+// Runs on a pool worker, never on the loop thread. The returned pointer is
+// delivered to reply_to as the data of a message carrying the submit tag
+// (len 0, sender 0).
+typedef void* (*jzx_offload_fn)(void* arg);
+
+// Any thread. Fails with JZX_ERR_OVERLOADED when offload_queue_cap jobs are
+// already waiting and JZX_ERR_INVALID_ARG when the loop has no pool.
+jzx_err jzx_offload(jzx_loop* loop,
+                    jzx_offload_fn fn,
+                    void* arg,
+                    jzx_actor_id reply_to,
+                    uint32_t tag,
+                    jzx_offload_id* out_id);
+
+// Removes a job that has not started yet; no completion is delivered and arg
+// stays owned by the caller. Returns JZX_ERR_OFFLOAD_INVALID if the job is
+// already running or finished.
+jzx_err jzx_offload_cancel(jzx_loop* loop, jzx_offload_id id);
+
+typedef struct {
+    uint32_t threads;
+    uint32_t queue_cap;
+    uint32_t queued;
+    uint32_t running;
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t cancelled;
+    uint64_t rejected;
+    // Cumulative time jobs spent waiting for a worker and executing.
+    uint64_t wait_us_total;
+    uint64_t run_us_total;
+} jzx_offload_stats;
+
+// Any thread.
+jzx_err jzx_offload_get_stats(jzx_loop* loop, jzx_offload_stats* out);
+
 #ifdef __cplusplus
 }
 #endif
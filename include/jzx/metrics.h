@@ -0,0 +1,43 @@
+#ifndef JZX_METRICS_H
+#define JZX_METRICS_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- OpenMetrics exporter --------------------------------------------------
+//
+// An exporter actor listens on a unix socket or a loopback TCP port, watched
+// through the loop's own I/O watchers, and answers `GET /metrics` with the
+// loop's counters in OpenMetrics text: tick stats, queue depths, actors by
+// state, restarts, timers and I/O watchers. Responses are rendered into
+// per-connection buffers that are kept between scrapes, so a steady scrape
+// rate allocates nothing. Connections are closed after each response.
+// Everything here is loop-thread only.
+
+typedef struct {
+    // Unix socket path (an existing file there is replaced), or NULL to
+    // listen on 127.0.0.1:port.
+    const char* unix_path;
+    uint16_t port;
+} jzx_metrics_opts;
+
+// Fails with JZX_ERR_IO_REG_FAILED if the socket cannot be set up.
+jzx_err jzx_metrics_start(jzx_loop* loop, const jzx_metrics_opts* opts, jzx_actor_id* out_exporter);
+
+// Closes the listener and open scrapes, removes the unix socket and stops
+// the exporter.
+jzx_err jzx_metrics_stop(jzx_loop* loop, jzx_actor_id exporter);
+
+// Renders the exposition into buf without the HTTP framing. *out_len is the
+// full length even when it exceeds cap, in which case the call fails with
+// JZX_ERR_NO_MEMORY and buf holds a truncated prefix.
+jzx_err jzx_metrics_render(jzx_loop* loop, char* buf, size_t cap, size_t* out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_METRICS_H
@@ -0,0 +1,149 @@
+#ifndef JZX_NET_H
+#define JZX_NET_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Buffered stream connections -------------------------------------------
+//
+// A connection actor owns a nonblocking stream fd. It reads into pooled
+// buffers, splits the byte stream into frames and forwards them to an owner
+// actor. Writes are queued and flushed with one writev per mailbox batch.
+// An acceptor actor owns a listening socket and spawns a connection actor per
+// accepted peer. Every actor here runs on the loop thread; the jzx_net_*
+// calls below are loop-thread only as well.
+
+typedef struct jzx_net jzx_net;
+
+typedef enum {
+    JZX_NET_FRAME_RAW = 0,   // each read is delivered as-is
+    JZX_NET_FRAME_LEN32 = 1, // 4-byte big-endian length prefix, added on write
+    JZX_NET_FRAME_LINE = 2,  // '\n'-terminated; the terminator is stripped
+} jzx_net_framing;
+
+// Owner messages. data is always a jzx_net_frame* that the owner hands back
+// with jzx_net_frame_release.
+#define JZX_TAG_NET_OPEN   0xffff0101u
+#define JZX_TAG_NET_DATA   0xffff0102u
+#define JZX_TAG_NET_CLOSED 0xffff0103u
+
+typedef struct {
+    jzx_actor_id conn;
+    uint8_t* bytes;
+    size_t len;
+    // JZX_TAG_NET_CLOSED: 0 on orderly close, otherwise an errno value.
+    int error;
+} jzx_net_frame;
+
+typedef struct {
+    jzx_net_framing framing;
+    // Largest accepted frame for LEN32/LINE (0 = 1 MiB). Longer frames close
+    // the connection with EMSGSIZE.
+    uint32_t max_frame;
+    // Reads pause while the owner's mailbox holds at least pause_depth
+    // messages (0 = never) and resume once it drains to resume_depth
+    // (0 = pause_depth / 2).
+    uint32_t pause_depth;
+    uint32_t resume_depth;
+} jzx_net_conn_opts;
+
+// Called by the acceptor for every new connection; returns the actor that
+// should own it (0 rejects and closes the connection).
+typedef jzx_actor_id (*jzx_net_accept_fn)(void* ctx, jzx_loop* loop, jzx_actor_id conn);
+
+typedef struct {
+    jzx_net_conn_opts conn;
+    jzx_net_accept_fn on_accept;
+    void* accept_ctx;
+} jzx_net_listen_opts;
+
+typedef struct {
+    uint64_t accepted;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t frames_in;
+    uint64_t writev_calls;
+    uint64_t read_pauses;
+    uint32_t pool_free;
+    uint64_t bytes_transferred;
+} jzx_net_stats;
+
+// buffer_size is the pooled read/write block size (0 = 16 KiB); at most
+// pool_max free blocks are retained (0 = 256).
+jzx_net* jzx_net_create(jzx_loop* loop, uint32_t buffer_size, uint32_t pool_max);
+// Call after the loop has stopped running the net actors.
+void jzx_net_destroy(jzx_net* net);
+
+// Takes ownership of a listening socket (made nonblocking here).
+jzx_err jzx_net_listen(jzx_net* net,
+                       int listen_fd,
+                       const jzx_net_listen_opts* opts,
+                       jzx_actor_id* out_acceptor);
+
+// Takes ownership of a connected stream fd and sends JZX_TAG_NET_OPEN to owner.
+jzx_err jzx_net_adopt(jzx_net* net,
+                      int fd,
+                      jzx_actor_id owner,
+                      const jzx_net_conn_opts* opts,
+                      jzx_actor_id* out_conn);
+
+// Queues one frame (copied) on the connection.
+jzx_err jzx_net_write(jzx_net* net, jzx_actor_id conn, const void* data, size_t len);
+
+// Flushes queued writes, then closes. Also stops an acceptor.
+jzx_err jzx_net_close(jzx_net* net, jzx_actor_id actor);
+
+void jzx_net_frame_release(jzx_net* net, jzx_net_frame* frame);
+
+jzx_err jzx_net_get_stats(jzx_net* net, jzx_net_stats* out);
+
+// --- Streaming transfers ---------------------------------------------------
+//
+// Moves bytes from in_fd to out_fd inside the kernel, driven by out_fd's
+// write readiness: sendfile for regular-file sources, splice (through an
+// internal pipe when neither side is one) otherwise. Platforms without these
+// fall back to a pooled-buffer copy. Neither fd may be watched by another
+// actor while the transfer runs, and neither is closed by it. Both (in_fd
+// only when it is not a regular file) are switched to O_NONBLOCK for the
+// duration; their original file status flags are restored when the transfer
+// ends, however it ends.
+
+#define JZX_TAG_NET_XFER_PROGRESS 0xffff0104u
+#define JZX_TAG_NET_XFER_DONE     0xffff0105u
+
+// Payload of the transfer messages; release with jzx_loop_free.
+typedef struct {
+    jzx_actor_id xfer;
+    uint64_t sent;
+    uint64_t total; // 0 when streaming until EOF
+    int error;      // DONE only: 0, ECANCELED or an errno value
+} jzx_net_xfer_event;
+
+typedef struct {
+    int in_fd;
+    int out_fd;
+    // Regular-file sources: start offset and byte count (0 = to end of file).
+    // Other sources ignore offset; length 0 streams until EOF.
+    uint64_t offset;
+    uint64_t length;
+    jzx_actor_id owner;
+    // Bytes moved per syscall (0 = 1 MiB); at most four syscalls run per
+    // readiness event so large transfers do not monopolise the loop.
+    uint32_t chunk;
+    // Send JZX_TAG_NET_XFER_PROGRESS every this many bytes (0 = never).
+    uint64_t progress_every;
+} jzx_net_xfer_opts;
+
+jzx_err jzx_net_transfer(jzx_net* net, const jzx_net_xfer_opts* opts, jzx_actor_id* out_xfer);
+
+// The owner then receives DONE with error ECANCELED.
+jzx_err jzx_net_transfer_cancel(jzx_net* net, jzx_actor_id xfer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_NET_H
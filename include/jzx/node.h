@@ -0,0 +1,120 @@
+#ifndef JZX_NODE_H
+#define JZX_NODE_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Nodes -----------------------------------------------------------------
+//
+// A node is a loop with a number (1..255) that peers with other nodes on the
+// same host over unix stream sockets. The top 8 bits of an actor id name its
+// node; ids from jzx_spawn have them clear and mean "this loop". Once
+// jzx_node_start has run, every call that takes an actor id also accepts it
+// qualified with this loop's own node number, and jzx_send (and every other
+// send, timers included) to an id whose node bits name a connected peer copies
+// the payload into that peer's outgoing batch and hands the message to
+// cfg.release, if set.
+//
+// Timers check the peer when they fire; an interval whose peer is down cancels
+// itself. A deadline from jzx_send_deadline travels with the frame and is
+// checked against the receiving loop's clock, which matches the sender's on one
+// host unless either loop runs on virtual time. jzx_send_keyed to a remote id
+// fails with JZX_ERR_INVALID_ARG: conflation needs the target's mailbox. Actor
+// calls other than sends (jzx_actor_stop, jzx_watch_mailbox, ...) only take
+// local actors.
+//
+// Each peer connection is an actor that writes queued frames with one writev
+// per mailbox batch. Incoming payloads arrive in jzx_loop_alloc blocks that the
+// receiver frees with jzx_loop_free; the sender is the sending actor's
+// node-qualified id, so it can be replied to directly. Frames use native byte order.
+// Everything here is loop-thread only.
+
+#define JZX_NODE_SHIFT 56u
+#define JZX_NODE_MAX 255u
+
+// The id `local` (from jzx_spawn on node `node`) as seen from other nodes.
+static inline jzx_actor_id jzx_node_actor(uint32_t node, jzx_actor_id local) {
+    return ((jzx_actor_id)node << JZX_NODE_SHIFT) | (local & ((1ull << JZX_NODE_SHIFT) - 1u));
+}
+
+static inline uint32_t jzx_actor_node(jzx_actor_id id) {
+    return (uint32_t)(id >> JZX_NODE_SHIFT);
+}
+
+// Sent to the node owner and to NOTIFY monitors. data is a jzx_node_event*
+// released with jzx_loop_free.
+#define JZX_TAG_NODE_UP   0xffff0501u
+#define JZX_TAG_NODE_DOWN 0xffff0502u
+
+typedef struct {
+    uint32_t node;
+    // JZX_TAG_NODE_DOWN: 0 on orderly close, otherwise an errno value.
+    int error;
+} jzx_node_event;
+
+typedef enum {
+    JZX_NODE_NOTIFY = 0, // the monitor receives JZX_TAG_NODE_DOWN
+    JZX_NODE_FAIL = 1,   // the monitor fails, so its supervisor applies its restart policy
+} jzx_node_monitor_mode;
+
+typedef struct {
+    uint32_t node_id; // 1..JZX_NODE_MAX
+    // Unix socket path to accept peers on (an existing file there is
+    // replaced), or NULL to only connect out.
+    const char* unix_path;
+    // Size of each outgoing batch block (0 = 64 KiB).
+    uint32_t batch_bytes;
+    // Unsent bytes a peer may queue before sends to it fail with
+    // JZX_ERR_OVERLOADED (0 = 8 MiB).
+    uint32_t max_queued;
+    // Largest payload accepted from a peer (0 = 1 MiB). Larger frames close
+    // the connection with EMSGSIZE.
+    uint32_t max_frame;
+    // Receives JZX_TAG_NODE_UP and JZX_TAG_NODE_DOWN for every peer (0 = nobody).
+    jzx_actor_id owner;
+} jzx_node_opts;
+
+typedef struct {
+    uint32_t peers;
+    uint64_t frames_out;
+    uint64_t frames_in;
+    uint64_t bytes_out;
+    uint64_t bytes_in;
+    uint64_t writev_calls;
+    uint64_t send_full;    // sends refused with JZX_ERR_OVERLOADED
+    uint64_t dropped;      // incoming frames for missing actors
+    uint64_t unsent_bytes; // still queued when a peer went down
+} jzx_node_stats;
+
+// Fails with JZX_ERR_IO_REG_FAILED if the listening socket cannot be set up.
+jzx_err jzx_node_start(jzx_loop* loop, const jzx_node_opts* opts);
+
+// Connects to the node listening at unix_path. The peer becomes routable
+// once both sides have exchanged node numbers (JZX_TAG_NODE_UP).
+jzx_err jzx_node_connect(jzx_loop* loop, const char* unix_path);
+
+// Takes ownership of an already connected stream socket, e.g. one end of a
+// socketpair, and runs the same handshake.
+jzx_err jzx_node_adopt(jzx_loop* loop, int fd);
+
+// One-shot: the next time `node` (0 = any peer) goes down, `actor` is told or
+// failed according to mode. A node that is not connected goes down at once.
+jzx_err jzx_node_monitor(jzx_loop* loop, uint32_t node, jzx_actor_id actor, jzx_node_monitor_mode mode);
+
+// 1 if a handshaken connection to node exists.
+int jzx_node_connected(jzx_loop* loop, uint32_t node);
+
+jzx_err jzx_node_get_stats(jzx_loop* loop, jzx_node_stats* out);
+
+// Closes every peer (they see JZX_TAG_NODE_DOWN) and the listener and
+// removes the unix socket. Sends to remote ids fail with NO_SUCH_ACTOR again.
+void jzx_node_stop(jzx_loop* loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_NODE_H
@@ -0,0 +1,68 @@
+#ifndef JZX_PERF_H
+#define JZX_PERF_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Hardware performance counters -----------------------------------------
+//
+// With cfg.perf_counters set, the thread that runs the loop's first tick
+// opens one perf_event_open group and reads it around sampled behavior calls,
+// a single read() per snapshot for all counters. The deltas accumulate per
+// actor and per tag. Linux only; counters the kernel or CPU refuse (VMs often
+// lack the hardware ones) are left out of the group and missing from
+// `available`. Everything here is loop-thread only.
+
+#define JZX_PERF_CYCLES 1u
+#define JZX_PERF_INSTRUCTIONS 2u
+#define JZX_PERF_CACHE_MISSES 4u
+#define JZX_PERF_CONTEXT_SWITCHES 8u
+
+// Per-tag counts cover at most this many distinct tags; samples for tags seen
+// after that reach only the actor and total counts.
+#define JZX_PERF_MAX_TAGS 1024u
+
+typedef struct {
+    uint64_t calls; // sampled behavior calls
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t cache_misses;
+    uint64_t context_switches;
+} jzx_perf_counts;
+
+typedef struct {
+    uint32_t tag;
+    jzx_perf_counts counts;
+} jzx_perf_tag_counts;
+
+typedef struct {
+    uint32_t available; // JZX_PERF_* counters in the group
+    uint32_t tags;      // distinct tags counted
+    uint64_t calls;     // all behavior calls, sampled or not
+    uint64_t failed;    // sampled calls dropped because a counter read failed
+    uint64_t untagged;  // sampled calls whose tag did not fit in the tag map
+    jzx_perf_counts total;
+} jzx_perf_stats;
+
+// Fails with JZX_ERR_INVALID_ARG unless cfg.perf_counters is set.
+jzx_err jzx_perf_get_stats(jzx_loop* loop, jzx_perf_stats* out);
+
+// Counts for an actor, zero if it has not had a sampled call. They outlive
+// the actor until its slot is reused.
+jzx_err jzx_perf_get_actor(jzx_loop* loop, jzx_actor_id id, jzx_perf_counts* out);
+
+// Copies up to cap per-tag entries, in no particular order, and sets
+// *out_count to the number copied.
+jzx_err jzx_perf_get_tags(jzx_loop* loop, jzx_perf_tag_counts* out, uint32_t cap, uint32_t* out_count);
+
+// Zeroes every actor, tag and total count.
+jzx_err jzx_perf_reset(jzx_loop* loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_PERF_H
@@ -0,0 +1,105 @@
+#ifndef JZX_RECORD_H
+#define JZX_RECORD_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Traffic recorder ------------------------------------------------------
+//
+// While recording, every message enqueued on the loop (local sends, async
+// sends once dispatched, timers, runtime events) is appended to a binary log.
+// The loop thread only copies records into a buffer; full buffers are written
+// by a background thread. If that thread falls a whole buffer behind, records
+// are dropped and counted rather than stalling the loop.
+//
+// File layout, native endianness: one jzx_record_header, then per message a
+// jzx_record_entry followed by payload_len payload bytes.
+
+#define JZX_RECORD_MAGIC "JZXREC01"
+#define JZX_RECORD_VERSION 1u
+#define JZX_RECORD_FLAG_PAYLOADS 1u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t start_ns; // loop clock when recording started
+} jzx_record_header;
+
+typedef struct {
+    uint64_t time_ns; // loop clock at enqueue
+    // The message's sender, else the actor whose behavior sent it (0 when
+    // sent from outside any behavior).
+    jzx_actor_id sender;
+    jzx_actor_id target;
+    uint32_t tag;
+    uint32_t len;         // message length as sent
+    uint32_t payload_len; // bytes that follow: len with payloads on, else 0
+    uint32_t reserved;
+} jzx_record_entry;
+
+typedef struct {
+    const char* path;
+    // Copy len bytes at data into the log. Only meaningful for messages whose
+    // payload is plain bytes; pointers inside payloads are not followed.
+    uint8_t payloads;
+    // Size of each of the two buffers (0 = 1 MiB). A payload that does not fit
+    // in one buffer is recorded without its bytes.
+    uint32_t buffer_bytes;
+} jzx_record_opts;
+
+typedef struct {
+    uint64_t records;
+    uint64_t dropped;
+    uint64_t bytes; // written to the file, header included
+    int error;      // errno of the first failed write, else 0
+} jzx_record_stats;
+
+// Loop-thread only. Fails with JZX_ERR_INVALID_ARG if already recording and
+// JZX_ERR_IO_REG_FAILED if the file cannot be created.
+jzx_err jzx_record_start(jzx_loop* loop, const jzx_record_opts* opts);
+
+// Loop-thread only. Flushes what is buffered, closes the file and reports
+// totals. jzx_loop_destroy stops a recording that is still running.
+jzx_err jzx_record_stop(jzx_loop* loop, jzx_record_stats* out);
+
+// --- Replay ----------------------------------------------------------------
+//
+// Feeds a log back through a loop. Each recorded target gets a stand-in actor,
+// spawned on first use with the opts returned by `resolve`. Messages arrive
+// with the recorded tag and len. Payload bytes, when recorded, come in a
+// jzx_loop_alloc block the behavior releases with jzx_loop_free; otherwise
+// data is NULL.
+
+// Fills *opts for the stand-in of a recorded target. Returning anything but
+// JZX_OK skips that target's messages.
+typedef jzx_err (*jzx_replay_resolve_fn)(void* ctx, jzx_actor_id recorded, uint32_t first_tag, jzx_spawn_opts* opts);
+
+typedef struct {
+    const char* path;
+    jzx_replay_resolve_fn resolve;
+    void* ctx;
+    // 0: as fast as the loop drains; 1: keep the recorded inter-arrival gaps.
+    uint8_t realtime;
+} jzx_replay_opts;
+
+typedef struct {
+    uint64_t records;
+    uint64_t delivered;
+    uint64_t skipped; // unresolved targets or failed sends
+    uint64_t recorded_ns; // span between the first and last record
+    uint64_t elapsed_ns;  // wall time the replay took
+} jzx_replay_stats;
+
+// Runs the loop until every record has been delivered and processed, then
+// stops the stand-ins. Must not be called while the loop is running.
+jzx_err jzx_replay(jzx_loop* loop, const jzx_replay_opts* opts, jzx_replay_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_RECORD_H
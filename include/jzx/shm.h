@@ -0,0 +1,83 @@
+#ifndef JZX_SHM_H
+#define JZX_SHM_H
+
+#include "jzx/jzx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Shared-memory links ---------------------------------------------------
+//
+// A link joins two loops in different processes on one host through a pair
+// of single-producer rings in a shared memfd, one per direction. A send
+// copies the payload into the ring once. The receiving side's reader actor
+// copies each message into a jzx_loop_alloc block, which the target releases
+// with jzx_loop_free, and delivers it with the recorded tag and sender 0.
+// Wakeups go through one eventfd per direction, written only when the reader
+// has gone idle. The creating side passes the memfd and eventfds to its peer
+// over a connected unix socket (SCM_RIGHTS); the link then owns that socket
+// and watches it to notice the peer going away. Linux only; elsewhere the
+// calls fail with JZX_ERR_UNKNOWN. Everything here is loop-thread only.
+
+typedef struct jzx_shm_link jzx_shm_link;
+
+// Sent to opts.owner when the peer's end of the socket closes; data is NULL.
+#define JZX_TAG_SHM_DOWN 0xffff0401u
+
+typedef struct {
+    // Bytes per direction (0 = 1 MiB), rounded up to a power of two. A single
+    // message may use at most half of it.
+    uint32_t ring_bytes;
+    // Actor the peer sees through jzx_shm_peer_root, e.g. a directory that
+    // hands out other ids. 0 = none.
+    jzx_actor_id root;
+    // Receives JZX_TAG_SHM_DOWN (0 = nobody).
+    jzx_actor_id owner;
+} jzx_shm_opts;
+
+typedef struct {
+    uint64_t sent;
+    uint64_t received;
+    uint64_t send_full;     // sends refused with JZX_ERR_OVERLOADED
+    uint64_t dropped;       // inbound messages for missing actors; proxy messages too large for the ring or unsent at close
+    uint64_t wakeups;       // eventfd writes to the peer
+    uint64_t redeliveries;  // inbound drains paused on a full local mailbox
+    uint64_t proxy_held;    // proxy messages that found the ring full and waited for the peer to drain it
+} jzx_shm_stats;
+
+// Creating side: sets up the shared region and hands it to the peer over
+// sock. ring_bytes only matters here; the accepting side adopts the size.
+jzx_err jzx_shm_connect(jzx_loop* loop, int sock, const jzx_shm_opts* opts, jzx_shm_link** out);
+
+// Accepting side: waits up to timeout_ms for the peer's region on sock.
+jzx_err jzx_shm_accept(jzx_loop* loop, int sock, const jzx_shm_opts* opts, uint32_t timeout_ms, jzx_shm_link** out);
+
+// The peer's opts.root, or 0 until the peer has accepted or if it set none.
+jzx_actor_id jzx_shm_peer_root(jzx_shm_link* link);
+
+// Copies len bytes at data into the outbound ring for the peer's actor
+// `target`. The caller keeps data. JZX_ERR_OVERLOADED when the ring is full,
+// JZX_ERR_INVALID_ARG when the message is larger than half the ring.
+jzx_err jzx_shm_send(jzx_shm_link* link, jzx_actor_id target, const void* data, size_t len, uint32_t tag);
+
+// Spawns a local actor that forwards everything it receives to the peer's
+// `remote` actor, so remote actors can be used with plain jzx_send. The
+// proxy copies len bytes at msg->data and then hands the message to
+// cfg.release, if set, since nobody else will see the payload. While the ring
+// is full the proxy keeps messages, in order, until the peer's reader has
+// made room and wakes it. Proxies stop with the link; messages still kept
+// then are released and counted as dropped.
+jzx_err jzx_shm_proxy(jzx_shm_link* link, jzx_actor_id remote, jzx_actor_id* out_proxy);
+
+jzx_err jzx_shm_get_stats(jzx_shm_link* link, jzx_shm_stats* out);
+
+// Stops the reader and proxies, unmaps the region and closes the fds and the
+// socket. The peer sees JZX_TAG_SHM_DOWN.
+void jzx_shm_close(jzx_shm_link* link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JZX_SHM_H
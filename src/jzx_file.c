@@ -0,0 +1,258 @@
+#include "jzx/file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Internal control tags understood by the reader actor.
+#define JZX_FILE_TAG_PUMP   0xffff0210u
+#define JZX_FILE_TAG_CREDIT 0xffff0211u
+#define JZX_FILE_TAG_CANCEL 0xffff0212u
+
+#define JZX_FILE_DEFAULT_CHUNK (4u << 20)
+#define JZX_FILE_MAX_CHUNK (1u << 30)
+#define JZX_FILE_DEFAULT_CREDITS 4u
+#define JZX_FILE_RETRY_MS 1
+
+// -----------------------------------------------------------------------------
+// Chunks
+// -----------------------------------------------------------------------------
+
+typedef struct jzx_file_reader jzx_file_reader;
+
+// The view is the first member so the owner's jzx_file_chunk* is the block.
+typedef struct {
+    jzx_file_chunk chunk;
+    void* map_base;
+    size_t map_len;
+    jzx_file_reader* source; // set on mapped windows, which hold a credit
+} jzx_file_block;
+
+static jzx_file_block* jzx_file_block_new(jzx_loop* loop, jzx_actor_id reader) {
+    jzx_file_block* block = (jzx_file_block*)jzx_loop_alloc(loop, sizeof(jzx_file_block));
+    if (block) {
+        memset(block, 0, sizeof(*block));
+        block->chunk.reader = reader;
+    }
+    return block;
+}
+
+static void jzx_file_block_free(jzx_loop* loop, jzx_file_block* block) {
+    if (block->map_base) {
+        munmap(block->map_base, block->map_len);
+    }
+    jzx_loop_free(loop, block);
+}
+
+// -----------------------------------------------------------------------------
+// Reader actor
+// -----------------------------------------------------------------------------
+
+// Releases decrement in_flight directly, so a credit cannot be lost to a full
+// reader mailbox; the CREDIT message only wakes a reader that ran out. The
+// struct outlives the actor until every mapped window has been released;
+// however the actor stops, jzx_file_reader_stop closes the fd.
+struct jzx_file_reader {
+    jzx_loop* loop;
+    jzx_actor_id self;
+    jzx_actor_id owner;
+    int fd;
+    uint64_t next;
+    uint64_t end;
+    size_t page;
+    uint32_t chunk_size;
+    uint32_t credits;
+    uint32_t in_flight;
+    uint8_t retry_pending;
+    uint8_t finished;
+};
+
+static jzx_behavior_result jzx_file_reader_finish(jzx_file_reader* r, int error) {
+    jzx_file_block* block = jzx_file_block_new(r->loop, r->self);
+    if (block) {
+        block->chunk.offset = r->next;
+        block->chunk.error = error;
+        if (jzx_send(r->loop, r->owner, block, sizeof(block->chunk), JZX_TAG_FILE_EOF) != JZX_OK) {
+            jzx_file_block_free(r->loop, block);
+        }
+    }
+    return JZX_BEHAVIOR_STOP;
+}
+
+// on_stop: runs for EOF and cancel as well as jzx_actor_stop, a supervisor
+// or jzx_loop_destroy.
+static void jzx_file_reader_stop(jzx_loop* loop, void* state) {
+    jzx_file_reader* r = (jzx_file_reader*)state;
+    close(r->fd);
+    r->finished = 1;
+    if (r->in_flight == 0) {
+        jzx_loop_free(loop, r);
+    }
+}
+
+// Maps and sends windows while credits remain. Returns 0 to keep running,
+// otherwise the value to finish with (-1 for a clean end of range).
+static int jzx_file_reader_pump(jzx_file_reader* r) {
+    while (r->in_flight < r->credits && r->next < r->end) {
+        uint64_t remaining = r->end - r->next;
+        size_t len = remaining < r->chunk_size ? (size_t)remaining : r->chunk_size;
+        uint64_t map_off = r->next & ~((uint64_t)r->page - 1);
+        size_t delta = (size_t)(r->next - map_off);
+        jzx_file_block* block = jzx_file_block_new(r->loop, r->self);
+        if (!block) {
+            return ENOMEM;
+        }
+        void* base = mmap(NULL, delta + len, PROT_READ, MAP_SHARED, r->fd, (off_t)map_off);
+        if (base == MAP_FAILED) {
+            int err = errno;
+            jzx_loop_free(r->loop, block);
+            return err;
+        }
+        // Sequential access drops pages behind the cursor early; WILLNEED
+        // starts readahead for this window before the owner touches it.
+        (void)madvise(base, delta + len, MADV_SEQUENTIAL);
+        (void)madvise(base, delta + len, MADV_WILLNEED);
+        block->map_base = base;
+        block->map_len = delta + len;
+        block->chunk.bytes = (const uint8_t*)base + delta;
+        block->chunk.len = len;
+        block->chunk.offset = r->next;
+        block->source = r;
+        jzx_err err = jzx_send(r->loop, r->owner, block, sizeof(block->chunk), JZX_TAG_FILE_CHUNK);
+        if (err != JZX_OK) {
+            jzx_file_block_free(r->loop, block);
+            if (err != JZX_ERR_MAILBOX_FULL) {
+                return ESRCH;
+            }
+            // Owner is saturated; try again shortly rather than spin.
+            if (!r->retry_pending &&
+                jzx_send_after(r->loop, r->self, JZX_FILE_RETRY_MS, NULL, 0, JZX_FILE_TAG_PUMP, NULL) ==
+                    JZX_OK) {
+                r->retry_pending = 1;
+            }
+            return 0;
+        }
+        r->next += len;
+        r->in_flight++;
+    }
+    return r->next >= r->end ? -1 : 0;
+}
+
+static jzx_behavior_result jzx_file_reader_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_file_reader* r = (jzx_file_reader*)ctx->state;
+    switch (msg->tag) {
+    case JZX_FILE_TAG_PUMP:
+        r->retry_pending = 0;
+        break;
+    case JZX_FILE_TAG_CREDIT:
+        break;
+    case JZX_FILE_TAG_CANCEL:
+        return jzx_file_reader_finish(r, ECANCELED);
+    default:
+        // Any message pumps, so whatever filled the mailbox makes up for a
+        // CREDIT wake-up that did not fit.
+        break;
+    }
+    int rc = jzx_file_reader_pump(r);
+    if (rc != 0) {
+        return jzx_file_reader_finish(r, rc < 0 ? 0 : rc);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+jzx_err jzx_file_read(jzx_loop* loop, const jzx_file_read_opts* opts, jzx_actor_id* out_reader) {
+    if (!loop || !opts || opts->fd < 0 || opts->owner == 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    struct stat st;
+    if (fstat(opts->fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    uint64_t size = (uint64_t)st.st_size;
+    uint64_t end = size;
+    if (opts->offset > size) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (opts->length > 0 && opts->length < size - opts->offset) {
+        end = opts->offset + opts->length;
+    }
+
+    jzx_file_reader* r = (jzx_file_reader*)jzx_loop_alloc(loop, sizeof(jzx_file_reader));
+    if (!r) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(r, 0, sizeof(*r));
+    r->loop = loop;
+    r->owner = opts->owner;
+    r->next = opts->offset;
+    r->end = end;
+    long page = sysconf(_SC_PAGESIZE);
+    r->page = page > 0 ? (size_t)page : 4096;
+    uint64_t chunk = opts->chunk_size ? opts->chunk_size : JZX_FILE_DEFAULT_CHUNK;
+    if (chunk > JZX_FILE_MAX_CHUNK) {
+        chunk = JZX_FILE_MAX_CHUNK;
+    }
+    r->chunk_size = (uint32_t)((chunk + r->page - 1) & ~((uint64_t)r->page - 1));
+    r->credits = opts->credits ? opts->credits : JZX_FILE_DEFAULT_CREDITS;
+    r->fd = fcntl(opts->fd, F_DUPFD_CLOEXEC, 0);
+    if (r->fd < 0) {
+        jzx_loop_free(loop, r);
+        return JZX_ERR_NO_MEMORY;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    (void)posix_fadvise(r->fd, (off_t)r->next, (off_t)(end - r->next), POSIX_FADV_SEQUENTIAL);
+#endif
+
+    jzx_spawn_opts spawn = {
+        .behavior = jzx_file_reader_behavior,
+        .state = r,
+        .on_stop = jzx_file_reader_stop,
+    };
+    jzx_err err = jzx_spawn(loop, &spawn, &r->self);
+    if (err != JZX_OK) {
+        close(r->fd);
+        jzx_loop_free(loop, r);
+        return err;
+    }
+    (void)jzx_send(loop, r->self, NULL, 0, JZX_FILE_TAG_PUMP);
+    if (out_reader) {
+        *out_reader = r->self;
+    }
+    return JZX_OK;
+}
+
+void jzx_file_chunk_release(jzx_loop* loop, jzx_file_chunk* chunk) {
+    if (!loop || !chunk) {
+        return;
+    }
+    jzx_file_block* block = (jzx_file_block*)chunk;
+    jzx_file_reader* r = block->source;
+    jzx_file_block_free(loop, block);
+    if (!r) {
+        return;
+    }
+    int stalled = r->in_flight == r->credits;
+    r->in_flight--;
+    if (r->finished) {
+        if (r->in_flight == 0) {
+            jzx_loop_free(loop, r);
+        }
+    } else if (stalled) {
+        // If this does not fit, the messages already queued pump instead.
+        (void)jzx_send(loop, r->self, NULL, 0, JZX_FILE_TAG_CREDIT);
+    }
+}
+
+jzx_err jzx_file_read_cancel(jzx_loop* loop, jzx_actor_id reader) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_send(loop, reader, NULL, 0, JZX_FILE_TAG_CANCEL);
+}
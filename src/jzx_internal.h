@@ -4,6 +4,7 @@
 #include "jzx/jzx.h"
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -11,13 +12,37 @@ struct pollfd;
 typedef struct jzx_async_msg jzx_async_msg;
 typedef struct jzx_timer_entry jzx_timer_entry;
 typedef struct jzx_io_watch jzx_io_watch;
+typedef struct jzx_drain_watch jzx_drain_watch;
 
+
+// Open-addressing u64 -> u32 map (linear probing, backward-shift deletion).
+typedef struct {
+    uint64_t* keys;
+    uint32_t* values;
+    uint8_t* used;
+    uint32_t capacity;
+    uint32_t count;
+} jzx_index_map;
+
+// Per-slot side tables most mailboxes never need.
+typedef struct {
+    // Conflating mode only: per-slot key, slot-has-key flag, key -> slot index.
+    uint64_t* keys;
+    uint8_t* keyed;
+    jzx_index_map key_index;
+    // Per-slot deadline (0 = none), allocated on the first deadline send.
+    uint64_t* deadlines;
+} jzx_mailbox_ext;
+
+// Ring of messages; the tail is head + count. ext is NULL until a conflating
+// mailbox is created or the first deadline send.
 typedef struct {
     jzx_message* buffer;
+    jzx_mailbox_ext* ext;
     uint32_t capacity;
     uint32_t head;
-    uint32_t tail;
     uint32_t count;
+    uint8_t mode; // jzx_mailbox_mode
 } jzx_mailbox_impl;
 
 typedef struct {
@@ -25,6 +50,9 @@ typedef struct {
     jzx_actor_id id;
     uint32_t restart_count;
     uint64_t last_restart_ms;
+    uint32_t last_delay_ms;
+    uint32_t generation;
+    uint8_t in_use;
 } jzx_child_state;
 
 typedef struct {
@@ -33,21 +61,69 @@ typedef struct {
     size_t child_count;
     uint32_t intensity_window_count;
     uint64_t intensity_window_start_ms;
+    // Live child actor id -> index into children.
+    jzx_index_map child_index;
+    // simple_one_for_one: children is a growable pool of template instances.
+    uint8_t dynamic;
+    jzx_child_spec child_template;
+    size_t child_capacity;
+    uint32_t* free_slots;
+    size_t free_count;
+    size_t active_count;
 } jzx_supervisor_state;
 
+// Intrusive free list of equally sized blocks; the link lives in the block.
+typedef struct {
+    void* head;
+    uint32_t count;
+} jzx_pool;
+
+// Mailbox buffers are pooled by power-of-two capacity up to 1 << (N - 1).
+#define JZX_MAILBOX_POOL_CLASSES 16
+
+// Everything send and dispatch touch, packed into one cache line. Records
+// live in the actor table's hot array; id is 0 while the slot is free.
 typedef struct jzx_actor {
     jzx_actor_id id;
-    jzx_actor_status status;
     jzx_behavior_fn behavior;
     void* state;
-    jzx_actor_id supervisor;
-    jzx_supervisor_state* supervisor_state;
     jzx_mailbox_impl mailbox;
+    uint8_t status; // jzx_actor_status
     uint8_t in_run_queue;
+    // While hibernated the mailbox holds no buffers, only capacity and mode.
+    uint8_t hibernated;
+    uint8_t hibernate_requested;
+    uint8_t auto_hibernate; // hibernate_after_ms != 0
+    // Memory accounting: set while bytes exceed a non-zero limit.
+    uint8_t mem_over;
+    // Some jzx_watch_mailbox registration is waiting on this mailbox.
+    uint8_t drain_watched;
 } jzx_actor;
 
+_Static_assert(sizeof(jzx_actor) <= 64, "jzx_actor must fit one cache line");
+
+// Per-actor data off the send/dispatch path, parallel to the hot array.
 typedef struct {
-    jzx_actor** slots;
+    jzx_actor_id supervisor;
+    jzx_supervisor_state* supervisor_state;
+    uint32_t hibernate_after_ms;
+    uint64_t last_active_ms;
+    jzx_state_fn on_hibernate;
+    jzx_state_fn on_wake;
+    jzx_stop_fn on_stop;
+    uint64_t mem_bytes;
+    uint64_t mem_peak;
+    uint64_t mem_limit;
+    jzx_mem_action mem_action;
+    uint8_t mem_hit_pending;
+} jzx_actor_cold;
+
+// Fixed-capacity slot table: hot[i] and cold[i] describe the actor with
+// index i, so actor pointers stay valid for the actor's lifetime.
+typedef struct {
+    jzx_actor* hot; // 64-byte aligned within hot_block
+    void* hot_block;
+    jzx_actor_cold* cold;
     uint32_t* generations;
     uint32_t* free_stack;
     uint32_t capacity;
@@ -55,14 +131,67 @@ typedef struct {
     uint32_t used;
 } jzx_actor_table;
 
+// Ring of actor slot indices.
 typedef struct {
-    jzx_actor** entries;
+    uint32_t* entries;
     uint32_t capacity;
     uint32_t head;
     uint32_t tail;
     uint32_t count;
 } jzx_run_queue;
 
+typedef struct {
+    jzx_offload_fn fn;
+    void* arg;
+    jzx_actor_id reply_to;
+    uint32_t tag;
+    jzx_offload_id id;
+    uint64_t submit_ns;
+} jzx_offload_job;
+
+// Bounded FIFO of jobs (ring) drained by a fixed set of worker threads.
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t initialized;
+    uint8_t stop;
+    pthread_t* threads;
+    uint32_t thread_count;
+    jzx_offload_job* jobs;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    jzx_offload_id next_id;
+    jzx_offload_stats stats;
+} jzx_offload_pool;
+
+typedef struct jzx_recorder jzx_recorder;
+typedef struct jzx_perf jzx_perf;
+typedef struct jzx_node_table jzx_node_table;
+
+// Counters in the perf_event_open group (jzx_perf.c).
+#define JZX_PERF_MAX_COUNTERS 4
+
+// Behavior-call watchdog. The loop thread publishes the running call in
+// call_seq/call_start_ns; with JZX_WATCHDOG_STACK a monitor thread signals
+// the loop thread once that call overruns and the handler fills `sample`.
+typedef struct {
+    uint64_t threshold_ns; // 0 = off
+    uint8_t sampling;      // monitor thread running
+    uint8_t stop;
+    int signo;
+    pthread_t thread;
+    pthread_t loop_thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    _Atomic uint64_t call_seq;
+    _Atomic uint64_t call_start_ns;  // 0 between calls
+    _Atomic uint64_t sample_request; // call the monitor asked to sample
+    _Atomic uint64_t sample_seq;     // call the sample was taken in
+    uint32_t sample_depth;
+    void* sample[JZX_WATCHDOG_STACK_MAX];
+} jzx_watchdog;
+
 struct jzx_loop {
     jzx_config cfg;
     jzx_allocator allocator;
@@ -72,20 +201,100 @@ struct jzx_loop {
     uint8_t async_mutex_initialized;
     jzx_async_msg* async_head;
     jzx_async_msg* async_tail;
+    // Recycled async messages, under async_mutex.
+    jzx_pool async_pool;
+    pthread_cond_t async_cond;
+    uint32_t async_waiters;
+    // Load indicators, written by the loop (async_depth under async_mutex) and
+    // read lock-free by producers.
+    _Atomic uint32_t load_async_depth;
+    _Atomic uint32_t load_run_queue_len;
+    _Atomic uint32_t load_last_tick_us;
+    _Atomic uint32_t load_avg_tick_us;
+    // Timers may be added from any thread, so the slab and heap sit behind
+    // timer_mutex; the loop thread fires them.
     pthread_mutex_t timer_mutex;
-    pthread_cond_t timer_cond;
     uint8_t timer_mutex_initialized;
-    uint8_t timer_thread_running;
-    pthread_t timer_thread;
-    uint8_t timer_stop;
-    jzx_timer_entry* timer_head;
-    jzx_timer_id next_timer_id;
+    // Min-heap of slab slots ordered by latest_ns. A batch fires every
+    // timer already due, so timers with slack share wakeups.
+    jzx_timer_entry* timers;
+    uint32_t* timer_heap;
+    uint32_t timer_capacity;
+    uint32_t timer_count;
+    uint32_t timer_free;
+    // latest_ns of the heap top (UINT64_MAX if none), read without the lock
+    // by the tick and the wait.
+    _Atomic uint64_t timer_next_ns;
+    // Linux: CLOCK_MONOTONIC timerfd armed for timer_next_ns, polled after
+    // the signalfd and part of the epoll set. -1 elsewhere.
+    int timer_fd;
+    uint64_t timer_armed_ns;
+    // Loop time at the start of the current tick.
+    uint64_t now_ns;
+    // cfg.virtual_time: the simulated clock, read by any thread adding timers.
+    _Atomic uint64_t virtual_now_ns;
     jzx_io_watch* io_watchers;
     uint32_t io_capacity;
     uint32_t io_count;
     struct pollfd* io_pollfds;
     uint8_t io_dirty;
+    // Set when a blocking wait already polled, so the next tick skips its own.
+    uint8_t io_polled;
+    // fd -> index into io_watchers.
+    jzx_index_map io_index;
+    // jzx_watch_mailbox registrations, unordered. drain_retry is set while
+    // one has fired but its notice is waiting for room in the watcher.
+    jzx_drain_watch* drain_watches;
+    uint32_t drain_count;
+    uint32_t drain_cap;
+    uint8_t drain_retry;
+    // Self-pipe written by producers when the async queue goes non-empty and by
+    // request_stop; wake_pending suppresses redundant writes.
+    int wake_fds[2];
+    _Atomic uint8_t wake_pending;
+    // Linux: epoll set of the wake pipe and watched fds, exposed to embedders.
+    // Elsewhere it aliases wake_fds[0].
+    int backend_fd;
+    jzx_offload_pool offload;
+    jzx_watchdog watchdog;
+    // Signal watches: owner per signo and the event still in its mailbox.
+    jzx_actor_id signal_owners[JZX_SIGNAL_MAX];
+    jzx_signal_event* signal_outstanding[JZX_SIGNAL_MAX];
+    // Linux: 1 if the signal was already blocked in the watching thread, so
+    // releasing the watch leaves it blocked.
+    uint8_t signal_was_blocked[JZX_SIGNAL_MAX];
+    uint32_t signal_count;
+    // Linux: signalfd over the watched set, polled after the wake pipe.
+    // Elsewhere the handler ORs 1 << signo into signal_pending instead.
+    int signal_fd;
+    _Atomic uint64_t signal_pending;
     struct xev_loop* xev;
+    jzx_loop_stats stats;
+    uint64_t rng_state;
+    uint64_t restart_tat_us;
+    // Live actors with hibernate_after_ms set, and when to next look for idle ones.
+    uint32_t hibernate_auto_count;
+    uint64_t hibernate_next_sweep_ms;
+    // Actor whose behavior is executing, if any.
+    jzx_actor* current_actor;
+    // Active traffic recording (jzx_record.c), else NULL.
+    jzx_recorder* recorder;
+    // cfg.perf_counters state (jzx_perf.c), else NULL.
+    jzx_perf* perf;
+    // Peer connections after jzx_node_start (jzx_node.c), else NULL.
+    jzx_node_table* nodes;
+    // Recycled mailbox message buffers.
+    jzx_pool mailbox_pools[JZX_MAILBOX_POOL_CLASSES];
+    // Memory accounting: `allocator` is then a shim over cfg.allocator that
+    // prefixes blocks with a jzx_mem_header. Allocations on mem_thread are
+    // charged to mem_charge, else to current_actor.
+    uint8_t mem_enabled;
+    uint8_t mem_actors_ready;
+    uint8_t mem_limit_pending;
+    pthread_t mem_thread;
+    jzx_actor* mem_charge;
+    _Atomic uint64_t mem_bytes;
+    _Atomic uint64_t mem_peak;
     int running;
     int stop_requested;
 };
@@ -96,17 +305,26 @@ struct jzx_async_msg {
     size_t len;
     uint32_t tag;
     jzx_actor_id sender;
+    uint64_t deadline_ms;
     struct jzx_async_msg* next;
 };
 
+// Timers live in a slab indexed by the low half of their id; the high half is
+// the slot generation, so ids of fired or cancelled timers go stale.
 struct jzx_timer_entry {
-    jzx_timer_id id;
+    jzx_timer_id id; // 0 while the slot is free
     jzx_actor_id target;
     void* data;
     size_t len;
     uint32_t tag;
-    uint64_t due_ms;
-    struct jzx_timer_entry* next;
+    uint32_t generation;
+    uint32_t heap_index;
+    uint32_t next_free;
+    uint64_t period_ns; // 0 for one-shot timers
+    uint64_t slack_ns;
+    uint64_t due_ns;
+    // Heap key: the timer may fire anywhere in [due_ns, latest_ns].
+    uint64_t latest_ns;
 };
 
 struct jzx_io_watch {
@@ -114,6 +332,73 @@ struct jzx_io_watch {
     jzx_actor_id owner;
     uint32_t interest;
     uint8_t active;
+    // Cleared after a ONESHOT or EDGE delivery; the pollfd slot is parked at -1.
+    uint8_t armed;
+    // COALESCE: event sitting in the owner's mailbox, cleared at dispatch.
+    jzx_io_event* outstanding;
+};
+
+struct jzx_drain_watch {
+    jzx_actor_id target;
+    jzx_actor_id watcher;
+    uint32_t tag;
+    uint32_t depth;
+    uint8_t fired;
 };
 
+// --- Recorder (jzx_record.c) ---
+
+// Appends one enqueued message to the recording. Loop thread only.
+void jzx_record_note(jzx_recorder* rec,
+                     uint64_t time_ns,
+                     jzx_actor_id sender,
+                     jzx_actor_id target,
+                     uint32_t tag,
+                     const void* data,
+                     size_t len);
+// Stops a recording left running at jzx_loop_destroy.
+void jzx_record_shutdown(jzx_loop* loop);
+
+// --- Perf counters (jzx_perf.c) ---
+
+jzx_err jzx_perf_init(jzx_loop* loop);
+void jzx_perf_shutdown(jzx_loop* loop);
+// Counts the call and, if it is sampled and the counters could be read,
+// snapshots them into `before` and returns 1. The first sampled call opens the counter group on
+// the calling thread.
+int jzx_perf_begin(jzx_perf* perf, uint64_t* before);
+// Accumulates the delta since `before` for the actor and the tag.
+void jzx_perf_end(jzx_loop* loop, jzx_actor_id actor, uint32_t tag, const uint64_t* before);
+
+// --- Nodes (jzx_node.c) ---
+
+// Queues a frame for an id whose node bits name another node. The payload is
+// copied; releasing the original is up to the caller. A nonzero deadline_ms
+// travels with the frame.
+jzx_err jzx_node_route(jzx_loop* loop,
+                       jzx_actor_id target,
+                       void* data,
+                       size_t len,
+                       uint32_t tag,
+                       jzx_actor_id sender,
+                       uint64_t deadline_ms);
+uint32_t jzx_node_self(const jzx_node_table* nodes);
+// Frees the node table left at jzx_loop_destroy without notifying anyone.
+void jzx_node_shutdown(jzx_loop* loop);
+
+// --- Runtime entry points for modules (jzx_runtime.c) ---
+
+// jzx_send_deadline with an explicit sender id (deadline_ms 0 = none).
+jzx_err jzx_send_from(jzx_loop* loop,
+                      jzx_actor_id target,
+                      void* data,
+                      size_t len,
+                      uint32_t tag,
+                      jzx_actor_id sender,
+                      uint64_t deadline_ms);
+
+// Called first thing on every runtime-owned thread so signals meant for
+// watchers never land there.
+void jzx_block_all_signals(void);
+
 #endif
@@ -0,0 +1,522 @@
+#include "jzx/metrics.h"
+#include "jzx_internal.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define JZX_METRICS_TAG_STOP 0xffff0301u
+#define JZX_METRICS_MAX_CONNS 4
+#define JZX_METRICS_REQUEST_MAX 2048
+#define JZX_METRICS_ACCEPTS_PER_EVENT 8
+// Room kept in front of the body for the status line and headers, which are
+// written last once Content-Length is known.
+#define JZX_METRICS_HEAD_ROOM 160u
+#define JZX_METRICS_INITIAL_OUT 4096u
+
+typedef struct {
+    int fd; // -1 = free slot
+    uint32_t in_len;
+    // Response bytes out[out_off, out_end) still to be written; 0/0 while the
+    // request is being read.
+    uint32_t out_off;
+    uint32_t out_end;
+    uint32_t out_cap;
+    char* out;
+    char in[JZX_METRICS_REQUEST_MAX];
+} jzx_metrics_conn;
+
+typedef struct {
+    jzx_loop* loop;
+    jzx_actor_id self;
+    int listen_fd;
+    char* unix_path; // copy, unlinked on stop
+    uint64_t scrapes;
+    jzx_metrics_conn conns[JZX_METRICS_MAX_CONNS];
+} jzx_metrics_exporter;
+
+// -----------------------------------------------------------------------------
+// Rendering
+// -----------------------------------------------------------------------------
+
+// Appends while there is room; len keeps counting past cap so callers learn
+// the size they need.
+typedef struct {
+    char* buf;
+    size_t cap;
+    size_t len;
+} jzx_metrics_writer;
+
+static void jzx_metrics_put(jzx_metrics_writer* w, const char* s, size_t n) {
+    if (w->len < w->cap) {
+        size_t room = w->cap - w->len;
+        memcpy(w->buf + w->len, s, n < room ? n : room);
+    }
+    w->len += n;
+}
+
+static void jzx_metrics_puts(jzx_metrics_writer* w, const char* s) {
+    jzx_metrics_put(w, s, strlen(s));
+}
+
+static void jzx_metrics_put_u64(jzx_metrics_writer* w, uint64_t v) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - ++n] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v);
+    jzx_metrics_put(w, digits + sizeof(digits) - n, n);
+}
+
+static void jzx_metrics_family(jzx_metrics_writer* w, const char* name, const char* type, const char* help) {
+    jzx_metrics_puts(w, "# TYPE ");
+    jzx_metrics_puts(w, name);
+    jzx_metrics_put(w, " ", 1);
+    jzx_metrics_puts(w, type);
+    jzx_metrics_puts(w, "\n# HELP ");
+    jzx_metrics_puts(w, name);
+    jzx_metrics_put(w, " ", 1);
+    jzx_metrics_puts(w, help);
+    jzx_metrics_put(w, "\n", 1);
+}
+
+// One sample; counters get the _total suffix.
+static void jzx_metrics_sample(jzx_metrics_writer* w, const char* name, const char* suffix, const char* labels, uint64_t v) {
+    jzx_metrics_puts(w, name);
+    jzx_metrics_puts(w, suffix);
+    if (labels) {
+        jzx_metrics_puts(w, labels);
+    }
+    jzx_metrics_put(w, " ", 1);
+    jzx_metrics_put_u64(w, v);
+    jzx_metrics_put(w, "\n", 1);
+}
+
+static void jzx_metrics_gauge(jzx_metrics_writer* w, const char* name, const char* help, uint64_t v) {
+    jzx_metrics_family(w, name, "gauge", help);
+    jzx_metrics_sample(w, name, "", NULL, v);
+}
+
+static void jzx_metrics_counter(jzx_metrics_writer* w, const char* name, const char* help, uint64_t v) {
+    jzx_metrics_family(w, name, "counter", help);
+    jzx_metrics_sample(w, name, "_total", NULL, v);
+}
+
+static void jzx_metrics_render_loop(jzx_loop* loop, jzx_metrics_writer* w, uint64_t scrapes) {
+    const jzx_loop_stats* st = &loop->stats;
+    jzx_loop_load load;
+    jzx_loop_get_load(loop, &load);
+
+    // Stopping and failed actors are always queued for teardown, so the run
+    // queue holds all of them; no need to walk the actor table.
+    uint64_t stopping = 0;
+    uint64_t failed = 0;
+    const jzx_run_queue* rq = &loop->run_queue;
+    for (uint32_t i = 0, idx = rq->head; i < rq->count; ++i, idx = idx + 1 == rq->capacity ? 0 : idx + 1) {
+        jzx_actor_status status = (jzx_actor_status)loop->actors.hot[rq->entries[idx]].status;
+        stopping += status == JZX_ACTOR_STOPPING;
+        failed += status == JZX_ACTOR_FAILED;
+    }
+    uint64_t live = loop->actors.used;
+    uint64_t hibernated = st->actors_hibernated;
+    uint64_t running = live - stopping - failed - (hibernated < live ? hibernated : live);
+
+    pthread_mutex_lock(&loop->timer_mutex);
+    uint64_t timers = loop->timer_count;
+    pthread_mutex_unlock(&loop->timer_mutex);
+
+    jzx_metrics_counter(w, "jzx_loop_ticks", "Loop ticks run.", st->ticks);
+    jzx_metrics_family(w, "jzx_loop_tick_microseconds", "gauge", "Duration of the last tick and its moving average.");
+    jzx_metrics_sample(w, "jzx_loop_tick_microseconds", "", "{stat=\"last\"}", load.last_tick_us);
+    jzx_metrics_sample(w, "jzx_loop_tick_microseconds", "", "{stat=\"avg\"}", load.avg_tick_us);
+    jzx_metrics_gauge(w, "jzx_run_queue_depth", "Actors ready to run.", rq->count);
+    jzx_metrics_gauge(w, "jzx_async_queue_depth", "Cross-thread messages not yet dispatched.", load.async_depth);
+    if (loop->offload.initialized) {
+        jzx_offload_stats off;
+        jzx_offload_get_stats(loop, &off);
+        jzx_metrics_gauge(w, "jzx_offload_queue_depth", "Offload jobs waiting for a worker.", off.queued);
+    }
+
+    jzx_metrics_family(w, "jzx_actors", "gauge", "Live actors by state.");
+    jzx_metrics_sample(w, "jzx_actors", "", "{state=\"running\"}", running);
+    jzx_metrics_sample(w, "jzx_actors", "", "{state=\"hibernated\"}", hibernated);
+    jzx_metrics_sample(w, "jzx_actors", "", "{state=\"stopping\"}", stopping);
+    jzx_metrics_sample(w, "jzx_actors", "", "{state=\"failed\"}", failed);
+    jzx_metrics_gauge(w, "jzx_actor_capacity", "Actor table size (cfg.max_actors).", loop->actors.capacity);
+
+    jzx_metrics_counter(w, "jzx_restarts", "Supervisor restarts.", st->restarts);
+    jzx_metrics_counter(w, "jzx_restarts_deferred", "Restarts delayed by the loop-wide restart rate.", st->restarts_deferred);
+    jzx_metrics_counter(w, "jzx_messages_expired", "Messages dropped past their deadline.", st->messages_expired);
+    jzx_metrics_counter(w, "jzx_messages_conflated", "Keyed messages replaced before delivery.", st->messages_conflated);
+
+    jzx_metrics_gauge(w, "jzx_timers", "Pending timers.", timers);
+    jzx_metrics_counter(w, "jzx_timers_fired", "Timers fired.", st->timers_fired);
+    jzx_metrics_counter(w, "jzx_timer_wakeups", "Timer batches fired.", st->timer_wakeups);
+
+    jzx_metrics_gauge(w, "jzx_io_watchers", "Watched file descriptors.", loop->io_count);
+    jzx_metrics_counter(w, "jzx_io_events", "I/O readiness events delivered.", st->io_events);
+
+    if (loop->mem_enabled) {
+        jzx_metrics_gauge(w, "jzx_memory_bytes", "Bytes allocated through the loop.",
+                          atomic_load_explicit(&loop->mem_bytes, memory_order_relaxed));
+    }
+    if (loop->cfg.watchdog_threshold_us) {
+        jzx_metrics_counter(w, "jzx_watchdog_overruns", "Behavior calls over the watchdog threshold.",
+                            st->watchdog_overruns);
+    }
+    jzx_metrics_counter(w, "jzx_metrics_scrapes", "Scrapes served by the exporter.", scrapes);
+    jzx_metrics_puts(w, "# EOF\n");
+}
+
+jzx_err jzx_metrics_render(jzx_loop* loop, char* buf, size_t cap, size_t* out_len) {
+    if (!loop || (!buf && cap) || !out_len) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_metrics_writer w = {.buf = buf, .cap = cap, .len = 0};
+    jzx_metrics_render_loop(loop, &w, 0);
+    *out_len = w.len;
+    return w.len <= cap ? JZX_OK : JZX_ERR_NO_MEMORY;
+}
+
+// -----------------------------------------------------------------------------
+// Connections
+// -----------------------------------------------------------------------------
+
+static int jzx_metrics_set_nonblock(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    int fdfl = fcntl(fd, F_GETFD);
+    if (fdfl >= 0) {
+        (void)fcntl(fd, F_SETFD, fdfl | FD_CLOEXEC);
+    }
+    return 0;
+}
+
+static void jzx_metrics_conn_close(jzx_metrics_exporter* e, jzx_metrics_conn* c) {
+    (void)jzx_unwatch_fd(e->loop, c->fd);
+    close(c->fd);
+    c->fd = -1;
+    c->in_len = 0;
+    c->out_off = 0;
+    c->out_end = 0;
+}
+
+// Writes what the socket takes; closes the connection once the response is out.
+static void jzx_metrics_conn_flush(jzx_metrics_exporter* e, jzx_metrics_conn* c) {
+    while (c->out_off < c->out_end) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_end - c->out_off, MSG_NOSIGNAL);
+#else
+        ssize_t n = write(c->fd, c->out + c->out_off, c->out_end - c->out_off);
+#endif
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                (void)jzx_watch_fd(e->loop, c->fd, e->self, JZX_IO_WRITE);
+                return;
+            }
+            break;
+        }
+        c->out_off += (uint32_t)n;
+    }
+    jzx_metrics_conn_close(e, c);
+}
+
+static int jzx_metrics_conn_reserve(jzx_loop* loop, jzx_metrics_conn* c, size_t need) {
+    if (need <= c->out_cap) {
+        return 0;
+    }
+    size_t cap = c->out_cap ? c->out_cap : JZX_METRICS_INITIAL_OUT;
+    while (cap < need) {
+        cap *= 2u;
+    }
+    if (cap > UINT32_MAX) {
+        return -1;
+    }
+    char* grown = (char*)jzx_loop_alloc(loop, cap);
+    if (!grown) {
+        return -1;
+    }
+    if (c->out) {
+        jzx_loop_free(loop, c->out);
+    }
+    c->out = grown;
+    c->out_cap = (uint32_t)cap;
+    return 0;
+}
+
+static void jzx_metrics_conn_respond(jzx_metrics_exporter* e, jzx_metrics_conn* c) {
+    static const char not_found[] =
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    int ok = (c->in_len >= 13 && memcmp(c->in, "GET /metrics", 12) == 0 && (c->in[12] == ' ' || c->in[12] == '?')) ||
+             (c->in_len >= 6 && memcmp(c->in, "GET / ", 6) == 0);
+    if (!ok) {
+        if (jzx_metrics_conn_reserve(e->loop, c, sizeof(not_found)) != 0) {
+            jzx_metrics_conn_close(e, c);
+            return;
+        }
+        memcpy(c->out, not_found, sizeof(not_found) - 1);
+        c->out_off = 0;
+        c->out_end = sizeof(not_found) - 1;
+        jzx_metrics_conn_flush(e, c);
+        return;
+    }
+    e->scrapes++;
+    jzx_metrics_writer w = {0};
+    // The buffer from the previous scrape nearly always fits; a second pass is
+    // only needed after it grows.
+    for (int pass = 0; pass < 2; ++pass) {
+        if (jzx_metrics_conn_reserve(e->loop, c, JZX_METRICS_HEAD_ROOM + w.len) != 0) {
+            jzx_metrics_conn_close(e, c);
+            return;
+        }
+        w.buf = c->out + JZX_METRICS_HEAD_ROOM;
+        w.cap = c->out_cap - JZX_METRICS_HEAD_ROOM;
+        w.len = 0;
+        jzx_metrics_render_loop(e->loop, &w, e->scrapes);
+        if (w.len <= w.cap) {
+            break;
+        }
+    }
+    char head[JZX_METRICS_HEAD_ROOM];
+    int head_len = snprintf(head, sizeof(head),
+                            "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                            "Content-Length: %zu\r\n"
+                            "Connection: close\r\n\r\n",
+                            w.len);
+    c->out_off = JZX_METRICS_HEAD_ROOM - (uint32_t)head_len;
+    c->out_end = JZX_METRICS_HEAD_ROOM + (uint32_t)w.len;
+    memcpy(c->out + c->out_off, head, (size_t)head_len);
+    jzx_metrics_conn_flush(e, c);
+}
+
+static void jzx_metrics_conn_read(jzx_metrics_exporter* e, jzx_metrics_conn* c) {
+    for (;;) {
+        if (c->in_len == sizeof(c->in)) {
+            // Headers too large for a scrape request.
+            jzx_metrics_conn_close(e, c);
+            return;
+        }
+        ssize_t n = read(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                jzx_metrics_conn_close(e, c);
+            }
+            return;
+        }
+        if (n == 0) {
+            jzx_metrics_conn_close(e, c);
+            return;
+        }
+        uint32_t scan_from = c->in_len > 3 ? c->in_len - 3 : 0;
+        c->in_len += (uint32_t)n;
+        for (uint32_t i = scan_from; i + 3 < c->in_len; ++i) {
+            if (memcmp(c->in + i, "\r\n\r\n", 4) == 0) {
+                jzx_metrics_conn_respond(e, c);
+                return;
+            }
+        }
+    }
+}
+
+static void jzx_metrics_accept(jzx_metrics_exporter* e) {
+    for (int i = 0; i < JZX_METRICS_ACCEPTS_PER_EVENT; ++i) {
+        int fd = accept(e->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+        jzx_metrics_conn* slot = NULL;
+        for (uint32_t j = 0; j < JZX_METRICS_MAX_CONNS; ++j) {
+            if (e->conns[j].fd < 0) {
+                slot = &e->conns[j];
+                break;
+            }
+        }
+        if (!slot || jzx_metrics_set_nonblock(fd) != 0 ||
+            jzx_watch_fd(e->loop, fd, e->self, JZX_IO_READ) != JZX_OK) {
+            close(fd);
+            continue;
+        }
+        slot->fd = fd;
+        slot->in_len = 0;
+        slot->out_off = 0;
+        slot->out_end = 0;
+    }
+}
+
+static void jzx_metrics_exporter_free(jzx_metrics_exporter* e) {
+    for (uint32_t i = 0; i < JZX_METRICS_MAX_CONNS; ++i) {
+        if (e->conns[i].fd >= 0) {
+            jzx_metrics_conn_close(e, &e->conns[i]);
+        }
+        if (e->conns[i].out) {
+            jzx_loop_free(e->loop, e->conns[i].out);
+        }
+    }
+    if (e->listen_fd >= 0) {
+        (void)jzx_unwatch_fd(e->loop, e->listen_fd);
+        close(e->listen_fd);
+    }
+    if (e->unix_path) {
+        unlink(e->unix_path);
+        jzx_loop_free(e->loop, e->unix_path);
+    }
+    jzx_loop_free(e->loop, e);
+}
+
+static jzx_behavior_result jzx_metrics_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_metrics_exporter* e = (jzx_metrics_exporter*)ctx->state;
+    if (msg->tag == JZX_METRICS_TAG_STOP) {
+        jzx_metrics_exporter_free(e);
+        return JZX_BEHAVIOR_STOP;
+    }
+    if (msg->tag != JZX_TAG_SYS_IO || !msg->data) {
+        return JZX_BEHAVIOR_OK;
+    }
+    jzx_io_event* ev = (jzx_io_event*)msg->data;
+    int fd = ev->fd;
+    jzx_loop_free(e->loop, ev);
+    if (fd == e->listen_fd) {
+        jzx_metrics_accept(e);
+        return JZX_BEHAVIOR_OK;
+    }
+    for (uint32_t i = 0; i < JZX_METRICS_MAX_CONNS; ++i) {
+        jzx_metrics_conn* c = &e->conns[i];
+        if (c->fd != fd) {
+            continue;
+        }
+        if (c->out_end) {
+            jzx_metrics_conn_flush(e, c);
+        } else {
+            jzx_metrics_conn_read(e, c);
+        }
+        break;
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+static int jzx_metrics_listen(const jzx_metrics_opts* opts) {
+    int fd = -1;
+    if (opts->unix_path) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        size_t n = strlen(opts->unix_path);
+        if (n >= sizeof(addr.sun_path)) {
+            return -1;
+        }
+        memcpy(addr.sun_path, opts->unix_path, n);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        unlink(opts->unix_path);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(opts->port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        int one = 1;
+        (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, 16) != 0 || jzx_metrics_set_nonblock(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+jzx_err jzx_metrics_start(jzx_loop* loop, const jzx_metrics_opts* opts, jzx_actor_id* out_exporter) {
+    if (!loop || !opts || (!opts->unix_path && opts->port == 0)) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_metrics_exporter* e = (jzx_metrics_exporter*)jzx_loop_alloc(loop, sizeof(jzx_metrics_exporter));
+    if (!e) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(e, 0, sizeof(*e));
+    e->loop = loop;
+    e->listen_fd = -1;
+    for (uint32_t i = 0; i < JZX_METRICS_MAX_CONNS; ++i) {
+        e->conns[i].fd = -1;
+    }
+    if (opts->unix_path) {
+        size_t n = strlen(opts->unix_path) + 1;
+        e->unix_path = (char*)jzx_loop_alloc(loop, n);
+        if (!e->unix_path) {
+            jzx_metrics_exporter_free(e);
+            return JZX_ERR_NO_MEMORY;
+        }
+        memcpy(e->unix_path, opts->unix_path, n);
+    }
+    int fd = jzx_metrics_listen(opts);
+    if (fd < 0) {
+        // Do not unlink a path we failed to bind.
+        if (e->unix_path) {
+            jzx_loop_free(loop, e->unix_path);
+            e->unix_path = NULL;
+        }
+        jzx_metrics_exporter_free(e);
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    jzx_spawn_opts spawn = {.behavior = jzx_metrics_behavior, .state = e};
+    jzx_err err = jzx_spawn(loop, &spawn, &e->self);
+    if (err != JZX_OK) {
+        close(fd);
+        jzx_metrics_exporter_free(e);
+        return err;
+    }
+    err = jzx_watch_fd(loop, fd, e->self, JZX_IO_READ);
+    if (err != JZX_OK) {
+        close(fd);
+        (void)jzx_send(loop, e->self, NULL, 0, JZX_METRICS_TAG_STOP);
+        return err;
+    }
+    e->listen_fd = fd;
+    if (out_exporter) {
+        *out_exporter = e->self;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_metrics_stop(jzx_loop* loop, jzx_actor_id exporter) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_send(loop, exporter, NULL, 0, JZX_METRICS_TAG_STOP);
+}
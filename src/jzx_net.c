@@ -0,0 +1,1178 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // splice, pipe2, F_SETPIPE_SZ
+#endif
+
+#include "jzx/net.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+// Internal control tags understood by connection and acceptor actors.
+#define JZX_NET_TAG_WRITE  0xffff0110u
+#define JZX_NET_TAG_FLUSH  0xffff0111u
+#define JZX_NET_TAG_RESUME 0xffff0112u
+#define JZX_NET_TAG_CLOSE  0xffff0113u
+#define JZX_NET_TAG_XFER_CONTINUE 0xffff0114u
+#define JZX_NET_TAG_XFER_CANCEL   0xffff0115u
+
+#define JZX_NET_IOV_BATCH 64
+#define JZX_NET_READS_PER_EVENT 4
+#define JZX_NET_ACCEPTS_PER_EVENT 64
+// Only if the owner's mailbox cannot be watched.
+#define JZX_NET_RESUME_POLL_MS 1
+#define JZX_NET_XFER_CALLS_PER_EVENT 4
+
+// A frame handed to the owner is the head of one of these, so releasing a
+// frame returns the whole block (header + payload) to the pool.
+typedef struct jzx_net_block {
+    jzx_net_frame frame;
+    struct jzx_net_block* next;
+    size_t cap;
+    // Write queue: bytes of prefix + payload already written.
+    size_t off;
+    uint8_t prefix[4];
+    uint8_t prefix_len;
+    uint8_t data[];
+} jzx_net_block;
+
+struct jzx_net {
+    jzx_loop* loop;
+    uint32_t buffer_size;
+    uint32_t pool_max;
+    jzx_net_block* pool;
+    jzx_net_stats stats;
+};
+
+typedef struct {
+    jzx_net* net;
+    int fd;
+    uint8_t is_socket;
+    jzx_actor_id self;
+    jzx_actor_id owner;
+    jzx_net_conn_opts opts;
+    // Framed modes: bytes read but not yet split into frames.
+    uint8_t* rbuf;
+    size_t rcap;
+    size_t rlen;
+    jzx_net_block* wq_head;
+    jzx_net_block* wq_tail;
+    // Frame the owner's mailbox had no room for; redelivered on resume.
+    jzx_net_block* stalled;
+    uint32_t interest;
+    uint8_t flush_pending;
+    uint8_t want_write;
+    uint8_t paused;
+    uint8_t resume_pending;
+    uint8_t closing;
+    // Closed and reported; draining its own mailbox before stopping.
+    uint8_t finished;
+} jzx_net_conn;
+
+typedef struct {
+    jzx_net* net;
+    int fd;
+    jzx_actor_id self;
+    jzx_net_listen_opts opts;
+} jzx_net_acceptor;
+
+// -----------------------------------------------------------------------------
+// Buffer pool
+// -----------------------------------------------------------------------------
+
+static jzx_net_block* jzx_net_block_get(jzx_net* net, size_t need) {
+    if (need > 0 && need <= net->buffer_size && net->pool) {
+        jzx_net_block* block = net->pool;
+        net->pool = block->next;
+        net->stats.pool_free--;
+        memset(&block->frame, 0, sizeof(block->frame));
+        block->next = NULL;
+        block->off = 0;
+        block->prefix_len = 0;
+        return block;
+    }
+    // Header-only blocks (open/close notices) are sized exactly; anything that
+    // fits the pool size is allocated at the pool size so it can be recycled.
+    size_t cap = need == 0 ? 0 : (need <= net->buffer_size ? net->buffer_size : need);
+    jzx_net_block* block = (jzx_net_block*)jzx_loop_alloc(net->loop, sizeof(jzx_net_block) + cap);
+    if (!block) {
+        return NULL;
+    }
+    memset(block, 0, sizeof(*block));
+    block->cap = cap;
+    return block;
+}
+
+static void jzx_net_block_put(jzx_net* net, jzx_net_block* block) {
+    if (block->cap == net->buffer_size && net->stats.pool_free < net->pool_max) {
+        block->next = net->pool;
+        net->pool = block;
+        net->stats.pool_free++;
+        return;
+    }
+    jzx_loop_free(net->loop, block);
+}
+
+static int jzx_net_set_nonblock(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    int fdfl = fcntl(fd, F_GETFD);
+    if (fdfl >= 0) {
+        (void)fcntl(fd, F_SETFD, fdfl | FD_CLOEXEC);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Connection actor
+// -----------------------------------------------------------------------------
+
+static void jzx_net_conn_update_watch(jzx_net_conn* conn) {
+    jzx_loop* loop = conn->net->loop;
+    uint32_t interest = 0;
+    if (!conn->paused && !conn->closing) {
+        interest |= JZX_IO_READ;
+    }
+    if (conn->want_write) {
+        interest |= JZX_IO_WRITE;
+    }
+    if (interest == conn->interest) {
+        return;
+    }
+    if (interest == 0) {
+        (void)jzx_unwatch_fd(loop, conn->fd);
+    } else if (jzx_watch_fd(loop, conn->fd, conn->self, interest | JZX_IO_COALESCE) != JZX_OK) {
+        return;
+    }
+    conn->interest = interest;
+}
+
+static void jzx_net_notify(jzx_net_conn* conn, uint32_t tag, int error) {
+    if (!conn->owner) {
+        return;
+    }
+    jzx_net_block* block = jzx_net_block_get(conn->net, 0);
+    if (!block) {
+        return;
+    }
+    block->frame.conn = conn->self;
+    block->frame.error = error;
+    if (jzx_send(conn->net->loop, conn->owner, &block->frame, sizeof(jzx_net_frame), tag) != JZX_OK) {
+        jzx_net_block_put(conn->net, block);
+    }
+}
+
+// A finished connection outlives its fd until its mailbox is empty, so WRITE
+// blocks and IO events still queued for it go back to the pool rather than to
+// cfg.release, which cannot know these tags.
+static jzx_behavior_result jzx_net_conn_linger(jzx_net_conn* conn) {
+    uint32_t depth = 0;
+    if (jzx_actor_mailbox_depth(conn->net->loop, conn->self, &depth) == JZX_OK && depth > 0) {
+        return JZX_BEHAVIOR_OK;
+    }
+    jzx_loop_free(conn->net->loop, conn);
+    return JZX_BEHAVIOR_STOP;
+}
+
+static jzx_behavior_result jzx_net_conn_finish(jzx_net_conn* conn, int error) {
+    jzx_net* net = conn->net;
+    if (conn->interest) {
+        (void)jzx_unwatch_fd(net->loop, conn->fd);
+    }
+    close(conn->fd);
+    while (conn->wq_head) {
+        jzx_net_block* next = conn->wq_head->next;
+        jzx_net_block_put(net, conn->wq_head);
+        conn->wq_head = next;
+    }
+    if (conn->stalled) {
+        jzx_net_block_put(net, conn->stalled);
+    }
+    if (conn->rbuf) {
+        jzx_loop_free(net->loop, conn->rbuf);
+    }
+    jzx_net_notify(conn, JZX_TAG_NET_CLOSED, error);
+    conn->finished = 1;
+    return jzx_net_conn_linger(conn);
+}
+
+// RESUME arrives once the owner has drained to resume_depth, or, after a
+// full mailbox with no pause_depth set, to half its capacity.
+static void jzx_net_conn_schedule_resume(jzx_net_conn* conn) {
+    if (conn->resume_pending) {
+        return;
+    }
+    jzx_loop* loop = conn->net->loop;
+    uint32_t depth = conn->opts.pause_depth ? conn->opts.resume_depth : UINT32_MAX;
+    if (jzx_watch_mailbox(loop, conn->owner, depth, conn->self, JZX_NET_TAG_RESUME) == JZX_OK ||
+        jzx_send_after(loop, conn->self, JZX_NET_RESUME_POLL_MS, NULL, 0, JZX_NET_TAG_RESUME, NULL) ==
+            JZX_OK) {
+        conn->resume_pending = 1;
+    }
+}
+
+static void jzx_net_conn_pause(jzx_net_conn* conn) {
+    if (!conn->paused) {
+        conn->paused = 1;
+        conn->net->stats.read_pauses++;
+        jzx_net_conn_update_watch(conn);
+    }
+    jzx_net_conn_schedule_resume(conn);
+}
+
+static int jzx_net_owner_backlogged(jzx_net_conn* conn, uint32_t threshold) {
+    uint32_t depth = 0;
+    if (threshold == 0 || jzx_actor_mailbox_depth(conn->net->loop, conn->owner, &depth) != JZX_OK) {
+        return 0;
+    }
+    return depth >= threshold;
+}
+
+// Returns 0 if delivered, 1 if the owner's mailbox is full (the block is kept
+// as stalled and reads pause), -1 if the owner is gone.
+static int jzx_net_conn_deliver(jzx_net_conn* conn, jzx_net_block* block) {
+    jzx_net* net = conn->net;
+    block->frame.conn = conn->self;
+    jzx_err err = jzx_send(net->loop, conn->owner, &block->frame, sizeof(jzx_net_frame), JZX_TAG_NET_DATA);
+    if (err == JZX_ERR_MAILBOX_FULL) {
+        conn->stalled = block;
+        jzx_net_conn_pause(conn);
+        return 1;
+    }
+    if (err != JZX_OK) {
+        jzx_net_block_put(net, block);
+        return -1;
+    }
+    net->stats.frames_in++;
+    if (jzx_net_owner_backlogged(conn, conn->opts.pause_depth)) {
+        jzx_net_conn_pause(conn);
+    }
+    return 0;
+}
+
+static int jzx_net_conn_deliver_copy(jzx_net_conn* conn, const uint8_t* bytes, size_t len) {
+    jzx_net_block* block = jzx_net_block_get(conn->net, len ? len : 1);
+    if (!block) {
+        return -1;
+    }
+    memcpy(block->data, bytes, len);
+    block->frame.bytes = block->data;
+    block->frame.len = len;
+    return jzx_net_conn_deliver(conn, block);
+}
+
+// Splits rbuf into frames. Returns 0 to keep reading, 1 if delivery stalled,
+// or -1 with an errno value in *error.
+static int jzx_net_conn_parse(jzx_net_conn* conn, int* error) {
+    size_t pos = 0;
+    int rc = 0;
+    while (rc == 0 && pos < conn->rlen) {
+        size_t avail = conn->rlen - pos;
+        if (conn->opts.framing == JZX_NET_FRAME_LEN32) {
+            if (avail < 4) {
+                break;
+            }
+            const uint8_t* p = conn->rbuf + pos;
+            size_t flen = ((size_t)p[0] << 24) | ((size_t)p[1] << 16) | ((size_t)p[2] << 8) | (size_t)p[3];
+            if (flen > conn->opts.max_frame) {
+                *error = EMSGSIZE;
+                return -1;
+            }
+            if (avail - 4 < flen) {
+                break;
+            }
+            rc = jzx_net_conn_deliver_copy(conn, p + 4, flen);
+            pos += 4 + flen;
+        } else {
+            const uint8_t* p = conn->rbuf + pos;
+            const uint8_t* nl = (const uint8_t*)memchr(p, '\n', avail);
+            if (!nl) {
+                if (avail > conn->opts.max_frame) {
+                    *error = EMSGSIZE;
+                    return -1;
+                }
+                break;
+            }
+            size_t flen = (size_t)(nl - p);
+            rc = jzx_net_conn_deliver_copy(conn, p, flen);
+            pos += flen + 1;
+        }
+    }
+    if (pos > 0) {
+        memmove(conn->rbuf, conn->rbuf + pos, conn->rlen - pos);
+        conn->rlen -= pos;
+    }
+    if (rc < 0) {
+        *error = EPIPE;
+        return -1;
+    }
+    return rc;
+}
+
+static int jzx_net_conn_reserve(jzx_net_conn* conn) {
+    size_t want = conn->rcap ? conn->rcap : conn->net->buffer_size;
+    if (conn->rbuf && conn->rlen < conn->rcap) {
+        return 0;
+    }
+    if (conn->rbuf) {
+        want = conn->rcap * 2;
+    }
+    uint8_t* grown = (uint8_t*)jzx_loop_alloc(conn->net->loop, want);
+    if (!grown) {
+        return -1;
+    }
+    if (conn->rbuf) {
+        memcpy(grown, conn->rbuf, conn->rlen);
+        jzx_loop_free(conn->net->loop, conn->rbuf);
+    }
+    conn->rbuf = grown;
+    conn->rcap = want;
+    return 0;
+}
+
+// Reads until EAGAIN, a pause or JZX_NET_READS_PER_EVENT reads. Returns 0 or
+// an errno value (-1 for orderly EOF) that should close the connection.
+static int jzx_net_conn_read(jzx_net_conn* conn) {
+    jzx_net* net = conn->net;
+    for (int i = 0; i < JZX_NET_READS_PER_EVENT && !conn->paused; ++i) {
+        ssize_t n;
+        if (conn->opts.framing == JZX_NET_FRAME_RAW) {
+            jzx_net_block* block = jzx_net_block_get(net, net->buffer_size);
+            if (!block) {
+                return ENOMEM;
+            }
+            n = read(conn->fd, block->data, block->cap);
+            if (n > 0) {
+                net->stats.bytes_in += (uint64_t)n;
+                block->frame.bytes = block->data;
+                block->frame.len = (size_t)n;
+                if (jzx_net_conn_deliver(conn, block) < 0) {
+                    return EPIPE;
+                }
+                continue;
+            }
+            jzx_net_block_put(net, block);
+        } else {
+            if (jzx_net_conn_reserve(conn) != 0) {
+                return ENOMEM;
+            }
+            n = read(conn->fd, conn->rbuf + conn->rlen, conn->rcap - conn->rlen);
+            if (n > 0) {
+                net->stats.bytes_in += (uint64_t)n;
+                conn->rlen += (size_t)n;
+                int error = 0;
+                if (jzx_net_conn_parse(conn, &error) < 0) {
+                    return error;
+                }
+                continue;
+            }
+        }
+        if (n == 0) {
+            return -1;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        return errno;
+    }
+    return 0;
+}
+
+static ssize_t jzx_net_gather_write(jzx_net_conn* conn, struct iovec* iov, int count) {
+#ifdef MSG_NOSIGNAL
+    if (conn->is_socket) {
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = iov;
+        mh.msg_iovlen = (size_t)count;
+        return sendmsg(conn->fd, &mh, MSG_NOSIGNAL);
+    }
+#endif
+    return writev(conn->fd, iov, count);
+}
+
+// Writes as much of the queue as the socket takes. Returns 0 or an errno.
+static int jzx_net_conn_flush(jzx_net_conn* conn) {
+    jzx_net* net = conn->net;
+    while (conn->wq_head) {
+        struct iovec iov[JZX_NET_IOV_BATCH];
+        int count = 0;
+        for (jzx_net_block* b = conn->wq_head; b && count + 2 <= JZX_NET_IOV_BATCH; b = b->next) {
+            size_t off = b->off;
+            if (off < b->prefix_len) {
+                iov[count].iov_base = b->prefix + off;
+                iov[count].iov_len = b->prefix_len - off;
+                count++;
+                off = 0;
+            } else {
+                off -= b->prefix_len;
+            }
+            if (off < b->frame.len) {
+                iov[count].iov_base = b->frame.bytes + off;
+                iov[count].iov_len = b->frame.len - off;
+                count++;
+            }
+        }
+        ssize_t n = jzx_net_gather_write(conn, iov, count);
+        net->stats.writev_calls++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                conn->want_write = 1;
+                jzx_net_conn_update_watch(conn);
+                return 0;
+            }
+            return errno;
+        }
+        net->stats.bytes_out += (uint64_t)n;
+        size_t left = (size_t)n;
+        while (conn->wq_head) {
+            jzx_net_block* b = conn->wq_head;
+            size_t remaining = b->prefix_len + b->frame.len - b->off;
+            if (left < remaining) {
+                b->off += left;
+                break;
+            }
+            left -= remaining;
+            conn->wq_head = b->next;
+            jzx_net_block_put(net, b);
+        }
+        if (!conn->wq_head) {
+            conn->wq_tail = NULL;
+        }
+    }
+    if (conn->want_write) {
+        conn->want_write = 0;
+        jzx_net_conn_update_watch(conn);
+    }
+    return 0;
+}
+
+// Returns 0 or an errno from an inline flush.
+static int jzx_net_conn_enqueue(jzx_net_conn* conn, jzx_net_block* block) {
+    if (conn->opts.framing == JZX_NET_FRAME_LEN32) {
+        uint32_t len = (uint32_t)block->frame.len;
+        block->prefix[0] = (uint8_t)(len >> 24);
+        block->prefix[1] = (uint8_t)(len >> 16);
+        block->prefix[2] = (uint8_t)(len >> 8);
+        block->prefix[3] = (uint8_t)len;
+        block->prefix_len = 4;
+    }
+    block->next = NULL;
+    block->off = 0;
+    if (conn->wq_tail) {
+        conn->wq_tail->next = block;
+    } else {
+        conn->wq_head = block;
+    }
+    conn->wq_tail = block;
+    // One flush per mailbox batch: the FLUSH lands behind writes already queued.
+    // If our own mailbox is full, flush now rather than leave data stranded.
+    if (!conn->flush_pending && !conn->want_write) {
+        if (jzx_send(conn->net->loop, conn->self, NULL, 0, JZX_NET_TAG_FLUSH) != JZX_OK) {
+            return jzx_net_conn_flush(conn);
+        }
+        conn->flush_pending = 1;
+    }
+    return 0;
+}
+
+static jzx_behavior_result jzx_net_conn_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_net_conn* conn = (jzx_net_conn*)ctx->state;
+    jzx_net* net = conn->net;
+    int error = 0;
+    if (conn->finished) {
+        if (msg->tag == JZX_NET_TAG_WRITE) {
+            jzx_net_block_put(net, (jzx_net_block*)msg->data);
+        } else if (msg->tag == JZX_TAG_SYS_IO) {
+            jzx_loop_free(net->loop, msg->data);
+        }
+        return jzx_net_conn_linger(conn);
+    }
+    switch (msg->tag) {
+    case JZX_TAG_SYS_IO: {
+        jzx_io_event* ev = (jzx_io_event*)msg->data;
+        uint32_t readiness = ev ? ev->readiness : 0;
+        jzx_loop_free(net->loop, ev);
+        if ((readiness & JZX_IO_WRITE) && conn->want_write) {
+            error = jzx_net_conn_flush(conn);
+        }
+        if (!error && (readiness & JZX_IO_READ) && !conn->paused && !conn->closing) {
+            error = jzx_net_conn_read(conn);
+        }
+        break;
+    }
+    case JZX_NET_TAG_WRITE: {
+        jzx_net_block* block = (jzx_net_block*)msg->data;
+        if (conn->closing) {
+            jzx_net_block_put(net, block);
+        } else {
+            error = jzx_net_conn_enqueue(conn, block);
+        }
+        break;
+    }
+    case JZX_NET_TAG_FLUSH:
+        conn->flush_pending = 0;
+        if (!conn->want_write) {
+            error = jzx_net_conn_flush(conn);
+        }
+        break;
+    case JZX_NET_TAG_RESUME: {
+        conn->resume_pending = 0;
+        if (conn->stalled) {
+            jzx_net_block* block = conn->stalled;
+            conn->stalled = NULL;
+            int rc = jzx_net_conn_deliver(conn, block);
+            if (rc < 0) {
+                error = EPIPE;
+                break;
+            }
+            if (rc > 0) {
+                break;
+            }
+        }
+        if (conn->rlen > 0 && jzx_net_conn_parse(conn, &error) < 0) {
+            break;
+        }
+        if (conn->stalled) {
+            break;
+        }
+        uint32_t resume = conn->opts.resume_depth;
+        if (jzx_net_owner_backlogged(conn, resume + 1u)) {
+            jzx_net_conn_schedule_resume(conn);
+        } else if (conn->paused) {
+            conn->paused = 0;
+            jzx_net_conn_update_watch(conn);
+        }
+        break;
+    }
+    case JZX_NET_TAG_CLOSE:
+        conn->closing = 1;
+        jzx_net_conn_update_watch(conn);
+        break;
+    default:
+        break;
+    }
+    if (error) {
+        return jzx_net_conn_finish(conn, error < 0 ? 0 : error);
+    }
+    if (conn->closing && !conn->wq_head) {
+        return jzx_net_conn_finish(conn, 0);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static jzx_err jzx_net_conn_spawn(jzx_net* net,
+                                  int fd,
+                                  jzx_actor_id owner,
+                                  const jzx_net_conn_opts* opts,
+                                  jzx_net_conn** out_conn) {
+    if (jzx_net_set_nonblock(fd) != 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_net_conn* conn = (jzx_net_conn*)jzx_loop_alloc(net->loop, sizeof(jzx_net_conn));
+    if (!conn) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(conn, 0, sizeof(*conn));
+    conn->net = net;
+    conn->fd = fd;
+    conn->owner = owner;
+    if (opts) {
+        conn->opts = *opts;
+    }
+    if (conn->opts.max_frame == 0) {
+        conn->opts.max_frame = 1u << 20;
+    }
+    if (conn->opts.pause_depth && conn->opts.resume_depth == 0) {
+        conn->opts.resume_depth = conn->opts.pause_depth / 2;
+    }
+    int type = 0;
+    socklen_t type_len = sizeof(type);
+    conn->is_socket = getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &type_len) == 0;
+
+    jzx_spawn_opts spawn = {
+        .behavior = jzx_net_conn_behavior,
+        .state = conn,
+    };
+    jzx_err err = jzx_spawn(net->loop, &spawn, &conn->self);
+    if (err != JZX_OK) {
+        jzx_loop_free(net->loop, conn);
+        return err;
+    }
+    *out_conn = conn;
+    return JZX_OK;
+}
+
+static void jzx_net_conn_start(jzx_net_conn* conn) {
+    jzx_net_conn_update_watch(conn);
+    jzx_net_notify(conn, JZX_TAG_NET_OPEN, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Acceptor actor
+// -----------------------------------------------------------------------------
+
+static void jzx_net_accept_one(jzx_net_acceptor* acc, int fd) {
+    jzx_net* net = acc->net;
+    jzx_net_conn* conn = NULL;
+    if (jzx_net_conn_spawn(net, fd, 0, &acc->opts.conn, &conn) != JZX_OK) {
+        close(fd);
+        return;
+    }
+    net->stats.accepted++;
+    jzx_actor_id owner = acc->opts.on_accept
+                             ? acc->opts.on_accept(acc->opts.accept_ctx, net->loop, conn->self)
+                             : 0;
+    if (!owner) {
+        (void)jzx_send(net->loop, conn->self, NULL, 0, JZX_NET_TAG_CLOSE);
+        return;
+    }
+    conn->owner = owner;
+    jzx_net_conn_start(conn);
+}
+
+static jzx_behavior_result jzx_net_acceptor_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_net_acceptor* acc = (jzx_net_acceptor*)ctx->state;
+    jzx_net* net = acc->net;
+    if (msg->tag == JZX_TAG_SYS_IO) {
+        jzx_loop_free(net->loop, msg->data);
+        for (int i = 0; i < JZX_NET_ACCEPTS_PER_EVENT; ++i) {
+            int fd = accept(acc->fd, NULL, NULL);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                break;
+            }
+            jzx_net_accept_one(acc, fd);
+        }
+        return JZX_BEHAVIOR_OK;
+    }
+    if (msg->tag == JZX_NET_TAG_WRITE) {
+        jzx_net_block_put(net, (jzx_net_block*)msg->data);
+        return JZX_BEHAVIOR_OK;
+    }
+    if (msg->tag == JZX_NET_TAG_CLOSE) {
+        (void)jzx_unwatch_fd(net->loop, acc->fd);
+        close(acc->fd);
+        jzx_loop_free(net->loop, acc);
+        return JZX_BEHAVIOR_STOP;
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Streaming transfers
+// -----------------------------------------------------------------------------
+
+typedef enum {
+    JZX_NET_XFER_SENDFILE, // regular file -> anything
+    JZX_NET_XFER_SPLICE,   // either side is a pipe
+    JZX_NET_XFER_RELAY,    // splice through an internal pipe
+    JZX_NET_XFER_COPY,     // portable read/write through a pooled block
+} jzx_net_xfer_mode;
+
+typedef struct {
+    jzx_net* net;
+    jzx_actor_id self;
+    jzx_net_xfer_opts opts;
+    jzx_net_xfer_mode mode;
+    uint8_t in_is_file;
+    uint64_t off;
+    uint64_t sent;
+    uint64_t total;
+    uint64_t next_progress;
+    // RELAY: internal pipe; COPY: buf. staged bytes are read but not written.
+    int pipe_fds[2];
+    jzx_net_block* buf;
+    size_t staged;
+    size_t staged_off;
+    int wait_fd;
+    // The callers' file status flags from before O_NONBLOCK was set; -1 when
+    // the fd was left alone. Put back when the transfer ends.
+    int in_flags;
+    int out_flags;
+} jzx_net_xfer;
+
+enum {
+    JZX_NET_XFER_WAITING = 0,
+    JZX_NET_XFER_DONE = 1,
+    JZX_NET_XFER_YIELD = 2,
+};
+
+static void jzx_net_xfer_event_send(jzx_net_xfer* x, uint32_t tag, int error) {
+    jzx_loop* loop = x->net->loop;
+    jzx_net_xfer_event* ev = (jzx_net_xfer_event*)jzx_loop_alloc(loop, sizeof(jzx_net_xfer_event));
+    if (!ev) {
+        return;
+    }
+    ev->xfer = x->self;
+    ev->sent = x->sent;
+    ev->total = x->total;
+    ev->error = error;
+    if (jzx_send(loop, x->opts.owner, ev, sizeof(*ev), tag) != JZX_OK) {
+        jzx_loop_free(loop, ev);
+    }
+}
+
+static void jzx_net_xfer_wait(jzx_net_xfer* x, int fd, uint32_t interest) {
+    jzx_loop* loop = x->net->loop;
+    if (x->wait_fd == fd) {
+        return;
+    }
+    if (x->wait_fd >= 0) {
+        (void)jzx_unwatch_fd(loop, x->wait_fd);
+    }
+    x->wait_fd = jzx_watch_fd(loop, fd, x->self, interest | JZX_IO_COALESCE) == JZX_OK ? fd : -1;
+}
+
+// Splice reported EAGAIN without saying which end blocked; ask poll.
+static void jzx_net_xfer_wait_blocked_side(jzx_net_xfer* x) {
+    struct pollfd pfd = {.fd = x->opts.out_fd, .events = POLLOUT, .revents = 0};
+    if (poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLOUT)) {
+        jzx_net_xfer_wait(x, x->opts.in_fd, JZX_IO_READ);
+    } else {
+        jzx_net_xfer_wait(x, x->opts.out_fd, JZX_IO_WRITE);
+    }
+}
+
+static void jzx_net_xfer_advance(jzx_net_xfer* x, size_t n) {
+    x->sent += n;
+    x->net->stats.bytes_transferred += n;
+    if (x->opts.progress_every && x->sent >= x->next_progress) {
+        jzx_net_xfer_event_send(x, JZX_TAG_NET_XFER_PROGRESS, 0);
+        x->next_progress = (x->sent / x->opts.progress_every + 1) * x->opts.progress_every;
+    }
+}
+
+// Moves staged bytes (RELAY/COPY) to out_fd. Returns 1 when drained, 0 when
+// out_fd would block, or -errno.
+static int jzx_net_xfer_drain(jzx_net_xfer* x) {
+    while (x->staged > 0) {
+        ssize_t n;
+#ifdef __linux__
+        if (x->mode == JZX_NET_XFER_RELAY) {
+            n = splice(x->pipe_fds[0], NULL, x->opts.out_fd, NULL, x->staged,
+                       SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+        } else
+#endif
+        {
+            n = write(x->opts.out_fd, x->buf->data + x->staged_off, x->staged);
+        }
+        if (n > 0) {
+            x->staged -= (size_t)n;
+            x->staged_off += (size_t)n;
+            jzx_net_xfer_advance(x, (size_t)n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            jzx_net_xfer_wait(x, x->opts.out_fd, JZX_IO_WRITE);
+            return 0;
+        }
+        return n < 0 ? -errno : -EPIPE;
+    }
+    return 1;
+}
+
+// Returns JZX_NET_XFER_WAITING (a watch is armed), _DONE, _YIELD (budget
+// used up; continue via a self message) or -errno.
+static int jzx_net_xfer_pump(jzx_net_xfer* x) {
+    for (int i = 0; i < JZX_NET_XFER_CALLS_PER_EVENT; ++i) {
+        size_t want = x->opts.chunk;
+        if (x->total) {
+            uint64_t remaining = x->total - x->sent;
+            if (remaining == 0 && x->staged == 0) {
+                return JZX_NET_XFER_DONE;
+            }
+            if (remaining < want) {
+                want = (size_t)remaining;
+            }
+        }
+        ssize_t n;
+        switch (x->mode) {
+#ifdef __linux__
+        case JZX_NET_XFER_SENDFILE: {
+            off_t off = (off_t)x->off;
+            n = sendfile(x->opts.out_fd, x->opts.in_fd, &off, want);
+            if (n > 0) {
+                x->off = (uint64_t)off;
+                jzx_net_xfer_advance(x, (size_t)n);
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                jzx_net_xfer_wait(x, x->opts.out_fd, JZX_IO_WRITE);
+                return JZX_NET_XFER_WAITING;
+            }
+            break;
+        }
+        case JZX_NET_XFER_SPLICE: {
+            loff_t off = (loff_t)x->off;
+            n = splice(x->opts.in_fd, x->in_is_file ? &off : NULL, x->opts.out_fd, NULL, want,
+                       SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+            if (n > 0) {
+                x->off = (uint64_t)off;
+                jzx_net_xfer_advance(x, (size_t)n);
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                jzx_net_xfer_wait_blocked_side(x);
+                return JZX_NET_XFER_WAITING;
+            }
+            break;
+        }
+#endif
+        default: {
+            if (x->staged == 0) {
+                x->staged_off = 0;
+#ifdef __linux__
+                if (x->mode == JZX_NET_XFER_RELAY) {
+                    loff_t off = (loff_t)x->off;
+                    n = splice(x->opts.in_fd, x->in_is_file ? &off : NULL, x->pipe_fds[1], NULL, want,
+                               SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+                } else
+#endif
+                {
+                    size_t cap = want < x->buf->cap ? want : x->buf->cap;
+                    n = x->in_is_file ? pread(x->opts.in_fd, x->buf->data, cap, (off_t)x->off)
+                                      : read(x->opts.in_fd, x->buf->data, cap);
+                }
+                if (n > 0) {
+                    x->staged = (size_t)n;
+                    x->off += (uint64_t)n;
+                } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    jzx_net_xfer_wait(x, x->opts.in_fd, JZX_IO_READ);
+                    return JZX_NET_XFER_WAITING;
+                } else {
+                    break;
+                }
+            }
+            int rc = jzx_net_xfer_drain(x);
+            if (rc <= 0) {
+                return rc;
+            }
+            continue;
+        }
+        }
+        if (n == 0) {
+            return JZX_NET_XFER_DONE;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return -errno;
+    }
+    return JZX_NET_XFER_YIELD;
+}
+
+// Sets O_NONBLOCK on a caller's fd and returns the flags to restore, or -1.
+static int jzx_net_xfer_borrow_fd(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || ((fl & O_NONBLOCK) == 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0)) {
+        return -1;
+    }
+    return fl;
+}
+
+static void jzx_net_xfer_release(jzx_net_xfer* x) {
+    for (int i = 0; i < 2; ++i) {
+        if (x->pipe_fds[i] >= 0) {
+            close(x->pipe_fds[i]);
+        }
+    }
+    if (x->buf) {
+        jzx_net_block_put(x->net, x->buf);
+    }
+    if (x->in_flags >= 0 && (x->in_flags & O_NONBLOCK) == 0) {
+        (void)fcntl(x->opts.in_fd, F_SETFL, x->in_flags);
+    }
+    if (x->out_flags >= 0 && (x->out_flags & O_NONBLOCK) == 0) {
+        (void)fcntl(x->opts.out_fd, F_SETFL, x->out_flags);
+    }
+}
+
+static jzx_behavior_result jzx_net_xfer_finish(jzx_net_xfer* x, int error) {
+    jzx_loop* loop = x->net->loop;
+    if (x->wait_fd >= 0) {
+        (void)jzx_unwatch_fd(loop, x->wait_fd);
+    }
+    jzx_net_xfer_release(x);
+    jzx_net_xfer_event_send(x, JZX_TAG_NET_XFER_DONE, error);
+    jzx_loop_free(loop, x);
+    return JZX_BEHAVIOR_STOP;
+}
+
+static jzx_behavior_result jzx_net_xfer_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_net_xfer* x = (jzx_net_xfer*)ctx->state;
+    switch (msg->tag) {
+    case JZX_TAG_SYS_IO:
+        jzx_loop_free(x->net->loop, msg->data);
+        break;
+    case JZX_NET_TAG_XFER_CONTINUE:
+        break;
+    case JZX_NET_TAG_XFER_CANCEL:
+        return jzx_net_xfer_finish(x, ECANCELED);
+    default:
+        return JZX_BEHAVIOR_OK;
+    }
+    int rc = jzx_net_xfer_pump(x);
+    if (rc == JZX_NET_XFER_DONE) {
+        return jzx_net_xfer_finish(x, 0);
+    }
+    if (rc < 0) {
+        return jzx_net_xfer_finish(x, -rc);
+    }
+    if (rc == JZX_NET_XFER_YIELD) {
+        // Let other actors run before the next batch of syscalls.
+        (void)jzx_send(x->net->loop, x->self, NULL, 0, JZX_NET_TAG_XFER_CONTINUE);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static jzx_err jzx_net_xfer_setup(jzx_net_xfer* x) {
+    struct stat in_st;
+    struct stat out_st;
+    if (fstat(x->opts.in_fd, &in_st) != 0 || fstat(x->opts.out_fd, &out_st) != 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    x->in_is_file = S_ISREG(in_st.st_mode) ? 1 : 0;
+    x->off = x->in_is_file ? x->opts.offset : 0;
+    x->total = x->opts.length;
+    if (x->in_is_file && x->total == 0) {
+        uint64_t size = (uint64_t)in_st.st_size;
+        // An empty range leaves total at 0; the first sendfile then hits EOF.
+        x->total = size > x->off ? size - x->off : 0;
+    }
+    x->out_flags = jzx_net_xfer_borrow_fd(x->opts.out_fd);
+    if (x->out_flags < 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (!x->in_is_file) {
+        x->in_flags = jzx_net_xfer_borrow_fd(x->opts.in_fd);
+        if (x->in_flags < 0) {
+            return JZX_ERR_INVALID_ARG;
+        }
+    }
+#ifdef __linux__
+    if (x->in_is_file) {
+        x->mode = JZX_NET_XFER_SENDFILE;
+    } else if (S_ISFIFO(in_st.st_mode) || S_ISFIFO(out_st.st_mode)) {
+        x->mode = JZX_NET_XFER_SPLICE;
+    } else {
+        x->mode = JZX_NET_XFER_RELAY;
+        if (pipe2(x->pipe_fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            x->pipe_fds[0] = -1;
+            x->pipe_fds[1] = -1;
+            return JZX_ERR_NO_MEMORY;
+        }
+        // Best effort: a pipe sized to the chunk lets each splice move a full chunk.
+        (void)fcntl(x->pipe_fds[1], F_SETPIPE_SZ, (int)x->opts.chunk);
+    }
+#else
+    x->mode = JZX_NET_XFER_COPY;
+#endif
+    if (x->mode == JZX_NET_XFER_COPY) {
+        x->buf = jzx_net_block_get(x->net, x->net->buffer_size);
+        if (!x->buf) {
+            return JZX_ERR_NO_MEMORY;
+        }
+    }
+    return JZX_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+jzx_net* jzx_net_create(jzx_loop* loop, uint32_t buffer_size, uint32_t pool_max) {
+    if (!loop) {
+        return NULL;
+    }
+    jzx_net* net = (jzx_net*)jzx_loop_alloc(loop, sizeof(jzx_net));
+    if (!net) {
+        return NULL;
+    }
+    memset(net, 0, sizeof(*net));
+    net->loop = loop;
+    net->buffer_size = buffer_size ? buffer_size : 16384;
+    net->pool_max = pool_max ? pool_max : 256;
+    return net;
+}
+
+void jzx_net_destroy(jzx_net* net) {
+    if (!net) {
+        return;
+    }
+    while (net->pool) {
+        jzx_net_block* next = net->pool->next;
+        jzx_loop_free(net->loop, net->pool);
+        net->pool = next;
+    }
+    jzx_loop_free(net->loop, net);
+}
+
+jzx_err jzx_net_listen(jzx_net* net,
+                       int listen_fd,
+                       const jzx_net_listen_opts* opts,
+                       jzx_actor_id* out_acceptor) {
+    if (!net || listen_fd < 0 || !opts || !opts->on_accept) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (jzx_net_set_nonblock(listen_fd) != 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_net_acceptor* acc = (jzx_net_acceptor*)jzx_loop_alloc(net->loop, sizeof(jzx_net_acceptor));
+    if (!acc) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    acc->net = net;
+    acc->fd = listen_fd;
+    acc->opts = *opts;
+    jzx_spawn_opts spawn = {
+        .behavior = jzx_net_acceptor_behavior,
+        .state = acc,
+    };
+    jzx_err err = jzx_spawn(net->loop, &spawn, &acc->self);
+    if (err != JZX_OK) {
+        jzx_loop_free(net->loop, acc);
+        return err;
+    }
+    err = jzx_watch_fd(net->loop, listen_fd, acc->self, JZX_IO_READ | JZX_IO_COALESCE);
+    if (err != JZX_OK) {
+        (void)jzx_actor_stop(net->loop, acc->self);
+        jzx_loop_free(net->loop, acc);
+        return err;
+    }
+    if (out_acceptor) {
+        *out_acceptor = acc->self;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_net_adopt(jzx_net* net,
+                      int fd,
+                      jzx_actor_id owner,
+                      const jzx_net_conn_opts* opts,
+                      jzx_actor_id* out_conn) {
+    if (!net || fd < 0 || owner == 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_net_conn* conn = NULL;
+    jzx_err err = jzx_net_conn_spawn(net, fd, owner, opts, &conn);
+    if (err != JZX_OK) {
+        return err;
+    }
+    jzx_net_conn_start(conn);
+    if (out_conn) {
+        *out_conn = conn->self;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_net_write(jzx_net* net, jzx_actor_id conn, const void* data, size_t len) {
+    if (!net || (!data && len > 0) || len > UINT32_MAX) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_net_block* block = jzx_net_block_get(net, len ? len : 1);
+    if (!block) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    if (len) {
+        memcpy(block->data, data, len);
+    }
+    block->frame.bytes = block->data;
+    block->frame.len = len;
+    jzx_err err = jzx_send(net->loop, conn, block, sizeof(jzx_net_block), JZX_NET_TAG_WRITE);
+    if (err != JZX_OK) {
+        jzx_net_block_put(net, block);
+    }
+    return err;
+}
+
+jzx_err jzx_net_close(jzx_net* net, jzx_actor_id actor) {
+    if (!net) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_send(net->loop, actor, NULL, 0, JZX_NET_TAG_CLOSE);
+}
+
+void jzx_net_frame_release(jzx_net* net, jzx_net_frame* frame) {
+    if (!net || !frame) {
+        return;
+    }
+    jzx_net_block_put(net, (jzx_net_block*)frame);
+}
+
+jzx_err jzx_net_get_stats(jzx_net* net, jzx_net_stats* out) {
+    if (!net || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    *out = net->stats;
+    return JZX_OK;
+}
+
+jzx_err jzx_net_transfer(jzx_net* net, const jzx_net_xfer_opts* opts, jzx_actor_id* out_xfer) {
+    if (!net || !opts || opts->in_fd < 0 || opts->out_fd < 0 || opts->owner == 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_net_xfer* x = (jzx_net_xfer*)jzx_loop_alloc(net->loop, sizeof(jzx_net_xfer));
+    if (!x) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(x, 0, sizeof(*x));
+    x->net = net;
+    x->opts = *opts;
+    if (x->opts.chunk == 0) {
+        x->opts.chunk = 1u << 20;
+    }
+    x->pipe_fds[0] = -1;
+    x->pipe_fds[1] = -1;
+    x->wait_fd = -1;
+    x->in_flags = -1;
+    x->out_flags = -1;
+    x->next_progress = x->opts.progress_every;
+    jzx_err err = jzx_net_xfer_setup(x);
+    if (err == JZX_OK) {
+        jzx_spawn_opts spawn = {
+            .behavior = jzx_net_xfer_behavior,
+            .state = x,
+        };
+        err = jzx_spawn(net->loop, &spawn, &x->self);
+    }
+    if (err != JZX_OK) {
+        jzx_net_xfer_release(x);
+        jzx_loop_free(net->loop, x);
+        return err;
+    }
+    (void)jzx_send(net->loop, x->self, NULL, 0, JZX_NET_TAG_XFER_CONTINUE);
+    if (out_xfer) {
+        *out_xfer = x->self;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_net_transfer_cancel(jzx_net* net, jzx_actor_id xfer) {
+    if (!net) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_send(net->loop, xfer, NULL, 0, JZX_NET_TAG_XFER_CANCEL);
+}
@@ -0,0 +1,890 @@
+#include "jzx/node.h"
+#include "jzx_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define JZX_NODE_TAG_FLUSH  0xffff0510u
+#define JZX_NODE_TAG_RESUME 0xffff0511u
+// Wire-only: the first frame on a connection; target carries the magic and
+// sender the node number.
+#define JZX_NODE_TAG_HELLO  0xffff0512u
+// Wire-only: the next frame was sent with a deadline, carried in sender.
+// target is 0, which no routed frame can have.
+#define JZX_NODE_TAG_DEADLINE 0xffff0513u
+#define JZX_NODE_MAGIC 0x314544304e585a4aull // "JZXN0DE1"
+
+#define JZX_NODE_IOV_BATCH 64
+#define JZX_NODE_READS_PER_EVENT 4
+#define JZX_NODE_ACCEPTS_PER_EVENT 16
+#define JZX_NODE_RESUME_POLL_MS 1
+#define JZX_NODE_DEFAULT_BATCH (64u * 1024u)
+#define JZX_NODE_DEFAULT_QUEUED (8u * 1024u * 1024u)
+#define JZX_NODE_DEFAULT_FRAME (1u << 20)
+#define JZX_NODE_READ_BUF (64u * 1024u)
+
+// Frame header, native byte order, followed by len payload bytes.
+typedef struct {
+    uint32_t len;
+    uint32_t tag;
+    uint64_t target;
+    uint64_t sender;
+} jzx_node_frame;
+
+_Static_assert(sizeof(jzx_node_frame) == 24, "node frame header must stay 24 bytes");
+
+// Outgoing frames are packed back to back into blocks of batch_bytes (or one
+// frame's size, if larger). data[off, len) is still unsent.
+typedef struct jzx_node_block {
+    struct jzx_node_block* next;
+    size_t cap;
+    size_t len;
+    size_t off;
+    uint8_t data[];
+} jzx_node_block;
+
+typedef struct jzx_node_peer {
+    jzx_node_table* table;
+    jzx_actor_id self;
+    int fd;
+    uint32_t node; // 0 until the peer's hello arrives
+    uint32_t interest;
+    uint8_t flush_pending;
+    uint8_t want_write;
+    uint8_t paused;
+    uint8_t resume_pending;
+    // The local actor whose full mailbox paused delivery, 0 if none.
+    jzx_actor_id full_target;
+    // Deadline announced for the next incoming frame, 0 if none.
+    uint64_t rx_deadline_ms;
+    jzx_node_block* wq_head;
+    jzx_node_block* wq_tail;
+    size_t queued;
+    // rbuf[rpos, rlen) is read but not yet delivered.
+    uint8_t* rbuf;
+    size_t rpos;
+    size_t rlen;
+    size_t rcap;
+    struct jzx_node_peer* next;
+} jzx_node_peer;
+
+typedef struct {
+    uint32_t node; // 0 = any
+    jzx_node_monitor_mode mode;
+    jzx_actor_id actor;
+} jzx_node_monitor_entry;
+
+struct jzx_node_table {
+    jzx_loop* loop;
+    jzx_node_opts opts;
+    char* unix_path; // copy, unlinked on stop
+    int listen_fd;
+    jzx_actor_id listener;
+    // Handshaken peers by node number.
+    jzx_node_peer* routes[JZX_NODE_MAX + 1];
+    // Every connection, handshaken or not.
+    jzx_node_peer* peers;
+    // One drained batch block kept for reuse.
+    jzx_node_block* spare;
+    jzx_node_monitor_entry* monitors;
+    uint32_t monitor_count;
+    uint32_t monitor_cap;
+    jzx_node_stats stats;
+};
+
+static int jzx_node_set_nonblock(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    int fdfl = fcntl(fd, F_GETFD);
+    if (fdfl >= 0) {
+        (void)fcntl(fd, F_SETFD, fdfl | FD_CLOEXEC);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Monitors and notifications
+// -----------------------------------------------------------------------------
+
+static void jzx_node_event_send(jzx_node_table* t, jzx_actor_id to, uint32_t tag, uint32_t node, int error) {
+    jzx_node_event* ev = (jzx_node_event*)jzx_loop_alloc(t->loop, sizeof(jzx_node_event));
+    if (!ev) {
+        return;
+    }
+    ev->node = node;
+    ev->error = error;
+    if (jzx_send(t->loop, to, ev, sizeof(jzx_node_event), tag) != JZX_OK) {
+        jzx_loop_free(t->loop, ev);
+    }
+}
+
+static void jzx_node_fire(jzx_node_table* t, const jzx_node_monitor_entry* m, uint32_t node, int error) {
+    if (m->mode == JZX_NODE_FAIL) {
+        (void)jzx_actor_fail(t->loop, m->actor);
+    } else {
+        jzx_node_event_send(t, m->actor, JZX_TAG_NODE_DOWN, node, error);
+    }
+}
+
+static void jzx_node_down(jzx_node_table* t, uint32_t node, int error) {
+    if (t->opts.owner) {
+        jzx_node_event_send(t, t->opts.owner, JZX_TAG_NODE_DOWN, node, error);
+    }
+    uint32_t i = 0;
+    while (i < t->monitor_count) {
+        jzx_node_monitor_entry m = t->monitors[i];
+        if (m.node != 0 && m.node != node) {
+            ++i;
+            continue;
+        }
+        t->monitors[i] = t->monitors[--t->monitor_count];
+        jzx_node_fire(t, &m, node, error);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Peer connection actor
+// -----------------------------------------------------------------------------
+
+static void jzx_node_peer_update_watch(jzx_node_peer* peer) {
+    jzx_loop* loop = peer->table->loop;
+    uint32_t interest = 0;
+    if (!peer->paused) {
+        interest |= JZX_IO_READ;
+    }
+    if (peer->want_write) {
+        interest |= JZX_IO_WRITE;
+    }
+    if (interest == peer->interest) {
+        return;
+    }
+    if (interest == 0) {
+        (void)jzx_unwatch_fd(loop, peer->fd);
+    } else if (jzx_watch_fd(loop, peer->fd, peer->self, interest | JZX_IO_COALESCE) != JZX_OK) {
+        return;
+    }
+    peer->interest = interest;
+}
+
+static void jzx_node_block_put(jzx_node_table* t, jzx_node_block* b) {
+    if (!t->spare && b->cap == t->opts.batch_bytes) {
+        t->spare = b;
+        return;
+    }
+    jzx_loop_free(t->loop, b);
+}
+
+static jzx_node_block* jzx_node_block_get(jzx_node_table* t, size_t need) {
+    jzx_node_block* b = NULL;
+    if (need <= t->opts.batch_bytes && t->spare) {
+        b = t->spare;
+        t->spare = NULL;
+    } else {
+        size_t cap = need > t->opts.batch_bytes ? need : t->opts.batch_bytes;
+        b = (jzx_node_block*)jzx_loop_alloc(t->loop, sizeof(jzx_node_block) + cap);
+        if (!b) {
+            return NULL;
+        }
+        b->cap = cap;
+    }
+    b->next = NULL;
+    b->len = 0;
+    b->off = 0;
+    return b;
+}
+
+// Writes as much of the queue as the socket takes. Returns 0 or an errno.
+static int jzx_node_peer_flush(jzx_node_peer* peer) {
+    jzx_node_table* t = peer->table;
+    while (peer->wq_head) {
+        struct iovec iov[JZX_NODE_IOV_BATCH];
+        int count = 0;
+        for (jzx_node_block* b = peer->wq_head; b && count < JZX_NODE_IOV_BATCH; b = b->next) {
+            iov[count].iov_base = b->data + b->off;
+            iov[count].iov_len = b->len - b->off;
+            count++;
+        }
+        ssize_t n;
+#ifdef MSG_NOSIGNAL
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = iov;
+        mh.msg_iovlen = (size_t)count;
+        n = sendmsg(peer->fd, &mh, MSG_NOSIGNAL);
+#else
+        n = writev(peer->fd, iov, count);
+#endif
+        t->stats.writev_calls++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                peer->want_write = 1;
+                jzx_node_peer_update_watch(peer);
+                return 0;
+            }
+            return errno;
+        }
+        t->stats.bytes_out += (uint64_t)n;
+        peer->queued -= (size_t)n;
+        size_t left = (size_t)n;
+        while (peer->wq_head) {
+            jzx_node_block* b = peer->wq_head;
+            size_t remaining = b->len - b->off;
+            if (left < remaining) {
+                b->off += left;
+                break;
+            }
+            left -= remaining;
+            peer->wq_head = b->next;
+            jzx_node_block_put(t, b);
+        }
+        if (!peer->wq_head) {
+            peer->wq_tail = NULL;
+        }
+    }
+    if (peer->want_write) {
+        peer->want_write = 0;
+        jzx_node_peer_update_watch(peer);
+    }
+    return 0;
+}
+
+// Appends one frame to the peer's outgoing batch, preceded by a DEADLINE
+// frame if deadline_ms is set; both land in the same block or neither does.
+// The FLUSH lands behind whatever is already in the peer actor's mailbox, so
+// every frame queued until it runs goes out in the same writev.
+static jzx_err jzx_node_peer_queue(jzx_node_peer* peer,
+                                   uint32_t tag,
+                                   uint64_t target,
+                                   uint64_t sender,
+                                   const void* data,
+                                   size_t len,
+                                   uint64_t deadline_ms) {
+    jzx_node_table* t = peer->table;
+    size_t prefix = deadline_ms ? sizeof(jzx_node_frame) : 0;
+    size_t need = prefix + sizeof(jzx_node_frame) + len;
+    if (peer->queued + need > t->opts.max_queued) {
+        t->stats.send_full++;
+        return JZX_ERR_OVERLOADED;
+    }
+    jzx_node_block* b = peer->wq_tail;
+    if (!b || b->cap - b->len < need) {
+        b = jzx_node_block_get(t, need);
+        if (!b) {
+            return JZX_ERR_NO_MEMORY;
+        }
+        if (peer->wq_tail) {
+            peer->wq_tail->next = b;
+        } else {
+            peer->wq_head = b;
+        }
+        peer->wq_tail = b;
+    }
+    uint8_t* out = b->data + b->len;
+    if (prefix) {
+        jzx_node_frame pre = {.len = 0, .tag = JZX_NODE_TAG_DEADLINE, .target = 0, .sender = deadline_ms};
+        memcpy(out, &pre, sizeof(pre));
+        out += prefix;
+    }
+    jzx_node_frame hdr = {.len = (uint32_t)len, .tag = tag, .target = target, .sender = sender};
+    memcpy(out, &hdr, sizeof(hdr));
+    if (len) {
+        memcpy(out + sizeof(hdr), data, len);
+    }
+    b->len += need;
+    peer->queued += need;
+    if (!peer->flush_pending && !peer->want_write) {
+        if (jzx_send(t->loop, peer->self, NULL, 0, JZX_NODE_TAG_FLUSH) == JZX_OK) {
+            peer->flush_pending = 1;
+        } else {
+            // Our own mailbox is full: write now rather than strand the
+            // frame. A failed write shows up again at the next read.
+            (void)jzx_node_peer_flush(peer);
+        }
+    }
+    return JZX_OK;
+}
+
+static void jzx_node_peer_unlink(jzx_node_table* t, jzx_node_peer* peer) {
+    for (jzx_node_peer** p = &t->peers; *p; p = &(*p)->next) {
+        if (*p == peer) {
+            *p = peer->next;
+            return;
+        }
+    }
+}
+
+// Closes the connection and frees the peer; the caller stops its actor.
+static void jzx_node_peer_teardown(jzx_node_peer* peer, int error, int notify) {
+    jzx_node_table* t = peer->table;
+    if (peer->interest) {
+        (void)jzx_unwatch_fd(t->loop, peer->fd);
+    }
+    close(peer->fd);
+    while (peer->wq_head) {
+        jzx_node_block* next = peer->wq_head->next;
+        jzx_node_block_put(t, peer->wq_head);
+        peer->wq_head = next;
+    }
+    t->stats.unsent_bytes += peer->queued;
+    if (peer->rbuf) {
+        jzx_loop_free(t->loop, peer->rbuf);
+    }
+    jzx_node_peer_unlink(t, peer);
+    uint32_t node = peer->node;
+    if (node && t->routes[node] == peer) {
+        t->routes[node] = NULL;
+        t->stats.peers--;
+        if (notify) {
+            jzx_node_down(t, node, error);
+        }
+    }
+    jzx_loop_free(t->loop, peer);
+}
+
+// Resumes once the full mailbox is half drained (or its actor is gone). A
+// pause on a memory limit has nothing to watch and polls instead.
+static void jzx_node_peer_schedule_resume(jzx_node_peer* peer) {
+    if (peer->resume_pending) {
+        return;
+    }
+    jzx_loop* loop = peer->table->loop;
+    if (peer->full_target &&
+        jzx_watch_mailbox(loop, peer->full_target, UINT32_MAX, peer->self, JZX_NODE_TAG_RESUME) == JZX_OK) {
+        peer->resume_pending = 1;
+        return;
+    }
+    if (jzx_send_after(loop, peer->self, JZX_NODE_RESUME_POLL_MS, NULL, 0, JZX_NODE_TAG_RESUME, NULL) ==
+        JZX_OK) {
+        peer->resume_pending = 1;
+    }
+}
+
+// Returns 0 or an errno value that should close the connection.
+static int jzx_node_peer_hello(jzx_node_peer* peer, const jzx_node_frame* hdr) {
+    jzx_node_table* t = peer->table;
+    uint64_t node = hdr->sender;
+    if (hdr->tag != JZX_NODE_TAG_HELLO || hdr->target != JZX_NODE_MAGIC || hdr->len != 0) {
+        return EPROTO;
+    }
+    if (node == 0 || node > JZX_NODE_MAX || node == t->opts.node_id) {
+        return EPROTO;
+    }
+    if (t->routes[node]) {
+        return EEXIST;
+    }
+    peer->node = (uint32_t)node;
+    t->routes[node] = peer;
+    t->stats.peers++;
+    if (t->opts.owner) {
+        jzx_node_event_send(t, t->opts.owner, JZX_TAG_NODE_UP, peer->node, 0);
+    }
+    return 0;
+}
+
+// Delivers complete frames from rbuf. Returns 0 to keep reading, 1 if a full
+// mailbox paused delivery, or an errno value.
+static int jzx_node_peer_parse(jzx_node_peer* peer) {
+    jzx_node_table* t = peer->table;
+    jzx_loop* loop = t->loop;
+    int rc = 0;
+    while (peer->rlen - peer->rpos >= sizeof(jzx_node_frame)) {
+        jzx_node_frame hdr;
+        memcpy(&hdr, peer->rbuf + peer->rpos, sizeof(hdr));
+        if (hdr.len > t->opts.max_frame) {
+            return EMSGSIZE;
+        }
+        size_t size = sizeof(hdr) + hdr.len;
+        if (peer->rlen - peer->rpos < size) {
+            break;
+        }
+        if (!peer->node) {
+            int err = jzx_node_peer_hello(peer, &hdr);
+            if (err) {
+                return err;
+            }
+            peer->rpos += size;
+            continue;
+        }
+        if (hdr.tag == JZX_NODE_TAG_DEADLINE && hdr.target == 0) {
+            if (hdr.len != 0) {
+                return EPROTO;
+            }
+            peer->rx_deadline_ms = hdr.sender;
+            peer->rpos += size;
+            continue;
+        }
+        uint64_t deadline_ms = peer->rx_deadline_ms;
+        uint32_t node = jzx_actor_node(hdr.target);
+        if (node && node != t->opts.node_id) {
+            // Not ours to forward.
+            t->stats.dropped++;
+            peer->rx_deadline_ms = 0;
+            peer->rpos += size;
+            continue;
+        }
+        void* copy = NULL;
+        if (hdr.len) {
+            copy = jzx_loop_alloc(loop, hdr.len);
+            if (!copy) {
+                return ENOMEM;
+            }
+            memcpy(copy, peer->rbuf + peer->rpos + sizeof(hdr), hdr.len);
+        }
+        jzx_actor_id local = jzx_node_actor(0, hdr.target);
+        jzx_err err = jzx_send_from(loop, local, copy, hdr.len, hdr.tag, hdr.sender, deadline_ms);
+        if (err == JZX_ERR_MAILBOX_FULL || err == JZX_ERR_MEMORY_LIMIT) {
+            // The frame stays in rbuf, its deadline in rx_deadline_ms.
+            jzx_loop_free(loop, copy);
+            peer->full_target = err == JZX_ERR_MAILBOX_FULL ? local : 0;
+            rc = 1;
+            break;
+        }
+        peer->rx_deadline_ms = 0;
+        if (err == JZX_OK) {
+            t->stats.frames_in++;
+        } else {
+            jzx_loop_free(loop, copy);
+            t->stats.dropped++;
+        }
+        peer->rpos += size;
+    }
+    if (peer->rpos) {
+        memmove(peer->rbuf, peer->rbuf + peer->rpos, peer->rlen - peer->rpos);
+        peer->rlen -= peer->rpos;
+        peer->rpos = 0;
+    }
+    if (rc == 1 && !peer->paused) {
+        peer->paused = 1;
+        jzx_node_peer_update_watch(peer);
+        jzx_node_peer_schedule_resume(peer);
+    }
+    return rc;
+}
+
+// Makes room for the next read: at least the rest of a partial frame.
+static int jzx_node_peer_reserve(jzx_node_peer* peer) {
+    size_t want = peer->rcap ? peer->rcap : JZX_NODE_READ_BUF;
+    if (peer->rlen >= sizeof(jzx_node_frame)) {
+        jzx_node_frame hdr;
+        memcpy(&hdr, peer->rbuf, sizeof(hdr));
+        if (sizeof(hdr) + hdr.len > want) {
+            want = sizeof(hdr) + hdr.len;
+        }
+    }
+    if (want <= peer->rcap) {
+        return 0;
+    }
+    uint8_t* buf = (uint8_t*)jzx_loop_alloc(peer->table->loop, want);
+    if (!buf) {
+        return -1;
+    }
+    if (peer->rlen) {
+        memcpy(buf, peer->rbuf, peer->rlen);
+    }
+    if (peer->rbuf) {
+        jzx_loop_free(peer->table->loop, peer->rbuf);
+    }
+    peer->rbuf = buf;
+    peer->rcap = want;
+    return 0;
+}
+
+// Reads until EAGAIN, a pause or JZX_NODE_READS_PER_EVENT reads. Returns 0 or
+// an errno value (-1 for orderly EOF) that should close the connection.
+static int jzx_node_peer_read(jzx_node_peer* peer) {
+    jzx_node_table* t = peer->table;
+    for (int i = 0; i < JZX_NODE_READS_PER_EVENT && !peer->paused; ++i) {
+        if (jzx_node_peer_reserve(peer) != 0) {
+            return ENOMEM;
+        }
+        ssize_t n = read(peer->fd, peer->rbuf + peer->rlen, peer->rcap - peer->rlen);
+        if (n > 0) {
+            t->stats.bytes_in += (uint64_t)n;
+            peer->rlen += (size_t)n;
+            int rc = jzx_node_peer_parse(peer);
+            if (rc > 1) {
+                return rc;
+            }
+            continue;
+        }
+        if (n == 0) {
+            return -1;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        return errno;
+    }
+    return 0;
+}
+
+static jzx_behavior_result jzx_node_peer_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_node_peer* peer = (jzx_node_peer*)ctx->state;
+    jzx_node_table* t = peer->table;
+    int error = 0;
+    switch (msg->tag) {
+    case JZX_NODE_TAG_FLUSH:
+        peer->flush_pending = 0;
+        if (!peer->want_write) {
+            error = jzx_node_peer_flush(peer);
+        }
+        break;
+    case JZX_NODE_TAG_RESUME:
+        peer->resume_pending = 0;
+        peer->paused = 0;
+        error = jzx_node_peer_parse(peer);
+        if (error == 0) {
+            jzx_node_peer_update_watch(peer);
+            error = jzx_node_peer_read(peer);
+        } else if (error == 1) {
+            error = 0;
+        }
+        break;
+    case JZX_TAG_SYS_IO: {
+        jzx_io_event* ev = (jzx_io_event*)msg->data;
+        uint32_t readiness = ev ? ev->readiness : 0;
+        jzx_loop_free(t->loop, ev);
+        if ((readiness & JZX_IO_WRITE) && peer->want_write) {
+            peer->want_write = 0;
+            error = jzx_node_peer_flush(peer);
+        }
+        if (!error && !peer->paused) {
+            error = jzx_node_peer_read(peer);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    if (error) {
+        jzx_node_peer_teardown(peer, error < 0 ? 0 : error, 1);
+        return JZX_BEHAVIOR_STOP;
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+// Takes ownership of fd, even on failure.
+static jzx_err jzx_node_peer_start(jzx_node_table* t, int fd) {
+    if (jzx_node_set_nonblock(fd) != 0) {
+        close(fd);
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    jzx_node_peer* peer = (jzx_node_peer*)jzx_loop_alloc(t->loop, sizeof(jzx_node_peer));
+    if (!peer) {
+        close(fd);
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(peer, 0, sizeof(*peer));
+    peer->table = t;
+    peer->fd = fd;
+    jzx_spawn_opts spawn = {.behavior = jzx_node_peer_behavior, .state = peer};
+    jzx_err err = jzx_spawn(t->loop, &spawn, &peer->self);
+    if (err != JZX_OK) {
+        close(fd);
+        jzx_loop_free(t->loop, peer);
+        return err;
+    }
+    peer->next = t->peers;
+    t->peers = peer;
+    err = jzx_node_peer_queue(peer, JZX_NODE_TAG_HELLO, JZX_NODE_MAGIC, t->opts.node_id, NULL, 0, 0);
+    if (err == JZX_OK) {
+        jzx_node_peer_update_watch(peer);
+        if (!peer->interest) {
+            err = JZX_ERR_IO_REG_FAILED;
+        }
+    }
+    if (err != JZX_OK) {
+        jzx_actor_id self = peer->self;
+        jzx_node_peer_teardown(peer, 0, 0);
+        (void)jzx_actor_stop(t->loop, self);
+    }
+    return err;
+}
+
+// -----------------------------------------------------------------------------
+// Listener actor
+// -----------------------------------------------------------------------------
+
+static jzx_behavior_result jzx_node_listener_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_node_table* t = (jzx_node_table*)ctx->state;
+    if (msg->tag != JZX_TAG_SYS_IO) {
+        return JZX_BEHAVIOR_OK;
+    }
+    jzx_loop_free(t->loop, msg->data);
+    for (int i = 0; i < JZX_NODE_ACCEPTS_PER_EVENT; ++i) {
+        int fd = accept(t->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+        (void)jzx_node_peer_start(t, fd);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static int jzx_node_unix_addr(const char* path, struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    size_t n = strlen(path);
+    if (n >= sizeof(addr->sun_path)) {
+        return -1;
+    }
+    memcpy(addr->sun_path, path, n);
+    return 0;
+}
+
+static int jzx_node_listen(const char* path) {
+    struct sockaddr_un addr;
+    if (jzx_node_unix_addr(path, &addr) != 0) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0 ||
+        jzx_node_set_nonblock(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// -----------------------------------------------------------------------------
+// Runtime hooks
+// -----------------------------------------------------------------------------
+
+uint32_t jzx_node_self(const jzx_node_table* nodes) {
+    return nodes->opts.node_id;
+}
+
+jzx_err jzx_node_route(jzx_loop* loop,
+                       jzx_actor_id target,
+                       void* data,
+                       size_t len,
+                       uint32_t tag,
+                       jzx_actor_id sender,
+                       uint64_t deadline_ms) {
+    jzx_node_table* t = loop->nodes;
+    jzx_node_peer* peer = t->routes[jzx_actor_node(target)];
+    if (!peer) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    if ((len && !data) || len > t->opts.max_frame) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (!sender && loop->current_actor) {
+        sender = loop->current_actor->id;
+    }
+    if (sender && !jzx_actor_node(sender)) {
+        sender = jzx_node_actor(t->opts.node_id, sender);
+    }
+    jzx_err err = jzx_node_peer_queue(peer, tag, target, sender, data, len, deadline_ms);
+    if (err != JZX_OK) {
+        return err;
+    }
+    t->stats.frames_out++;
+    return JZX_OK;
+}
+
+static void jzx_node_table_free(jzx_node_table* t, int notify) {
+    jzx_loop* loop = t->loop;
+    while (t->peers) {
+        jzx_node_peer* peer = t->peers;
+        jzx_actor_id self = peer->self;
+        if (notify) {
+            // Best effort: hand the kernel what is already batched.
+            (void)jzx_node_peer_flush(peer);
+        }
+        jzx_node_peer_teardown(peer, 0, notify);
+        if (notify) {
+            (void)jzx_actor_stop(loop, self);
+        }
+    }
+    if (t->listen_fd >= 0) {
+        (void)jzx_unwatch_fd(loop, t->listen_fd);
+        close(t->listen_fd);
+        if (notify) {
+            (void)jzx_actor_stop(loop, t->listener);
+        }
+    }
+    if (t->unix_path) {
+        unlink(t->unix_path);
+        jzx_loop_free(loop, t->unix_path);
+    }
+    if (t->spare) {
+        jzx_loop_free(loop, t->spare);
+    }
+    if (t->monitors) {
+        jzx_loop_free(loop, t->monitors);
+    }
+    jzx_loop_free(loop, t);
+}
+
+void jzx_node_shutdown(jzx_loop* loop) {
+    if (loop->nodes) {
+        jzx_node_table* t = loop->nodes;
+        loop->nodes = NULL;
+        jzx_node_table_free(t, 0);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+jzx_err jzx_node_start(jzx_loop* loop, const jzx_node_opts* opts) {
+    if (!loop || !opts || opts->node_id == 0 || opts->node_id > JZX_NODE_MAX) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (loop->nodes) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_node_table* t = (jzx_node_table*)jzx_loop_alloc(loop, sizeof(jzx_node_table));
+    if (!t) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(t, 0, sizeof(*t));
+    t->loop = loop;
+    t->opts = *opts;
+    t->opts.unix_path = NULL;
+    t->listen_fd = -1;
+    if (t->opts.batch_bytes == 0) {
+        t->opts.batch_bytes = JZX_NODE_DEFAULT_BATCH;
+    }
+    if (t->opts.max_queued == 0) {
+        t->opts.max_queued = JZX_NODE_DEFAULT_QUEUED;
+    }
+    if (t->opts.max_frame == 0) {
+        t->opts.max_frame = JZX_NODE_DEFAULT_FRAME;
+    }
+    if (opts->unix_path) {
+        int fd = jzx_node_listen(opts->unix_path);
+        if (fd < 0) {
+            jzx_loop_free(loop, t);
+            return JZX_ERR_IO_REG_FAILED;
+        }
+        size_t n = strlen(opts->unix_path) + 1;
+        t->unix_path = (char*)jzx_loop_alloc(loop, n);
+        if (t->unix_path) {
+            memcpy(t->unix_path, opts->unix_path, n);
+        }
+        jzx_spawn_opts spawn = {.behavior = jzx_node_listener_behavior, .state = t};
+        jzx_err err = t->unix_path ? jzx_spawn(loop, &spawn, &t->listener) : JZX_ERR_NO_MEMORY;
+        if (err == JZX_OK) {
+            t->listen_fd = fd;
+            err = jzx_watch_fd(loop, fd, t->listener, JZX_IO_READ);
+        } else {
+            close(fd);
+        }
+        if (err != JZX_OK) {
+            jzx_node_table_free(t, 1);
+            return err;
+        }
+    }
+    loop->nodes = t;
+    return JZX_OK;
+}
+
+jzx_err jzx_node_connect(jzx_loop* loop, const char* unix_path) {
+    if (!loop || !loop->nodes || !unix_path) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    struct sockaddr_un addr;
+    if (jzx_node_unix_addr(unix_path, &addr) != 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    // Unix stream connects complete (or fail) immediately.
+    int rc;
+    do {
+        rc = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    } while (rc != 0 && errno == EINTR);
+    if (rc != 0) {
+        close(fd);
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    return jzx_node_peer_start(loop->nodes, fd);
+}
+
+jzx_err jzx_node_adopt(jzx_loop* loop, int fd) {
+    if (!loop || !loop->nodes || fd < 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_node_peer_start(loop->nodes, fd);
+}
+
+jzx_err jzx_node_monitor(jzx_loop* loop, uint32_t node, jzx_actor_id actor, jzx_node_monitor_mode mode) {
+    if (!loop || !loop->nodes || node > JZX_NODE_MAX || actor == 0 ||
+        (mode != JZX_NODE_NOTIFY && mode != JZX_NODE_FAIL)) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_node_table* t = loop->nodes;
+    jzx_node_monitor_entry m = {.node = node, .mode = mode, .actor = actor};
+    if (node != 0 && !t->routes[node]) {
+        jzx_node_fire(t, &m, node, ENOTCONN);
+        return JZX_OK;
+    }
+    if (t->monitor_count == t->monitor_cap) {
+        uint32_t cap = t->monitor_cap ? t->monitor_cap * 2u : 8u;
+        jzx_node_monitor_entry* grown =
+            (jzx_node_monitor_entry*)jzx_loop_alloc(loop, sizeof(jzx_node_monitor_entry) * cap);
+        if (!grown) {
+            return JZX_ERR_NO_MEMORY;
+        }
+        if (t->monitor_count) {
+            memcpy(grown, t->monitors, sizeof(jzx_node_monitor_entry) * t->monitor_count);
+        }
+        if (t->monitors) {
+            jzx_loop_free(loop, t->monitors);
+        }
+        t->monitors = grown;
+        t->monitor_cap = cap;
+    }
+    t->monitors[t->monitor_count++] = m;
+    return JZX_OK;
+}
+
+int jzx_node_connected(jzx_loop* loop, uint32_t node) {
+    if (!loop || !loop->nodes || node > JZX_NODE_MAX) {
+        return 0;
+    }
+    return loop->nodes->routes[node] != NULL;
+}
+
+jzx_err jzx_node_get_stats(jzx_loop* loop, jzx_node_stats* out) {
+    if (!loop || !loop->nodes || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    *out = loop->nodes->stats;
+    return JZX_OK;
+}
+
+void jzx_node_stop(jzx_loop* loop) {
+    if (!loop || !loop->nodes) {
+        return;
+    }
+    jzx_node_table* t = loop->nodes;
+    // Sends made by the notifications below must not route anywhere.
+    loop->nodes = NULL;
+    jzx_node_table_free(t, 1);
+}
@@ -0,0 +1,348 @@
+#include "jzx/perf.h"
+#include "jzx_internal.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+typedef struct {
+    jzx_actor_id id; // 0 = unused
+    jzx_perf_counts counts;
+} jzx_perf_actor_slot;
+
+typedef struct {
+    uint64_t key; // tag + 1, 0 = empty
+    jzx_perf_counts counts;
+} jzx_perf_tag_slot;
+
+struct jzx_perf {
+    int group_fd; // first of fds, -1 while no counter is open
+    int fds[JZX_PERF_MAX_COUNTERS];
+    uint8_t opened; // the group has been attempted
+    uint32_t available;
+    // Counter kind (JZX_PERF_*) of each group member, in read order.
+    uint32_t kinds[JZX_PERF_MAX_COUNTERS];
+    uint32_t counter_count;
+    uint32_t sample_every;
+    uint32_t countdown;
+    uint64_t calls;
+    uint64_t failed;
+    uint64_t untagged;
+    jzx_perf_counts total;
+    // Indexed by actor slot, grown on demand.
+    jzx_perf_actor_slot* actors;
+    uint32_t actor_capacity;
+    jzx_perf_tag_slot* tags;
+    uint32_t tag_capacity;
+    uint32_t tag_count;
+};
+
+// -----------------------------------------------------------------------------
+// Counter group
+// -----------------------------------------------------------------------------
+
+#ifdef __linux__
+static int jzx_perf_open_one(uint32_t type, uint64_t config, int exclude_kernel, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = exclude_kernel ? 1u : 0u;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+#endif
+
+// Counts the calling thread. Whichever counter opens first leads the group.
+static void jzx_perf_open(jzx_perf* perf) {
+    perf->opened = 1;
+#ifdef __linux__
+    static const struct {
+        uint32_t kind;
+        uint32_t type;
+        uint64_t config;
+        int exclude_kernel;
+    } events[] = {
+        {JZX_PERF_CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1},
+        {JZX_PERF_INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1},
+        {JZX_PERF_CACHE_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 1},
+        // Context switches are counted by the kernel, so keep it included.
+        {JZX_PERF_CONTEXT_SWITCHES, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, 0},
+    };
+    for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); ++i) {
+        int fd = jzx_perf_open_one(events[i].type, events[i].config, events[i].exclude_kernel, perf->group_fd);
+        if (fd < 0) {
+            continue;
+        }
+        if (perf->group_fd < 0) {
+            perf->group_fd = fd;
+        }
+        perf->fds[perf->counter_count] = fd;
+        perf->kinds[perf->counter_count++] = events[i].kind;
+        perf->available |= events[i].kind;
+    }
+#endif
+}
+
+// Reads every counter with one syscall. Returns 0 if the read failed, in
+// which case `values` is left untouched. With no counter open there is
+// nothing to read and the call succeeds.
+static int jzx_perf_read(jzx_perf* perf, uint64_t* values) {
+    if (perf->group_fd < 0) {
+        return 1;
+    }
+    uint64_t buf[1 + JZX_PERF_MAX_COUNTERS];
+    size_t want = sizeof(uint64_t) * (1u + perf->counter_count);
+    if (read(perf->group_fd, buf, want) != (ssize_t)want) {
+        return 0;
+    }
+    memcpy(values, buf + 1, sizeof(uint64_t) * perf->counter_count);
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// Accumulation
+// -----------------------------------------------------------------------------
+
+static void jzx_perf_add(jzx_perf* perf, jzx_perf_counts* counts, const uint64_t* delta) {
+    counts->calls++;
+    for (uint32_t i = 0; i < perf->counter_count; ++i) {
+        switch (perf->kinds[i]) {
+        case JZX_PERF_CYCLES:
+            counts->cycles += delta[i];
+            break;
+        case JZX_PERF_INSTRUCTIONS:
+            counts->instructions += delta[i];
+            break;
+        case JZX_PERF_CACHE_MISSES:
+            counts->cache_misses += delta[i];
+            break;
+        case JZX_PERF_CONTEXT_SWITCHES:
+            counts->context_switches += delta[i];
+            break;
+        }
+    }
+}
+
+static jzx_perf_actor_slot* jzx_perf_actor_slot_for(jzx_loop* loop, jzx_perf* perf, jzx_actor_id id) {
+    uint32_t idx = (uint32_t)(id & 0xffffffffu);
+    if (idx >= perf->actor_capacity) {
+        uint32_t cap = perf->actor_capacity ? perf->actor_capacity : 64u;
+        while (cap <= idx) {
+            cap *= 2u;
+        }
+        jzx_perf_actor_slot* grown = (jzx_perf_actor_slot*)jzx_loop_alloc(loop, sizeof(jzx_perf_actor_slot) * cap);
+        if (!grown) {
+            return NULL;
+        }
+        memset(grown, 0, sizeof(jzx_perf_actor_slot) * cap);
+        if (perf->actors) {
+            memcpy(grown, perf->actors, sizeof(jzx_perf_actor_slot) * perf->actor_capacity);
+            jzx_loop_free(loop, perf->actors);
+        }
+        perf->actors = grown;
+        perf->actor_capacity = cap;
+    }
+    jzx_perf_actor_slot* slot = &perf->actors[idx];
+    if (slot->id != id) {
+        // First call by a new occupant of the slot.
+        memset(slot, 0, sizeof(*slot));
+        slot->id = id;
+    }
+    return slot;
+}
+
+static uint32_t jzx_perf_tag_hash(uint64_t key) {
+    key *= 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(key >> 32u);
+}
+
+static jzx_perf_tag_slot* jzx_perf_tag_find(jzx_perf_tag_slot* slots, uint32_t capacity, uint64_t key) {
+    uint32_t mask = capacity - 1u;
+    uint32_t idx = jzx_perf_tag_hash(key) & mask;
+    while (slots[idx].key != 0 && slots[idx].key != key) {
+        idx = (idx + 1u) & mask;
+    }
+    return &slots[idx];
+}
+
+static jzx_perf_tag_slot* jzx_perf_tag_slot_for(jzx_loop* loop, jzx_perf* perf, uint32_t tag) {
+    uint64_t key = (uint64_t)tag + 1u;
+    if (perf->tag_count >= JZX_PERF_MAX_TAGS) {
+        // Full: only tags already in the map are counted. The map stays at
+        // most half occupied, so the probe always reaches an empty slot.
+        jzx_perf_tag_slot* slot = jzx_perf_tag_find(perf->tags, perf->tag_capacity, key);
+        return slot->key == key ? slot : NULL;
+    }
+    if ((perf->tag_count + 1u) * 2u > perf->tag_capacity) {
+        uint32_t cap = perf->tag_capacity ? perf->tag_capacity * 2u : 32u;
+        jzx_perf_tag_slot* grown = (jzx_perf_tag_slot*)jzx_loop_alloc(loop, sizeof(jzx_perf_tag_slot) * cap);
+        if (!grown) {
+            return NULL;
+        }
+        memset(grown, 0, sizeof(jzx_perf_tag_slot) * cap);
+        for (uint32_t i = 0; i < perf->tag_capacity; ++i) {
+            if (perf->tags[i].key) {
+                *jzx_perf_tag_find(grown, cap, perf->tags[i].key) = perf->tags[i];
+            }
+        }
+        if (perf->tags) {
+            jzx_loop_free(loop, perf->tags);
+        }
+        perf->tags = grown;
+        perf->tag_capacity = cap;
+    }
+    jzx_perf_tag_slot* slot = jzx_perf_tag_find(perf->tags, perf->tag_capacity, key);
+    if (slot->key == 0) {
+        slot->key = key;
+        perf->tag_count++;
+    }
+    return slot;
+}
+
+// -----------------------------------------------------------------------------
+// Runtime hooks
+// -----------------------------------------------------------------------------
+
+jzx_err jzx_perf_init(jzx_loop* loop) {
+    if (!loop->cfg.perf_counters) {
+        return JZX_OK;
+    }
+    jzx_perf* perf = (jzx_perf*)jzx_loop_alloc(loop, sizeof(jzx_perf));
+    if (!perf) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(perf, 0, sizeof(*perf));
+    perf->group_fd = -1;
+    perf->sample_every = loop->cfg.perf_sample_every ? loop->cfg.perf_sample_every : 1u;
+    perf->countdown = 1;
+    loop->perf = perf;
+    return JZX_OK;
+}
+
+void jzx_perf_shutdown(jzx_loop* loop) {
+    jzx_perf* perf = loop->perf;
+    if (!perf) {
+        return;
+    }
+    loop->perf = NULL;
+    for (uint32_t i = 0; i < perf->counter_count; ++i) {
+        close(perf->fds[i]);
+    }
+    if (perf->actors) jzx_loop_free(loop, perf->actors);
+    if (perf->tags) jzx_loop_free(loop, perf->tags);
+    jzx_loop_free(loop, perf);
+}
+
+int jzx_perf_begin(jzx_perf* perf, uint64_t* before) {
+    perf->calls++;
+    if (--perf->countdown != 0) {
+        return 0;
+    }
+    perf->countdown = perf->sample_every;
+    if (!perf->opened) {
+        jzx_perf_open(perf);
+    }
+    if (!jzx_perf_read(perf, before)) {
+        perf->failed++;
+        return 0;
+    }
+    return 1;
+}
+
+void jzx_perf_end(jzx_loop* loop, jzx_actor_id actor, uint32_t tag, const uint64_t* before) {
+    jzx_perf* perf = loop->perf;
+    uint64_t delta[JZX_PERF_MAX_COUNTERS];
+    if (!jzx_perf_read(perf, delta)) {
+        perf->failed++;
+        return;
+    }
+    for (uint32_t i = 0; i < perf->counter_count; ++i) {
+        delta[i] -= before[i];
+    }
+    jzx_perf_add(perf, &perf->total, delta);
+    jzx_perf_actor_slot* slot = jzx_perf_actor_slot_for(loop, perf, actor);
+    if (slot) {
+        jzx_perf_add(perf, &slot->counts, delta);
+    }
+    jzx_perf_tag_slot* tag_slot = jzx_perf_tag_slot_for(loop, perf, tag);
+    if (tag_slot) {
+        jzx_perf_add(perf, &tag_slot->counts, delta);
+    } else {
+        perf->untagged++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Snapshots
+// -----------------------------------------------------------------------------
+
+jzx_err jzx_perf_get_stats(jzx_loop* loop, jzx_perf_stats* out) {
+    if (!loop || !loop->perf || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_perf* perf = loop->perf;
+    out->available = perf->available;
+    out->tags = perf->tag_count;
+    out->calls = perf->calls;
+    out->failed = perf->failed;
+    out->untagged = perf->untagged;
+    out->total = perf->total;
+    return JZX_OK;
+}
+
+jzx_err jzx_perf_get_actor(jzx_loop* loop, jzx_actor_id id, jzx_perf_counts* out) {
+    if (!loop || !loop->perf || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_perf* perf = loop->perf;
+    uint32_t idx = (uint32_t)(id & 0xffffffffu);
+    if (idx < perf->actor_capacity && perf->actors[idx].id == id) {
+        *out = perf->actors[idx].counts;
+    } else {
+        memset(out, 0, sizeof(*out));
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_perf_get_tags(jzx_loop* loop, jzx_perf_tag_counts* out, uint32_t cap, uint32_t* out_count) {
+    if (!loop || !loop->perf || (!out && cap) || !out_count) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_perf* perf = loop->perf;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < perf->tag_capacity && n < cap; ++i) {
+        if (perf->tags[i].key) {
+            out[n].tag = (uint32_t)(perf->tags[i].key - 1u);
+            out[n].counts = perf->tags[i].counts;
+            n++;
+        }
+    }
+    *out_count = n;
+    return JZX_OK;
+}
+
+jzx_err jzx_perf_reset(jzx_loop* loop) {
+    if (!loop || !loop->perf) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_perf* perf = loop->perf;
+    perf->calls = 0;
+    perf->failed = 0;
+    perf->untagged = 0;
+    memset(&perf->total, 0, sizeof(perf->total));
+    if (perf->actors) {
+        memset(perf->actors, 0, sizeof(jzx_perf_actor_slot) * perf->actor_capacity);
+    }
+    if (perf->tags) {
+        memset(perf->tags, 0, sizeof(jzx_perf_tag_slot) * perf->tag_capacity);
+    }
+    perf->tag_count = 0;
+    return JZX_OK;
+}
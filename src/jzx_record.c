@@ -0,0 +1,413 @@
+#include "jzx/record.h"
+#include "jzx_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JZX_RECORD_DEFAULT_BUFFER (1u << 20)
+#define JZX_RECORD_MIN_BUFFER 4096u
+// At maximum speed the replay ticks the loop every this many records, so
+// stand-ins drain while the log is read instead of only on a full mailbox.
+#define JZX_REPLAY_TICK_EVERY 256u
+
+struct jzx_recorder {
+    jzx_loop* loop;
+    int fd;
+    uint8_t payloads;
+    uint32_t buffer_bytes;
+    // The loop thread appends to `active`. The other buffer is `spare` when
+    // the writer is idle and `pending` while it is being written.
+    uint8_t* active;
+    uint32_t active_len;
+    uint8_t* spare;
+    uint8_t* pending;
+    uint32_t pending_len;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t thread_running;
+    uint8_t stop;
+    // records/dropped: loop thread. bytes/error: writer, under mutex.
+    jzx_record_stats stats;
+};
+
+static uint64_t jzx_record_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Returns 0 or the errno of the failed write.
+static int jzx_record_write_all(int fd, const uint8_t* bytes, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, bytes, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        bytes += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Recorder
+// -----------------------------------------------------------------------------
+
+static void* jzx_record_writer_main(void* arg) {
+    jzx_recorder* rec = (jzx_recorder*)arg;
+    jzx_block_all_signals();
+    pthread_mutex_lock(&rec->mutex);
+    for (;;) {
+        while (!rec->pending && !rec->stop) {
+            pthread_cond_wait(&rec->cond, &rec->mutex);
+        }
+        if (!rec->pending) {
+            break;
+        }
+        uint8_t* buf = rec->pending;
+        uint32_t len = rec->pending_len;
+        pthread_mutex_unlock(&rec->mutex);
+        int err = rec->stats.error ? 0 : jzx_record_write_all(rec->fd, buf, len);
+        pthread_mutex_lock(&rec->mutex);
+        if (err) {
+            rec->stats.error = err;
+        } else if (!rec->stats.error) {
+            rec->stats.bytes += len;
+        }
+        rec->spare = buf;
+        rec->pending = NULL;
+        pthread_cond_broadcast(&rec->cond);
+    }
+    pthread_mutex_unlock(&rec->mutex);
+    return NULL;
+}
+
+// Hands the active buffer to the writer. Without `wait`, fails instead of
+// blocking when the writer still holds the other buffer.
+static int jzx_record_handoff(jzx_recorder* rec, int wait) {
+    pthread_mutex_lock(&rec->mutex);
+    while (wait && !rec->spare) {
+        pthread_cond_wait(&rec->cond, &rec->mutex);
+    }
+    if (!rec->spare) {
+        pthread_mutex_unlock(&rec->mutex);
+        return -1;
+    }
+    rec->pending = rec->active;
+    rec->pending_len = rec->active_len;
+    rec->active = rec->spare;
+    rec->active_len = 0;
+    rec->spare = NULL;
+    pthread_cond_broadcast(&rec->cond);
+    pthread_mutex_unlock(&rec->mutex);
+    return 0;
+}
+
+void jzx_record_note(jzx_recorder* rec,
+                     uint64_t time_ns,
+                     jzx_actor_id sender,
+                     jzx_actor_id target,
+                     uint32_t tag,
+                     const void* data,
+                     size_t len) {
+    size_t room = rec->buffer_bytes - sizeof(jzx_record_entry);
+    uint32_t payload_len = rec->payloads && data && len <= room ? (uint32_t)len : 0;
+    size_t need = sizeof(jzx_record_entry) + payload_len;
+    if (rec->active_len + need > rec->buffer_bytes && jzx_record_handoff(rec, 0) != 0) {
+        rec->stats.dropped++;
+        return;
+    }
+    jzx_record_entry entry = {
+        .time_ns = time_ns,
+        .sender = sender,
+        .target = target,
+        .tag = tag,
+        .len = len > UINT32_MAX ? UINT32_MAX : (uint32_t)len,
+        .payload_len = payload_len,
+        .reserved = 0,
+    };
+    uint8_t* out = rec->active + rec->active_len;
+    memcpy(out, &entry, sizeof(entry));
+    if (payload_len) {
+        memcpy(out + sizeof(entry), data, payload_len);
+    }
+    rec->active_len += (uint32_t)need;
+    rec->stats.records++;
+}
+
+static void jzx_record_free(jzx_loop* loop, jzx_recorder* rec) {
+    if (rec->fd >= 0) {
+        close(rec->fd);
+    }
+    if (rec->active) jzx_loop_free(loop, rec->active);
+    if (rec->spare) jzx_loop_free(loop, rec->spare);
+    jzx_loop_free(loop, rec);
+}
+
+jzx_err jzx_record_start(jzx_loop* loop, const jzx_record_opts* opts) {
+    if (!loop || !opts || !opts->path || loop->recorder) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_recorder* rec = (jzx_recorder*)jzx_loop_alloc(loop, sizeof(jzx_recorder));
+    if (!rec) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(rec, 0, sizeof(*rec));
+    rec->loop = loop;
+    rec->fd = -1;
+    rec->payloads = opts->payloads;
+    rec->buffer_bytes = opts->buffer_bytes ? opts->buffer_bytes : JZX_RECORD_DEFAULT_BUFFER;
+    if (rec->buffer_bytes < JZX_RECORD_MIN_BUFFER) {
+        rec->buffer_bytes = JZX_RECORD_MIN_BUFFER;
+    }
+    rec->active = (uint8_t*)jzx_loop_alloc(loop, rec->buffer_bytes);
+    rec->spare = (uint8_t*)jzx_loop_alloc(loop, rec->buffer_bytes);
+    if (!rec->active || !rec->spare) {
+        jzx_record_free(loop, rec);
+        return JZX_ERR_NO_MEMORY;
+    }
+    rec->fd = open(opts->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (rec->fd < 0) {
+        jzx_record_free(loop, rec);
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    jzx_record_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JZX_RECORD_MAGIC, sizeof(header.magic));
+    header.version = JZX_RECORD_VERSION;
+    header.flags = rec->payloads ? JZX_RECORD_FLAG_PAYLOADS : 0;
+    header.start_ns = jzx_loop_now_ns(loop);
+    if (jzx_record_write_all(rec->fd, (const uint8_t*)&header, sizeof(header)) != 0) {
+        jzx_record_free(loop, rec);
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    rec->stats.bytes = sizeof(header);
+    if (pthread_mutex_init(&rec->mutex, NULL) != 0) {
+        jzx_record_free(loop, rec);
+        return JZX_ERR_UNKNOWN;
+    }
+    if (pthread_cond_init(&rec->cond, NULL) != 0) {
+        pthread_mutex_destroy(&rec->mutex);
+        jzx_record_free(loop, rec);
+        return JZX_ERR_UNKNOWN;
+    }
+    if (pthread_create(&rec->thread, NULL, jzx_record_writer_main, rec) != 0) {
+        pthread_cond_destroy(&rec->cond);
+        pthread_mutex_destroy(&rec->mutex);
+        jzx_record_free(loop, rec);
+        return JZX_ERR_UNKNOWN;
+    }
+    loop->recorder = rec;
+    return JZX_OK;
+}
+
+jzx_err jzx_record_stop(jzx_loop* loop, jzx_record_stats* out) {
+    if (!loop || !loop->recorder) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_recorder* rec = loop->recorder;
+    loop->recorder = NULL;
+    if (rec->active_len > 0) {
+        (void)jzx_record_handoff(rec, 1);
+    }
+    pthread_mutex_lock(&rec->mutex);
+    rec->stop = 1;
+    pthread_cond_broadcast(&rec->cond);
+    pthread_mutex_unlock(&rec->mutex);
+    pthread_join(rec->thread, NULL);
+    pthread_cond_destroy(&rec->cond);
+    pthread_mutex_destroy(&rec->mutex);
+    if (out) {
+        *out = rec->stats;
+    }
+    jzx_record_free(loop, rec);
+    return JZX_OK;
+}
+
+void jzx_record_shutdown(jzx_loop* loop) {
+    if (loop->recorder) {
+        (void)jzx_record_stop(loop, NULL);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Replay
+// -----------------------------------------------------------------------------
+
+// Recorded target id -> stand-in id; a stand-in of 0 marks a skipped target.
+typedef struct {
+    jzx_actor_id* keys;
+    jzx_actor_id* values;
+    uint32_t capacity;
+    uint32_t count;
+} jzx_replay_map;
+
+static uint32_t jzx_replay_hash(jzx_actor_id id) {
+    id ^= id >> 33u;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33u;
+    return (uint32_t)id;
+}
+
+static jzx_actor_id* jzx_replay_map_slot(jzx_replay_map* map, jzx_actor_id key) {
+    uint32_t mask = map->capacity - 1u;
+    uint32_t idx = jzx_replay_hash(key) & mask;
+    while (map->keys[idx] != 0 && map->keys[idx] != key) {
+        idx = (idx + 1u) & mask;
+    }
+    return &map->keys[idx];
+}
+
+static jzx_err jzx_replay_map_grow(jzx_loop* loop, jzx_replay_map* map) {
+    jzx_replay_map next = {.capacity = map->capacity ? map->capacity * 2u : 64u, .count = map->count};
+    next.keys = (jzx_actor_id*)jzx_loop_alloc(loop, sizeof(jzx_actor_id) * next.capacity);
+    next.values = (jzx_actor_id*)jzx_loop_alloc(loop, sizeof(jzx_actor_id) * next.capacity);
+    if (!next.keys || !next.values) {
+        if (next.keys) jzx_loop_free(loop, next.keys);
+        if (next.values) jzx_loop_free(loop, next.values);
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(next.keys, 0, sizeof(jzx_actor_id) * next.capacity);
+    for (uint32_t i = 0; i < map->capacity; ++i) {
+        if (map->keys[i]) {
+            jzx_actor_id* slot = jzx_replay_map_slot(&next, map->keys[i]);
+            *slot = map->keys[i];
+            next.values[slot - next.keys] = map->values[i];
+        }
+    }
+    if (map->keys) {
+        jzx_loop_free(loop, map->keys);
+        jzx_loop_free(loop, map->values);
+    }
+    *map = next;
+    return JZX_OK;
+}
+
+// Stand-in for a recorded target, spawning it on first sight.
+static jzx_actor_id jzx_replay_stand_in(jzx_loop* loop,
+                                        const jzx_replay_opts* opts,
+                                        jzx_replay_map* map,
+                                        jzx_actor_id recorded,
+                                        uint32_t tag) {
+    if (map->count * 2u >= map->capacity && jzx_replay_map_grow(loop, map) != JZX_OK) {
+        return 0;
+    }
+    jzx_actor_id* slot = jzx_replay_map_slot(map, recorded);
+    jzx_actor_id* value = &map->values[slot - map->keys];
+    if (*slot == recorded) {
+        return *value;
+    }
+    *slot = recorded;
+    *value = 0;
+    map->count++;
+    jzx_spawn_opts spawn;
+    memset(&spawn, 0, sizeof(spawn));
+    if (opts->resolve(opts->ctx, recorded, tag, &spawn) == JZX_OK && spawn.behavior) {
+        jzx_actor_id id = 0;
+        if (jzx_spawn(loop, &spawn, &id) == JZX_OK) {
+            *value = id;
+        }
+    }
+    return *value;
+}
+
+jzx_err jzx_replay(jzx_loop* loop, const jzx_replay_opts* opts, jzx_replay_stats* out) {
+    if (!loop || !opts || !opts->path || !opts->resolve) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    FILE* file = fopen(opts->path, "rb");
+    if (!file) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    jzx_record_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, JZX_RECORD_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != JZX_RECORD_VERSION) {
+        fclose(file);
+        return JZX_ERR_INVALID_ARG;
+    }
+
+    jzx_replay_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    jzx_replay_map map;
+    memset(&map, 0, sizeof(map));
+    uint64_t wall_start = jzx_record_wall_ns();
+    uint64_t first_ns = 0;
+    uint64_t last_ns = 0;
+    jzx_err rc = JZX_OK;
+    jzx_record_entry entry;
+    // A truncated final record (e.g. after a crash) just ends the replay.
+    while (fread(&entry, sizeof(entry), 1, file) == 1) {
+        void* payload = NULL;
+        if (entry.payload_len) {
+            payload = jzx_loop_alloc(loop, entry.payload_len);
+            if (!payload) {
+                rc = JZX_ERR_NO_MEMORY;
+                break;
+            }
+            if (fread(payload, entry.payload_len, 1, file) != 1) {
+                jzx_loop_free(loop, payload);
+                break;
+            }
+        }
+        if (stats.records == 0) {
+            first_ns = entry.time_ns;
+        }
+        last_ns = entry.time_ns;
+        stats.records++;
+
+        if (opts->realtime) {
+            uint64_t due = wall_start + (entry.time_ns - first_ns);
+            for (uint64_t now = jzx_record_wall_ns(); now < due; now = jzx_record_wall_ns()) {
+                jzx_loop_run_once(loop, (uint32_t)((due - now) / 1000000ull));
+            }
+        } else if (stats.records % JZX_REPLAY_TICK_EVERY == 0) {
+            jzx_loop_run_once(loop, 0);
+        }
+
+        jzx_actor_id target = jzx_replay_stand_in(loop, opts, &map, entry.target, entry.tag);
+        jzx_err err = target ? jzx_send(loop, target, payload, entry.len, entry.tag) : JZX_ERR_NO_SUCH_ACTOR;
+        while (err == JZX_ERR_MAILBOX_FULL) {
+            jzx_loop_run_once(loop, 0);
+            err = jzx_send(loop, target, payload, entry.len, entry.tag);
+        }
+        if (err == JZX_OK) {
+            stats.delivered++;
+        } else {
+            stats.skipped++;
+            if (payload) {
+                jzx_loop_free(loop, payload);
+            }
+        }
+    }
+    fclose(file);
+
+    // Let the stand-ins finish the tail of the log, then retire them.
+    while (jzx_loop_next_deadline(loop) == 0) {
+        jzx_loop_run_once(loop, 0);
+    }
+    for (uint32_t i = 0; i < map.capacity; ++i) {
+        if (map.keys[i] && map.values[i]) {
+            (void)jzx_actor_stop(loop, map.values[i]);
+        }
+    }
+    jzx_loop_run_once(loop, 0);
+    if (map.keys) {
+        jzx_loop_free(loop, map.keys);
+        jzx_loop_free(loop, map.values);
+    }
+    stats.recorded_ns = last_ns - first_ns;
+    stats.elapsed_ns = jzx_record_wall_ns() - wall_start;
+    if (out) {
+        *out = stats;
+    }
+    return rc;
+}
@@ -1,9 +1,24 @@
 #include "jzx_internal.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define JZX_HAVE_BACKTRACE 1
+#endif
 
 // -----------------------------------------------------------------------------
 // Utility helpers
@@ -17,6 +32,15 @@ static inline uint32_t jzx_id_generation(jzx_actor_id id) {
     return (uint32_t)(id >> 32u);
 }
 
+// The top 8 bits of an id name its node (jzx/node.h), leaving 24 for the
+// slot generation.
+#define JZX_ID_GENERATION_MAX 0x00ffffffu
+#define JZX_ID_NODE_SHIFT 56u
+
+static inline uint32_t jzx_id_node(jzx_actor_id id) {
+    return (uint32_t)(id >> JZX_ID_NODE_SHIFT);
+}
+
 static inline jzx_actor_id jzx_make_id(uint32_t gen, uint32_t idx) {
     return ((uint64_t)gen << 32u) | (uint64_t)idx;
 }
@@ -31,45 +55,6 @@ static void jzx_free(jzx_allocator* alloc, void* ptr) {
     }
 }
 
-static jzx_supervisor_state* jzx_supervisor_state_create(const jzx_supervisor_init* init,
-                                                         jzx_allocator* allocator) {
-    if (!init || init->child_count == 0 || !init->children) {
-        return NULL;
-    }
-    jzx_supervisor_state* state =
-        (jzx_supervisor_state*)jzx_alloc(allocator, sizeof(jzx_supervisor_state));
-    if (!state) {
-        return NULL;
-    }
-    memset(state, 0, sizeof(*state));
-    state->config = init->supervisor;
-    state->child_count = init->child_count;
-    size_t bytes = sizeof(jzx_child_state) * init->child_count;
-    state->children = (jzx_child_state*)jzx_alloc(allocator, bytes);
-    if (!state->children) {
-        jzx_free(allocator, state);
-        return NULL;
-    }
-    memset(state->children, 0, bytes);
-    for (size_t i = 0; i < init->child_count; ++i) {
-        state->children[i].spec = init->children[i];
-        state->children[i].id = 0;
-        state->children[i].restart_count = 0;
-        state->children[i].last_restart_ms = 0;
-    }
-    state->intensity_window_count = 0;
-    state->intensity_window_start_ms = 0;
-    return state;
-}
-
-static void jzx_supervisor_state_destroy(jzx_supervisor_state* state, jzx_allocator* allocator) {
-    if (!state) return;
-    if (state->children) {
-        jzx_free(allocator, state->children);
-    }
-    jzx_free(allocator, state);
-}
-
 static int jzx_supervisor_allow_restart(jzx_supervisor_state* sup, uint64_t now_ms) {
     if (!sup) return 0;
     if (sup->config.intensity == 0 || sup->config.period_ms == 0) {
@@ -93,6 +78,25 @@ static uint64_t jzx_now_ms(void) {
     return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
 }
 
+static uint64_t jzx_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// The loop's clock: simulated under cfg.virtual_time, else CLOCK_MONOTONIC.
+// Durations measured for stats (tick and offload latency) stay on real time.
+static uint64_t jzx_loop_clock_ns(jzx_loop* loop) {
+    if (loop->cfg.virtual_time) {
+        return atomic_load_explicit(&loop->virtual_now_ns, memory_order_acquire);
+    }
+    return jzx_now_ns();
+}
+
+static uint64_t jzx_loop_clock_ms(jzx_loop* loop) {
+    return jzx_loop_clock_ns(loop) / 1000000ull;
+}
+
 static uint32_t jzx_sat_add32(uint32_t a, uint32_t b) {
     uint64_t sum = (uint64_t)a + (uint64_t)b;
     if (sum > UINT32_MAX) {
@@ -110,6 +114,25 @@ static uint32_t jzx_sat_mul32(uint32_t a, uint32_t b) {
     return (uint32_t)prod;
 }
 
+// xorshift64*: cheap, good enough for jitter and not used for anything secret.
+static uint64_t jzx_rng_next(jzx_loop* loop) {
+    uint64_t x = loop->rng_state;
+    x ^= x >> 12u;
+    x ^= x << 25u;
+    x ^= x >> 27u;
+    loop->rng_state = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+// Uniform in [lo, hi].
+static uint32_t jzx_rng_range(jzx_loop* loop, uint32_t lo, uint32_t hi) {
+    if (hi <= lo) {
+        return lo;
+    }
+    uint64_t span = (uint64_t)hi - (uint64_t)lo + 1u;
+    return lo + (uint32_t)(jzx_rng_next(loop) % span);
+}
+
 static jzx_err jzx_send_internal(jzx_loop* loop,
                                  jzx_actor_id target,
                                  void* data,
@@ -117,35 +140,232 @@ static jzx_err jzx_send_internal(jzx_loop* loop,
                                  uint32_t tag,
                                  jzx_actor_id sender);
 
+static jzx_err jzx_send_internal_deadline(jzx_loop* loop,
+                                          jzx_actor_id target,
+                                          void* data,
+                                          size_t len,
+                                          uint32_t tag,
+                                          jzx_actor_id sender,
+                                          uint64_t deadline_ms);
+
 static void jzx_io_remove_actor(jzx_loop* loop, jzx_actor_id actor);
+static jzx_message* jzx_mailbox_buffer_get(jzx_loop* loop, uint32_t capacity);
+static void jzx_mailbox_buffer_put(jzx_loop* loop, jzx_message* buffer, uint32_t capacity);
+static void jzx_signal_remove_actor(jzx_loop* loop, jzx_actor_id actor);
+
+static void jzx_supervisor_state_destroy(jzx_supervisor_state* state, jzx_allocator* allocator);
+
+static void jzx_release_message(jzx_loop* loop, const jzx_message* msg) {
+    if (loop->cfg.release) {
+        loop->cfg.release(loop->cfg.release_ctx, msg);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Index map
+// -----------------------------------------------------------------------------
+
+static inline uint32_t jzx_hash_u64(uint64_t key) {
+    key ^= key >> 33u;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33u;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33u;
+    return (uint32_t)key;
+}
+
+static jzx_err jzx_index_map_init(jzx_index_map* map,
+                                  uint32_t min_entries,
+                                  jzx_allocator* allocator) {
+    memset(map, 0, sizeof(*map));
+    uint32_t capacity = 8;
+    while (capacity < min_entries * 2u && capacity < (1u << 31u)) {
+        capacity <<= 1u;
+    }
+    map->keys = (uint64_t*)jzx_alloc(allocator, sizeof(uint64_t) * capacity);
+    map->values = (uint32_t*)jzx_alloc(allocator, sizeof(uint32_t) * capacity);
+    map->used = (uint8_t*)jzx_alloc(allocator, capacity);
+    if (!map->keys || !map->values || !map->used) {
+        if (map->keys) jzx_free(allocator, map->keys);
+        if (map->values) jzx_free(allocator, map->values);
+        if (map->used) jzx_free(allocator, map->used);
+        memset(map, 0, sizeof(*map));
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(map->used, 0, capacity);
+    map->capacity = capacity;
+    return JZX_OK;
+}
+
+static void jzx_index_map_deinit(jzx_index_map* map, jzx_allocator* allocator) {
+    if (map->keys) jzx_free(allocator, map->keys);
+    if (map->values) jzx_free(allocator, map->values);
+    if (map->used) jzx_free(allocator, map->used);
+    memset(map, 0, sizeof(*map));
+}
+
+static int jzx_index_map_get(const jzx_index_map* map, uint64_t key, uint32_t* out) {
+    if (map->count == 0) {
+        return 0;
+    }
+    uint32_t mask = map->capacity - 1u;
+    for (uint32_t i = jzx_hash_u64(key) & mask; map->used[i]; i = (i + 1u) & mask) {
+        if (map->keys[i] == key) {
+            if (out) {
+                *out = map->values[i];
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void jzx_index_map_put_nogrow(jzx_index_map* map, uint64_t key, uint32_t value) {
+    uint32_t mask = map->capacity - 1u;
+    uint32_t i = jzx_hash_u64(key) & mask;
+    while (map->used[i]) {
+        if (map->keys[i] == key) {
+            map->values[i] = value;
+            return;
+        }
+        i = (i + 1u) & mask;
+    }
+    map->used[i] = 1;
+    map->keys[i] = key;
+    map->values[i] = value;
+    map->count++;
+}
+
+static jzx_err jzx_index_map_put(jzx_index_map* map,
+                                 uint64_t key,
+                                 uint32_t value,
+                                 jzx_allocator* allocator) {
+    // Keep the load factor at or below 3/4 so probe sequences stay short.
+    if ((map->count + 1u) * 4u > map->capacity * 3u) {
+        jzx_index_map grown;
+        jzx_err err = jzx_index_map_init(&grown, map->capacity, allocator);
+        if (err != JZX_OK) {
+            return err;
+        }
+        for (uint32_t i = 0; i < map->capacity; ++i) {
+            if (map->used[i]) {
+                jzx_index_map_put_nogrow(&grown, map->keys[i], map->values[i]);
+            }
+        }
+        jzx_index_map_deinit(map, allocator);
+        *map = grown;
+    }
+    jzx_index_map_put_nogrow(map, key, value);
+    return JZX_OK;
+}
+
+static int jzx_index_map_remove(jzx_index_map* map, uint64_t key) {
+    if (map->count == 0) {
+        return 0;
+    }
+    uint32_t mask = map->capacity - 1u;
+    uint32_t i = jzx_hash_u64(key) & mask;
+    while (map->used[i] && map->keys[i] != key) {
+        i = (i + 1u) & mask;
+    }
+    if (!map->used[i]) {
+        return 0;
+    }
+    // Backward-shift deletion: pull later entries of the probe run into the hole.
+    uint32_t hole = i;
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1u) & mask;
+        if (!map->used[j]) {
+            break;
+        }
+        uint32_t home = jzx_hash_u64(map->keys[j]) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            map->keys[hole] = map->keys[j];
+            map->values[hole] = map->values[j];
+            hole = j;
+        }
+    }
+    map->used[hole] = 0;
+    map->count--;
+    return 1;
+}
 
 // -----------------------------------------------------------------------------
 // Mailbox implementation
 // -----------------------------------------------------------------------------
 
+static void jzx_mailbox_deinit(jzx_mailbox_impl* box, jzx_loop* loop);
+
+static jzx_mailbox_ext* jzx_mailbox_ext_get(jzx_mailbox_impl* box, jzx_allocator* allocator) {
+    if (!box->ext) {
+        box->ext = (jzx_mailbox_ext*)jzx_alloc(allocator, sizeof(jzx_mailbox_ext));
+        if (box->ext) {
+            memset(box->ext, 0, sizeof(*box->ext));
+        }
+    }
+    return box->ext;
+}
+
+static uint32_t jzx_mailbox_slot(const jzx_mailbox_impl* box, uint32_t offset) {
+    uint32_t slot = box->head + offset;
+    return slot >= box->capacity ? slot - box->capacity : slot;
+}
+
+// Slots are always written before they are read, so a recycled buffer is not
+// cleared.
 static jzx_err jzx_mailbox_init(jzx_mailbox_impl* box,
                                 uint32_t capacity,
-                                jzx_allocator* allocator) {
+                                jzx_mailbox_mode mode,
+                                jzx_loop* loop) {
     if (capacity == 0) {
         capacity = 1;
     }
-    size_t bytes = sizeof(jzx_message) * capacity;
-    jzx_message* buffer = (jzx_message*)jzx_alloc(allocator, bytes);
+    jzx_allocator* allocator = &loop->allocator;
+    memset(box, 0, sizeof(*box));
+    jzx_message* buffer = jzx_mailbox_buffer_get(loop, capacity);
     if (!buffer) {
         return JZX_ERR_NO_MEMORY;
     }
-    memset(buffer, 0, bytes);
     box->buffer = buffer;
     box->capacity = capacity;
     box->head = 0;
-    box->tail = 0;
     box->count = 0;
+    box->mode = (uint8_t)mode;
+    if (mode == JZX_MAILBOX_CONFLATING) {
+        jzx_mailbox_ext* ext = jzx_mailbox_ext_get(box, allocator);
+        if (ext) {
+            ext->keys = (uint64_t*)jzx_alloc(allocator, sizeof(uint64_t) * capacity);
+            ext->keyed = (uint8_t*)jzx_alloc(allocator, capacity);
+        }
+        if (!ext || !ext->keys || !ext->keyed ||
+            jzx_index_map_init(&ext->key_index, capacity, allocator) != JZX_OK) {
+            jzx_mailbox_deinit(box, loop);
+            return JZX_ERR_NO_MEMORY;
+        }
+        memset(ext->keyed, 0, capacity);
+    }
     return JZX_OK;
 }
 
-static void jzx_mailbox_deinit(jzx_mailbox_impl* box, jzx_allocator* allocator) {
+static void jzx_mailbox_deinit(jzx_mailbox_impl* box, jzx_loop* loop) {
+    jzx_allocator* allocator = &loop->allocator;
     if (box->buffer) {
-        jzx_free(allocator, box->buffer);
+        jzx_mailbox_buffer_put(loop, box->buffer, box->capacity);
+    }
+    jzx_mailbox_ext* ext = box->ext;
+    if (ext) {
+        if (ext->keys) {
+            jzx_free(allocator, ext->keys);
+        }
+        if (ext->keyed) {
+            jzx_free(allocator, ext->keyed);
+        }
+        if (ext->deadlines) {
+            jzx_free(allocator, ext->deadlines);
+        }
+        jzx_index_map_deinit(&ext->key_index, allocator);
+        jzx_free(allocator, ext);
     }
     memset(box, 0, sizeof(*box));
 }
@@ -154,18 +374,100 @@ static int jzx_mailbox_push(jzx_mailbox_impl* box, const jzx_message* msg) {
     if (box->count == box->capacity) {
         return -1;
     }
-    box->buffer[box->tail] = *msg;
-    box->tail = (box->tail + 1) % box->capacity;
+    uint32_t tail = jzx_mailbox_slot(box, box->count);
+    box->buffer[tail] = *msg;
+    if (box->ext) {
+        if (box->ext->keyed) {
+            box->ext->keyed[tail] = 0;
+        }
+        if (box->ext->deadlines) {
+            box->ext->deadlines[tail] = 0;
+        }
+    }
+    box->count++;
+    return 0;
+}
+
+static int jzx_mailbox_push_deadline(jzx_mailbox_impl* box,
+                                     const jzx_message* msg,
+                                     uint64_t deadline_ms,
+                                     jzx_allocator* allocator) {
+    if (box->count == box->capacity) {
+        return -1;
+    }
+    jzx_mailbox_ext* ext = jzx_mailbox_ext_get(box, allocator);
+    if (!ext) {
+        return -2;
+    }
+    if (!ext->deadlines) {
+        size_t bytes = sizeof(uint64_t) * box->capacity;
+        ext->deadlines = (uint64_t*)jzx_alloc(allocator, bytes);
+        if (!ext->deadlines) {
+            return -2;
+        }
+        memset(ext->deadlines, 0, bytes);
+    }
+    uint32_t slot = jzx_mailbox_slot(box, box->count);
+    if (jzx_mailbox_push(box, msg) != 0) {
+        return -1;
+    }
+    ext->deadlines[slot] = deadline_ms;
+    return 0;
+}
+
+// Returns 1 when a pending message with the same key was overwritten (the old
+// message is copied to *replaced), 0 when the message was queued, -1 when full.
+static int jzx_mailbox_push_keyed(jzx_mailbox_impl* box,
+                                  uint64_t key,
+                                  const jzx_message* msg,
+                                  jzx_message* replaced) {
+    if (box->mode != JZX_MAILBOX_CONFLATING) {
+        return jzx_mailbox_push(box, msg);
+    }
+    jzx_mailbox_ext* ext = box->ext;
+    uint32_t slot = 0;
+    if (jzx_index_map_get(&ext->key_index, key, &slot)) {
+        *replaced = box->buffer[slot];
+        box->buffer[slot] = *msg;
+        if (ext->deadlines) {
+            ext->deadlines[slot] = 0;
+        }
+        return 1;
+    }
+    if (box->count == box->capacity) {
+        return -1;
+    }
+    slot = jzx_mailbox_slot(box, box->count);
+    box->buffer[slot] = *msg;
+    ext->keys[slot] = key;
+    ext->keyed[slot] = 1;
+    if (ext->deadlines) {
+        ext->deadlines[slot] = 0;
+    }
+    // The index is sized for the full capacity up front, so this never grows.
+    jzx_index_map_put_nogrow(&ext->key_index, key, slot);
     box->count++;
     return 0;
 }
 
-static int jzx_mailbox_pop(jzx_mailbox_impl* box, jzx_message* out) {
+static int jzx_mailbox_pop(jzx_mailbox_impl* box, jzx_message* out, uint64_t* out_deadline) {
     if (box->count == 0) {
         return -1;
     }
-    *out = box->buffer[box->head];
-    box->head = (box->head + 1) % box->capacity;
+    uint32_t head = box->head;
+    *out = box->buffer[head];
+    *out_deadline = 0;
+    jzx_mailbox_ext* ext = box->ext;
+    if (ext) {
+        if (ext->deadlines) {
+            *out_deadline = ext->deadlines[head];
+        }
+        if (ext->keyed && ext->keyed[head]) {
+            jzx_index_map_remove(&ext->key_index, ext->keys[head]);
+            ext->keyed[head] = 0;
+        }
+    }
+    box->head = head + 1 == box->capacity ? 0 : head + 1;
     box->count--;
     return 0;
 }
@@ -183,18 +485,23 @@ static jzx_err jzx_actor_table_init(jzx_actor_table* table,
                                     jzx_allocator* allocator) {
     memset(table, 0, sizeof(*table));
     table->capacity = capacity;
-    size_t slot_bytes = sizeof(jzx_actor*) * capacity;
+    size_t hot_bytes = sizeof(jzx_actor) * capacity;
+    size_t cold_bytes = sizeof(jzx_actor_cold) * capacity;
     size_t gen_bytes = sizeof(uint32_t) * capacity;
     size_t stack_bytes = sizeof(uint32_t) * capacity;
 
-    table->slots = (jzx_actor**)jzx_alloc(allocator, slot_bytes);
+    table->hot_block = jzx_alloc(allocator, hot_bytes + 63);
+    table->cold = (jzx_actor_cold*)jzx_alloc(allocator, cold_bytes);
     table->generations = (uint32_t*)jzx_alloc(allocator, gen_bytes);
     table->free_stack = (uint32_t*)jzx_alloc(allocator, stack_bytes);
-    if (!table->slots || !table->generations || !table->free_stack) {
+    if (!table->hot_block || !table->cold || !table->generations || !table->free_stack) {
         return JZX_ERR_NO_MEMORY;
     }
 
-    memset(table->slots, 0, slot_bytes);
+    // Line-aligned so each actor's hot record is exactly one cache line.
+    table->hot = (jzx_actor*)(((uintptr_t)table->hot_block + 63) & ~(uintptr_t)63);
+    memset(table->hot, 0, hot_bytes);
+    memset(table->cold, 0, cold_bytes);
     for (uint32_t i = 0; i < capacity; ++i) {
         table->generations[i] = 1;
         table->free_stack[i] = capacity - 1 - i;
@@ -208,8 +515,11 @@ static void jzx_actor_table_deinit(jzx_actor_table* table, jzx_allocator* alloca
     if (!table) {
         return;
     }
-    if (table->slots) {
-        jzx_free(allocator, table->slots);
+    if (table->hot_block) {
+        jzx_free(allocator, table->hot_block);
+    }
+    if (table->cold) {
+        jzx_free(allocator, table->cold);
     }
     if (table->generations) {
         jzx_free(allocator, table->generations);
@@ -220,56 +530,283 @@ static void jzx_actor_table_deinit(jzx_actor_table* table, jzx_allocator* alloca
     memset(table, 0, sizeof(*table));
 }
 
+// The id check alone validates the slot: free slots hold id 0 and live ids
+// are never 0.
 static jzx_actor* jzx_actor_table_lookup(jzx_actor_table* table, jzx_actor_id id) {
     uint32_t idx = jzx_id_index(id);
-    if (idx >= table->capacity) {
+    if (idx >= table->capacity || id == 0) {
         return NULL;
     }
-    if (table->generations[idx] != jzx_id_generation(id)) {
+    jzx_actor* actor = &table->hot[idx];
+    return actor->id == id ? actor : NULL;
+}
+
+typedef enum {
+    JZX_ID_LOCAL = 0,  // one of this loop's actors
+    JZX_ID_REMOTE,     // an actor on a peer node
+    JZX_ID_UNROUTABLE, // node bits set, but this loop is not a node
+} jzx_id_kind;
+
+// Where an id points. Ids qualified with this loop's own node number are
+// rewritten in place to the plain form jzx_spawn returned.
+static inline jzx_id_kind jzx_id_resolve(jzx_loop* loop, jzx_actor_id* id) {
+    uint32_t node = jzx_id_node(*id);
+    if (node == 0) {
+        return JZX_ID_LOCAL;
+    }
+    if (!loop->nodes) {
+        return JZX_ID_UNROUTABLE;
+    }
+    if (node != jzx_node_self(loop->nodes)) {
+        return JZX_ID_REMOTE;
+    }
+    *id &= (1ull << JZX_ID_NODE_SHIFT) - 1u;
+    return JZX_ID_LOCAL;
+}
+
+// The local actor behind an id from the public API, or NULL. Unlike
+// jzx_actor_table_lookup this accepts self-qualified ids.
+static jzx_actor* jzx_actor_lookup(jzx_loop* loop, jzx_actor_id id) {
+    if (jzx_id_resolve(loop, &id) != JZX_ID_LOCAL) {
         return NULL;
     }
-    return table->slots[idx];
+    return jzx_actor_table_lookup(&loop->actors, id);
+}
+
+// Live actor in slot idx, or NULL.
+static jzx_actor* jzx_actor_table_at(jzx_actor_table* table, uint32_t idx) {
+    jzx_actor* actor = &table->hot[idx];
+    return actor->id ? actor : NULL;
+}
+
+static uint32_t jzx_actor_slot(const jzx_actor_table* table, const jzx_actor* actor) {
+    return (uint32_t)(actor - table->hot);
+}
+
+static jzx_actor_cold* jzx_actor_cold_of(jzx_loop* loop, const jzx_actor* actor) {
+    return &loop->actors.cold[jzx_actor_slot(&loop->actors, actor)];
+}
+
+static jzx_supervisor_state* jzx_supervisor_state_of(jzx_loop* loop, jzx_actor_id id) {
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
+    return actor ? jzx_actor_cold_of(loop, actor)->supervisor_state : NULL;
 }
 
-static jzx_err jzx_actor_table_insert(jzx_actor_table* table,
-                                      jzx_actor* actor,
-                                      jzx_allocator* allocator,
-                                      jzx_actor_id* out_id) {
-    (void)allocator;
+// Claims a free slot; its hot and cold records are zeroed apart from the id.
+static jzx_actor* jzx_actor_table_insert(jzx_actor_table* table) {
     if (table->free_top == 0) {
-        return JZX_ERR_MAX_ACTORS;
+        return NULL;
     }
     uint32_t idx = table->free_stack[--table->free_top];
-    uint32_t gen = table->generations[idx];
-    actor->id = jzx_make_id(gen, idx);
-    table->slots[idx] = actor;
+    jzx_actor* actor = &table->hot[idx];
+    actor->id = jzx_make_id(table->generations[idx], idx);
     table->used++;
-    if (out_id) {
-        *out_id = actor->id;
-    }
-    return JZX_OK;
+    return actor;
 }
 
 static void jzx_actor_table_remove(jzx_actor_table* table,
                                    jzx_actor* actor) {
-    if (!actor) {
-        return;
-    }
-    uint32_t idx = jzx_id_index(actor->id);
-    if (idx >= table->capacity) {
+    if (!actor || !actor->id) {
         return;
     }
-    if (table->slots[idx] != actor) {
-        return;
+    uint32_t idx = jzx_actor_slot(table, actor);
+    memset(actor, 0, sizeof(*actor));
+    memset(&table->cold[idx], 0, sizeof(jzx_actor_cold));
+    // Generation 0 is skipped so no live id is ever 0.
+    if (++table->generations[idx] > JZX_ID_GENERATION_MAX) {
+        table->generations[idx] = 1;
     }
-    table->slots[idx] = NULL;
-    table->generations[idx] += 1u;
     table->free_stack[table->free_top++] = idx;
     if (table->used > 0) {
         table->used--;
     }
 }
 
+// -----------------------------------------------------------------------------
+// Memory accounting
+// -----------------------------------------------------------------------------
+
+// Keeps the payload 16-byte aligned like malloc.
+typedef struct {
+    uint64_t size;
+    jzx_actor_id actor;
+} jzx_mem_header;
+
+static int jzx_mem_on_loop_thread(jzx_loop* loop) {
+    return loop->mem_actors_ready && pthread_equal(pthread_self(), loop->mem_thread);
+}
+
+static void jzx_mem_charge_actor(jzx_loop* loop, jzx_actor* actor, uint64_t size) {
+    jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
+    cold->mem_bytes += size;
+    if (cold->mem_bytes > cold->mem_peak) {
+        cold->mem_peak = cold->mem_bytes;
+    }
+    if (cold->mem_limit && !actor->mem_over && cold->mem_bytes > cold->mem_limit) {
+        actor->mem_over = 1;
+        loop->stats.mem_limit_hits++;
+        if (cold->mem_action != JZX_MEM_REJECT) {
+            // Acted on at the end of the tick, outside whatever allocated.
+            cold->mem_hit_pending = 1;
+            loop->mem_limit_pending = 1;
+        }
+    }
+}
+
+static jzx_actor* jzx_mem_target(jzx_loop* loop) {
+    return loop->mem_charge ? loop->mem_charge : loop->current_actor;
+}
+
+static void jzx_mem_uncharge(jzx_loop* loop, const jzx_mem_header* header) {
+    jzx_actor* actor = jzx_actor_table_lookup(&loop->actors, header->actor);
+    if (actor) {
+        jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
+        cold->mem_bytes -= header->size < cold->mem_bytes ? header->size : cold->mem_bytes;
+        if (actor->mem_over && cold->mem_bytes <= cold->mem_limit) {
+            actor->mem_over = 0;
+        }
+    }
+}
+
+static void* jzx_mem_alloc(void* ctx, size_t size) {
+    jzx_loop* loop = (jzx_loop*)ctx;
+    jzx_mem_header* header =
+        (jzx_mem_header*)loop->cfg.allocator.alloc(loop->cfg.allocator.ctx, sizeof(jzx_mem_header) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->size = size;
+    header->actor = 0;
+    uint64_t total = atomic_fetch_add_explicit(&loop->mem_bytes, size, memory_order_relaxed) + size;
+    uint64_t peak = atomic_load_explicit(&loop->mem_peak, memory_order_relaxed);
+    while (total > peak &&
+           !atomic_compare_exchange_weak_explicit(&loop->mem_peak, &peak, total, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+    if (jzx_mem_on_loop_thread(loop)) {
+        jzx_actor* actor = jzx_mem_target(loop);
+        if (actor) {
+            header->actor = actor->id;
+            jzx_mem_charge_actor(loop, actor, size);
+        }
+    }
+    return header + 1;
+}
+
+static void jzx_mem_free(void* ctx, void* ptr) {
+    jzx_loop* loop = (jzx_loop*)ctx;
+    if (!ptr) {
+        return;
+    }
+    jzx_mem_header* header = (jzx_mem_header*)ptr - 1;
+    atomic_fetch_sub_explicit(&loop->mem_bytes, header->size, memory_order_relaxed);
+    if (header->actor && jzx_mem_on_loop_thread(loop)) {
+        jzx_mem_uncharge(loop, header);
+    }
+    if (loop->cfg.allocator.free) {
+        loop->cfg.allocator.free(loop->cfg.allocator.ctx, header);
+    }
+}
+
+// Charges loop-thread allocations to actor (NULL = none) until the matching
+// jzx_mem_charge_end; returns the previous target.
+static jzx_actor* jzx_mem_charge_begin(jzx_loop* loop, jzx_actor* actor) {
+    jzx_actor* prev = loop->mem_charge;
+    loop->mem_charge = actor;
+    return prev;
+}
+
+static void jzx_mem_charge_end(jzx_loop* loop, jzx_actor* prev) {
+    loop->mem_charge = prev;
+}
+
+static jzx_actor* jzx_mem_charge_begin_id(jzx_loop* loop, jzx_actor_id id) {
+    jzx_actor* actor = loop->mem_enabled ? jzx_actor_table_lookup(&loop->actors, id) : NULL;
+    return jzx_mem_charge_begin(loop, actor);
+}
+
+// Moves a block's charge to actor (NULL = the loop only), for blocks that
+// change hands without being freed.
+static void jzx_mem_rebind(jzx_loop* loop, void* ptr, jzx_actor* actor) {
+    if (!jzx_mem_on_loop_thread(loop)) {
+        return;
+    }
+    jzx_mem_header* header = (jzx_mem_header*)ptr - 1;
+    if (header->actor) {
+        jzx_mem_uncharge(loop, header);
+    }
+    header->actor = actor ? actor->id : 0;
+    if (actor) {
+        jzx_mem_charge_actor(loop, actor, header->size);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Block pools
+// -----------------------------------------------------------------------------
+
+// Loop thread only. Pooled blocks stay allocated, so they keep counting
+// toward the loop's accounted total but not toward any actor.
+static void* jzx_pool_get(jzx_loop* loop, jzx_pool* pool, size_t size) {
+    void* block = pool->head;
+    if (!block) {
+        loop->stats.pool_misses++;
+        return jzx_alloc(&loop->allocator, size);
+    }
+    pool->head = *(void**)block;
+    pool->count--;
+    loop->stats.pool_hits++;
+    jzx_mem_rebind(loop, block, jzx_mem_target(loop));
+    return block;
+}
+
+static void jzx_pool_put(jzx_loop* loop, jzx_pool* pool, void* block) {
+    if (pool->count >= loop->cfg.pool_max) {
+        jzx_free(&loop->allocator, block);
+        return;
+    }
+    jzx_mem_rebind(loop, block, NULL);
+    *(void**)block = pool->head;
+    pool->head = block;
+    pool->count++;
+}
+
+static void jzx_pool_drain(jzx_loop* loop, jzx_pool* pool) {
+    while (pool->head) {
+        void* block = pool->head;
+        pool->head = *(void**)block;
+        jzx_free(&loop->allocator, block);
+    }
+    pool->count = 0;
+}
+
+// Smallest class whose power-of-two capacity fits, or
+// JZX_MAILBOX_POOL_CLASSES when the buffer is too large to pool.
+static uint32_t jzx_mailbox_pool_class(uint32_t capacity) {
+    uint32_t cls = 0;
+    while (cls < JZX_MAILBOX_POOL_CLASSES && (1u << cls) < capacity) {
+        cls++;
+    }
+    return cls;
+}
+
+static jzx_message* jzx_mailbox_buffer_get(jzx_loop* loop, uint32_t capacity) {
+    uint32_t cls = jzx_mailbox_pool_class(capacity);
+    if (cls == JZX_MAILBOX_POOL_CLASSES) {
+        return (jzx_message*)jzx_alloc(&loop->allocator, sizeof(jzx_message) * capacity);
+    }
+    return (jzx_message*)jzx_pool_get(loop, &loop->mailbox_pools[cls], sizeof(jzx_message) << cls);
+}
+
+static void jzx_mailbox_buffer_put(jzx_loop* loop, jzx_message* buffer, uint32_t capacity) {
+    uint32_t cls = jzx_mailbox_pool_class(capacity);
+    if (cls == JZX_MAILBOX_POOL_CLASSES) {
+        jzx_free(&loop->allocator, buffer);
+        return;
+    }
+    jzx_pool_put(loop, &loop->mailbox_pools[cls], buffer);
+}
+
 // -----------------------------------------------------------------------------
 // Run queue implementation
 // -----------------------------------------------------------------------------
@@ -279,11 +816,10 @@ static jzx_err jzx_run_queue_init(jzx_run_queue* rq,
                                   jzx_allocator* allocator) {
     memset(rq, 0, sizeof(*rq));
     rq->capacity = capacity > 0 ? capacity : 1;
-    rq->entries = (jzx_actor**)jzx_alloc(allocator, sizeof(jzx_actor*) * rq->capacity);
+    rq->entries = (uint32_t*)jzx_alloc(allocator, sizeof(uint32_t) * rq->capacity);
     if (!rq->entries) {
         return JZX_ERR_NO_MEMORY;
     }
-    memset(rq->entries, 0, sizeof(jzx_actor*) * rq->capacity);
     return JZX_OK;
 }
 
@@ -294,49 +830,150 @@ static void jzx_run_queue_deinit(jzx_run_queue* rq, jzx_allocator* allocator) {
     memset(rq, 0, sizeof(*rq));
 }
 
-static int jzx_run_queue_push(jzx_run_queue* rq, jzx_actor* actor) {
+static int jzx_run_queue_push(jzx_run_queue* rq, uint32_t slot) {
     if (rq->count == rq->capacity) {
         return -1;
     }
-    rq->entries[rq->tail] = actor;
-    rq->tail = (rq->tail + 1) % rq->capacity;
+    rq->entries[rq->tail] = slot;
+    rq->tail = rq->tail + 1 == rq->capacity ? 0 : rq->tail + 1;
     rq->count++;
     return 0;
 }
 
-static jzx_actor* jzx_run_queue_pop(jzx_run_queue* rq) {
+// Returns 0 and the actor's slot index, or -1 when empty.
+static int jzx_run_queue_pop(jzx_run_queue* rq, uint32_t* out_slot) {
     if (rq->count == 0) {
-        return NULL;
+        return -1;
     }
-    jzx_actor* actor = rq->entries[rq->head];
-    rq->entries[rq->head] = NULL;
-    rq->head = (rq->head + 1) % rq->capacity;
+    *out_slot = rq->entries[rq->head];
+    rq->head = rq->head + 1 == rq->capacity ? 0 : rq->head + 1;
     rq->count--;
-    return actor;
+    return 0;
+}
+
+// cfg.sched_seed: Fisher-Yates over the queued slots with the loop RNG, so the
+// order ready actors run in is varied but reproducible from the seed.
+static void jzx_run_queue_shuffle(jzx_loop* loop) {
+    jzx_run_queue* rq = &loop->run_queue;
+    for (uint32_t i = rq->count; i > 1; --i) {
+        uint32_t j = (uint32_t)(jzx_rng_next(loop) % i);
+        uint32_t a = (rq->head + i - 1u) % rq->capacity;
+        uint32_t b = (rq->head + j) % rq->capacity;
+        uint32_t tmp = rq->entries[a];
+        rq->entries[a] = rq->entries[b];
+        rq->entries[b] = tmp;
+    }
 }
 
 static void jzx_schedule_actor(jzx_loop* loop, jzx_actor* actor) {
     if (!actor || actor->in_run_queue) {
         return;
     }
-    if (jzx_run_queue_push(&loop->run_queue, actor) == 0) {
+    if (jzx_run_queue_push(&loop->run_queue, jzx_actor_slot(&loop->actors, actor)) == 0) {
         actor->in_run_queue = 1;
     }
 }
 
-static void jzx_teardown_actor(jzx_loop* loop, jzx_actor* actor) {
-    if (!actor) {
-        return;
+// -----------------------------------------------------------------------------
+// Mailbox drain watches
+// -----------------------------------------------------------------------------
+
+static void jzx_drain_remove(jzx_loop* loop, uint32_t idx) {
+    loop->drain_watches[idx] = loop->drain_watches[--loop->drain_count];
+}
+
+// Sends a fired watch's notice. Returns 1 once the watch is done with, 0 if
+// the watcher has no room yet and the notice must be retried.
+static int jzx_drain_notify(jzx_loop* loop, jzx_drain_watch* w) {
+    jzx_err err = jzx_send_internal(loop, w->watcher, NULL, 0, w->tag, 0);
+    if (err == JZX_ERR_MAILBOX_FULL) {
+        w->fired = 1;
+        loop->drain_retry = 1;
+        return 0;
     }
+    return 1;
+}
+
+// Fires the watches on actor's mailbox that its depth now satisfies, or all
+// of them if it is going away, and refreshes actor->drain_watched.
+static void jzx_drain_check(jzx_loop* loop, jzx_actor* actor, int gone) {
+    uint32_t count = actor->mailbox.count;
+    uint32_t half = actor->mailbox.capacity / 2u;
+    uint8_t still = 0;
+    for (uint32_t i = 0; i < loop->drain_count;) {
+        jzx_drain_watch* w = &loop->drain_watches[i];
+        if (w->target != actor->id || w->fired) {
+            ++i;
+            continue;
+        }
+        uint32_t depth = w->depth < actor->mailbox.capacity ? w->depth : half;
+        if (!gone && count > depth) {
+            still = 1;
+            ++i;
+            continue;
+        }
+        if (jzx_drain_notify(loop, w)) {
+            jzx_drain_remove(loop, i);
+        } else {
+            ++i;
+        }
+    }
+    actor->drain_watched = still;
+}
+
+// Retries notices that found their watcher's mailbox full.
+static void jzx_drain_retry(jzx_loop* loop) {
+    loop->drain_retry = 0;
+    for (uint32_t i = 0; i < loop->drain_count;) {
+        jzx_drain_watch* w = &loop->drain_watches[i];
+        if (w->fired && jzx_drain_notify(loop, w)) {
+            jzx_drain_remove(loop, i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+// Drops the watches a stopping actor registered.
+static void jzx_drain_remove_watcher(jzx_loop* loop, jzx_actor_id watcher) {
+    for (uint32_t i = 0; i < loop->drain_count;) {
+        if (loop->drain_watches[i].watcher == watcher) {
+            jzx_drain_remove(loop, i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+static void jzx_teardown_actor(jzx_loop* loop, jzx_actor* actor) {
+    if (!actor) {
+        return;
+    }
+    jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
     jzx_io_remove_actor(loop, actor->id);
-    if (actor->supervisor) {
+    jzx_signal_remove_actor(loop, actor->id);
+    if (loop->drain_count) {
+        jzx_drain_remove_watcher(loop, actor->id);
+        if (actor->drain_watched) {
+            jzx_drain_check(loop, actor, 1);
+        }
+    }
+    if (actor->hibernated) {
+        loop->stats.actors_hibernated--;
+    }
+    if (actor->auto_hibernate) {
+        loop->hibernate_auto_count--;
+    }
+    if (cold->supervisor) {
+        jzx_actor* prev_charge = jzx_mem_charge_begin_id(loop, cold->supervisor);
         jzx_child_exit* ev =
             (jzx_child_exit*)jzx_alloc(&loop->allocator, sizeof(jzx_child_exit));
+        jzx_mem_charge_end(loop, prev_charge);
         if (ev) {
             ev->child = actor->id;
-            ev->status = actor->status;
+            ev->status = (jzx_actor_status)actor->status;
             jzx_err err = jzx_send_internal(loop,
-                                            actor->supervisor,
+                                            cold->supervisor,
                                             ev,
                                             sizeof(jzx_child_exit),
                                             JZX_TAG_SYS_CHILD_EXIT,
@@ -346,65 +983,384 @@ static void jzx_teardown_actor(jzx_loop* loop, jzx_actor* actor) {
             }
         }
     }
-    jzx_mailbox_deinit(&actor->mailbox, &loop->allocator);
+    jzx_message leftover;
+    uint64_t leftover_deadline = 0;
+    while (jzx_mailbox_pop(&actor->mailbox, &leftover, &leftover_deadline) == 0) {
+        jzx_release_message(loop, &leftover);
+    }
+    jzx_mailbox_deinit(&actor->mailbox, loop);
+    if (cold->supervisor_state) {
+        jzx_supervisor_state_destroy(cold->supervisor_state, &loop->allocator);
+    }
+    if (cold->on_stop) {
+        cold->on_stop(loop, actor->state);
+    }
     jzx_actor_table_remove(&loop->actors, actor);
-    if (actor->supervisor_state) {
-        jzx_supervisor_state_destroy(actor->supervisor_state, &loop->allocator);
+}
+
+// -----------------------------------------------------------------------------
+// Hibernation
+// -----------------------------------------------------------------------------
+
+#define JZX_HIBERNATE_SWEEP_MS 100
+
+static int jzx_actor_can_hibernate(jzx_loop* loop, const jzx_actor* actor) {
+    return !actor->hibernated && !actor->in_run_queue && actor->mailbox.count == 0 &&
+           actor->status == JZX_ACTOR_RUNNING && !jzx_actor_cold_of(loop, actor)->supervisor_state;
+}
+
+static int jzx_actor_is_idle(jzx_loop* loop, const jzx_actor* actor) {
+    return actor != loop->current_actor && jzx_actor_can_hibernate(loop, actor);
+}
+
+static void jzx_actor_enter_hibernation(jzx_loop* loop, jzx_actor* actor) {
+    uint32_t capacity = actor->mailbox.capacity;
+    uint8_t mode = actor->mailbox.mode;
+    jzx_mailbox_deinit(&actor->mailbox, loop);
+    actor->mailbox.capacity = capacity;
+    actor->mailbox.mode = mode;
+    jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
+    if (cold->on_hibernate) {
+        actor->state = cold->on_hibernate(loop, actor->state);
+    }
+    actor->hibernated = 1;
+    actor->hibernate_requested = 0;
+    loop->stats.hibernations++;
+    loop->stats.actors_hibernated++;
+}
+
+// Called before anything is pushed to the actor's mailbox.
+static jzx_err jzx_actor_wake(jzx_loop* loop, jzx_actor* actor) {
+    if (!actor->hibernated) {
+        return JZX_OK;
+    }
+    uint32_t capacity = actor->mailbox.capacity;
+    uint8_t mode = actor->mailbox.mode;
+    jzx_actor* prev_charge = jzx_mem_charge_begin(loop, actor);
+    jzx_err err = jzx_mailbox_init(&actor->mailbox, capacity, (jzx_mailbox_mode)mode, loop);
+    jzx_mem_charge_end(loop, prev_charge);
+    if (err != JZX_OK) {
+        actor->mailbox.capacity = capacity;
+        actor->mailbox.mode = mode;
+        return JZX_ERR_NO_MEMORY;
+    }
+    jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
+    if (cold->on_wake) {
+        actor->state = cold->on_wake(loop, actor->state);
+    }
+    actor->hibernated = 0;
+    cold->last_active_ms = jzx_loop_clock_ms(loop);
+    loop->stats.wakeups++;
+    loop->stats.actors_hibernated--;
+    return JZX_OK;
+}
+
+// Hibernates actors idle for at least their hibernate_after_ms. Runs at most
+// every JZX_HIBERNATE_SWEEP_MS, and only while such actors exist.
+static void jzx_hibernate_sweep(jzx_loop* loop, uint64_t now_ms) {
+    if (loop->hibernate_auto_count == 0 || now_ms < loop->hibernate_next_sweep_ms) {
+        return;
+    }
+    loop->hibernate_next_sweep_ms = now_ms + JZX_HIBERNATE_SWEEP_MS;
+    for (uint32_t i = 0; i < loop->actors.capacity; ++i) {
+        jzx_actor* actor = jzx_actor_table_at(&loop->actors, i);
+        if (!actor || !actor->auto_hibernate || !jzx_actor_can_hibernate(loop, actor)) {
+            continue;
+        }
+        jzx_actor_cold* cold = &loop->actors.cold[i];
+        if (now_ms - cold->last_active_ms >= cold->hibernate_after_ms) {
+            jzx_actor_enter_hibernation(loop, actor);
+        }
+    }
+}
+
+// Acts on limits crossed during the tick. A notified actor is told again only
+// after it has dropped back under its limit.
+static void jzx_mem_process_limits(jzx_loop* loop) {
+    loop->mem_limit_pending = 0;
+    for (uint32_t i = 0; i < loop->actors.capacity; ++i) {
+        jzx_actor* actor = jzx_actor_table_at(&loop->actors, i);
+        jzx_actor_cold* cold = &loop->actors.cold[i];
+        if (!actor || !cold->mem_hit_pending) {
+            continue;
+        }
+        cold->mem_hit_pending = 0;
+        if (cold->mem_action == JZX_MEM_FAIL) {
+            if (actor->status == JZX_ACTOR_RUNNING) {
+                actor->status = JZX_ACTOR_FAILED;
+                jzx_schedule_actor(loop, actor);
+            }
+            continue;
+        }
+        jzx_actor* prev_charge = jzx_mem_charge_begin(loop, actor);
+        jzx_mem_limit_event* ev = (jzx_mem_limit_event*)jzx_alloc(&loop->allocator, sizeof(*ev));
+        jzx_mem_charge_end(loop, prev_charge);
+        if (!ev) {
+            continue;
+        }
+        ev->actor = actor->id;
+        ev->bytes = cold->mem_bytes;
+        ev->limit = cold->mem_limit;
+        if (jzx_send_internal(loop, actor->id, ev, sizeof(*ev), JZX_TAG_SYS_MEM_LIMIT, 0) != JZX_OK) {
+            jzx_free(&loop->allocator, ev);
+        }
     }
-    jzx_free(&loop->allocator, actor);
 }
 
 // -----------------------------------------------------------------------------
 // Supervisor helpers
 // -----------------------------------------------------------------------------
 
-static jzx_child_state* jzx_supervisor_find_child(jzx_supervisor_state* sup, jzx_actor_id id, size_t* out_idx) {
-    if (!sup) return NULL;
-    for (size_t i = 0; i < sup->child_count; ++i) {
-        if (sup->children[i].id == id) {
-            if (out_idx) {
-                *out_idx = i;
-            }
-            return &sup->children[i];
+static jzx_supervisor_state* jzx_supervisor_state_create(const jzx_supervisor_init* init,
+                                                         jzx_allocator* allocator) {
+    if (!init || init->child_count == 0 || !init->children) {
+        return NULL;
+    }
+    int dynamic = init->supervisor.strategy == JZX_SUP_SIMPLE_ONE_FOR_ONE;
+    jzx_supervisor_state* state =
+        (jzx_supervisor_state*)jzx_alloc(allocator, sizeof(jzx_supervisor_state));
+    if (!state) {
+        return NULL;
+    }
+    memset(state, 0, sizeof(*state));
+    state->config = init->supervisor;
+    state->dynamic = (uint8_t)dynamic;
+    state->child_template = init->children[0];
+    state->child_count = dynamic ? 0 : init->child_count;
+    state->child_capacity = dynamic ? 16 : init->child_count;
+    size_t bytes = sizeof(jzx_child_state) * state->child_capacity;
+    state->children = (jzx_child_state*)jzx_alloc(allocator, bytes);
+    if (!state->children) {
+        jzx_free(allocator, state);
+        return NULL;
+    }
+    memset(state->children, 0, bytes);
+    if (dynamic) {
+        state->free_slots =
+            (uint32_t*)jzx_alloc(allocator, sizeof(uint32_t) * state->child_capacity);
+        if (!state->free_slots) {
+            jzx_free(allocator, state->children);
+            jzx_free(allocator, state);
+            return NULL;
         }
     }
-    return NULL;
+    if (jzx_index_map_init(&state->child_index, (uint32_t)state->child_capacity, allocator) !=
+        JZX_OK) {
+        if (state->free_slots) {
+            jzx_free(allocator, state->free_slots);
+        }
+        jzx_free(allocator, state->children);
+        jzx_free(allocator, state);
+        return NULL;
+    }
+    for (size_t i = 0; i < state->child_count; ++i) {
+        state->children[i].spec = init->children[i];
+        state->children[i].id = 0;
+        state->children[i].restart_count = 0;
+        state->children[i].last_restart_ms = 0;
+        state->children[i].in_use = 1;
+    }
+    state->intensity_window_count = 0;
+    state->intensity_window_start_ms = 0;
+    return state;
+}
+
+static void jzx_supervisor_state_destroy(jzx_supervisor_state* state, jzx_allocator* allocator) {
+    if (!state) return;
+    if (state->children) {
+        jzx_free(allocator, state->children);
+    }
+    if (state->free_slots) {
+        jzx_free(allocator, state->free_slots);
+    }
+    jzx_index_map_deinit(&state->child_index, allocator);
+    jzx_free(allocator, state);
+}
+
+static jzx_child_state* jzx_supervisor_find_child(jzx_supervisor_state* sup, jzx_actor_id id, size_t* out_idx) {
+    if (!sup || id == 0) return NULL;
+    uint32_t idx = 0;
+    if (!jzx_index_map_get(&sup->child_index, id, &idx)) {
+        return NULL;
+    }
+    if (out_idx) {
+        *out_idx = idx;
+    }
+    return &sup->children[idx];
 }
 
 static jzx_err jzx_supervisor_spawn_child(jzx_loop* loop,
                                           jzx_actor_id supervisor_id,
-                                          jzx_child_state* child) {
+                                          jzx_supervisor_state* sup,
+                                          size_t child_idx) {
+    jzx_child_state* child = &sup->children[child_idx];
     jzx_spawn_opts opts = {
         .behavior = child->spec.behavior,
         .state = child->spec.state,
         .supervisor = supervisor_id,
         .mailbox_cap = child->spec.mailbox_cap,
     };
-    child->last_restart_ms = jzx_now_ms();
-    return jzx_spawn(loop, &opts, &child->id);
+    child->last_restart_ms = jzx_loop_clock_ms(loop);
+    jzx_err err = jzx_spawn(loop, &opts, &child->id);
+    if (err != JZX_OK) {
+        child->id = 0;
+        return err;
+    }
+    err = jzx_index_map_put(&sup->child_index, child->id, (uint32_t)child_idx, &loop->allocator);
+    if (err != JZX_OK) {
+        (void)jzx_actor_stop(loop, child->id);
+        child->id = 0;
+    }
+    return err;
 }
 
-static void jzx_supervisor_stop_child(jzx_loop* loop, jzx_child_state* child) {
+static void jzx_supervisor_stop_child(jzx_loop* loop,
+                                      jzx_supervisor_state* sup,
+                                      jzx_child_state* child) {
     if (child->id != 0) {
+        jzx_index_map_remove(&sup->child_index, child->id);
         (void)jzx_actor_stop(loop, child->id);
         child->id = 0;
     }
 }
 
+static jzx_err jzx_supervisor_acquire_slot(jzx_supervisor_state* sup,
+                                           jzx_allocator* allocator,
+                                           size_t* out_idx) {
+    if (sup->free_count > 0) {
+        *out_idx = sup->free_slots[--sup->free_count];
+        return JZX_OK;
+    }
+    if (sup->child_count == sup->child_capacity) {
+        size_t new_cap = sup->child_capacity * 2;
+        jzx_child_state* children =
+            (jzx_child_state*)jzx_alloc(allocator, sizeof(jzx_child_state) * new_cap);
+        uint32_t* free_slots = (uint32_t*)jzx_alloc(allocator, sizeof(uint32_t) * new_cap);
+        if (!children || !free_slots) {
+            if (children) jzx_free(allocator, children);
+            if (free_slots) jzx_free(allocator, free_slots);
+            return JZX_ERR_NO_MEMORY;
+        }
+        memset(children, 0, sizeof(jzx_child_state) * new_cap);
+        memcpy(children, sup->children, sizeof(jzx_child_state) * sup->child_count);
+        jzx_free(allocator, sup->children);
+        jzx_free(allocator, sup->free_slots);
+        sup->children = children;
+        sup->free_slots = free_slots;
+        sup->child_capacity = new_cap;
+    }
+    *out_idx = sup->child_count++;
+    return JZX_OK;
+}
+
+static void jzx_supervisor_release_slot(jzx_supervisor_state* sup, size_t idx) {
+    jzx_child_state* child = &sup->children[idx];
+    uint32_t generation = child->generation + 1u;
+    memset(child, 0, sizeof(*child));
+    // Bumping the generation invalidates restart timers still in flight.
+    child->generation = generation;
+    sup->free_slots[sup->free_count++] = (uint32_t)idx;
+    sup->active_count--;
+}
+
+// A restart that could not be carried out. Dynamic children give their slot
+// back so a lost restart neither lingers in count_children nor pins the slot;
+// static children keep theirs and stay down until the next one-for-all or
+// rest-for-one restart reaches them.
+static void jzx_supervisor_restart_lost(jzx_supervisor_state* sup, size_t child_idx) {
+    if (sup->dynamic && sup->children[child_idx].in_use) {
+        jzx_supervisor_release_slot(sup, child_idx);
+    }
+}
+
+static void jzx_supervisor_restart_child(jzx_loop* loop,
+                                         jzx_actor_id supervisor_id,
+                                         jzx_supervisor_state* sup,
+                                         size_t child_idx) {
+    if (jzx_supervisor_spawn_child(loop, supervisor_id, sup, child_idx) != JZX_OK) {
+        jzx_supervisor_restart_lost(sup, child_idx);
+    }
+}
+
+// The cap bounds the range before the draw, so a capped backoff still
+// spreads uniformly below backoff_max_ms instead of piling up on it.
+static uint32_t jzx_supervisor_apply_jitter(jzx_loop* loop,
+                                            const jzx_supervisor_state* sup,
+                                            jzx_child_state* child,
+                                            uint32_t delay) {
+    uint32_t cap = sup->config.backoff_max_ms ? sup->config.backoff_max_ms : UINT32_MAX;
+    switch (sup->config.jitter) {
+    case JZX_JITTER_NONE:
+        delay = delay < cap ? delay : cap;
+        break;
+    case JZX_JITTER_FULL:
+        delay = jzx_rng_range(loop, 0, delay < cap ? delay : cap);
+        break;
+    case JZX_JITTER_DECORRELATED: {
+        uint32_t base = child->spec.restart_delay_ms ? child->spec.restart_delay_ms
+                                                     : sup->config.backoff_delay_ms;
+        uint32_t prev = child->last_delay_ms > base ? child->last_delay_ms : base;
+        uint32_t hi = jzx_sat_mul32(prev, 3);
+        hi = hi < cap ? hi : cap;
+        delay = jzx_rng_range(loop, base < hi ? base : hi, hi);
+        break;
+    }
+    }
+    child->last_delay_ms = delay;
+    return delay;
+}
+
+// GCRA view of the loop-wide restart token bucket: returns the delay to use
+// so that restarts across all supervisors stay within restart_rate_per_sec
+// with bursts of up to restart_burst.
+static uint32_t jzx_restart_throttle(jzx_loop* loop, uint32_t delay_ms) {
+    loop->stats.restarts++;
+    uint32_t rate = loop->cfg.restart_rate_per_sec;
+    if (rate == 0) {
+        return delay_ms;
+    }
+    uint64_t interval_us = 1000000ull / rate;
+    if (interval_us == 0) {
+        interval_us = 1;
+    }
+    uint32_t burst = loop->cfg.restart_burst ? loop->cfg.restart_burst : 1;
+    uint64_t tolerance_us = interval_us * (uint64_t)(burst - 1u);
+    uint64_t now_us = jzx_loop_clock_ns(loop) / 1000ull;
+    uint64_t wanted_us = now_us + (uint64_t)delay_ms * 1000ull;
+    uint64_t earliest_us = loop->restart_tat_us > tolerance_us ? loop->restart_tat_us - tolerance_us : 0;
+    uint64_t at_us = wanted_us;
+    if (at_us < earliest_us) {
+        at_us = earliest_us;
+        loop->stats.restarts_deferred++;
+    }
+    uint64_t tat = loop->restart_tat_us > at_us ? loop->restart_tat_us : at_us;
+    loop->restart_tat_us = tat + interval_us;
+    // Round up so a deferred restart never fires ahead of its token.
+    uint64_t delay_us = at_us - now_us;
+    uint64_t out_ms = (delay_us + 999ull) / 1000ull;
+    return out_ms > UINT32_MAX ? UINT32_MAX : (uint32_t)out_ms;
+}
+
 static void jzx_supervisor_schedule_restart(jzx_loop* loop,
                                             jzx_actor* sup_actor,
                                             size_t child_idx,
                                             uint32_t delay_ms) {
-    jzx_supervisor_state* sup = sup_actor->supervisor_state;
+    jzx_supervisor_state* sup = jzx_actor_cold_of(loop, sup_actor)->supervisor_state;
     if (!sup || child_idx >= sup->child_count) return;
+    delay_ms = jzx_supervisor_apply_jitter(loop, sup, &sup->children[child_idx], delay_ms);
+    delay_ms = jzx_restart_throttle(loop, delay_ms);
     if (delay_ms == 0) {
-        (void)jzx_supervisor_spawn_child(loop, sup_actor->id, &sup->children[child_idx]);
+        jzx_supervisor_restart_child(loop, sup_actor->id, sup, child_idx);
         return;
     }
     jzx_child_restart* payload =
         (jzx_child_restart*)jzx_alloc(&loop->allocator, sizeof(jzx_child_restart));
-    if (!payload) return;
+    if (!payload) {
+        jzx_supervisor_restart_lost(sup, child_idx);
+        return;
+    }
     payload->child_index = (uint32_t)child_idx;
+    payload->generation = sup->children[child_idx].generation;
     jzx_err err = jzx_send_after(loop,
                                  sup_actor->id,
                                  delay_ms,
@@ -414,6 +1370,7 @@ static void jzx_supervisor_schedule_restart(jzx_loop* loop,
                                  NULL);
     if (err != JZX_OK) {
         jzx_free(&loop->allocator, payload);
+        jzx_supervisor_restart_lost(sup, child_idx);
     }
 }
 
@@ -455,29 +1412,30 @@ static void jzx_supervisor_restart_strategy(jzx_loop* loop,
     uint32_t failed_delay = sup->children[failed_idx].spec.restart_delay_ms;
     switch (sup->config.strategy) {
     case JZX_SUP_ONE_FOR_ONE:
+    case JZX_SUP_SIMPLE_ONE_FOR_ONE:
         sup->children[failed_idx].restart_count += 1;
-        sup->children[failed_idx].last_restart_ms = jzx_now_ms();
+        sup->children[failed_idx].last_restart_ms = jzx_loop_clock_ms(loop);
         failed_delay = jzx_supervisor_compute_delay(sup, &sup->children[failed_idx]);
         jzx_supervisor_schedule_restart(loop, supervisor_actor, failed_idx, failed_delay);
         break;
     case JZX_SUP_ONE_FOR_ALL:
         for (size_t i = 0; i < sup->child_count; ++i) {
-            jzx_supervisor_stop_child(loop, &sup->children[i]);
+            jzx_supervisor_stop_child(loop, sup, &sup->children[i]);
         }
         for (size_t i = 0; i < sup->child_count; ++i) {
             sup->children[i].restart_count += 1;
-            sup->children[i].last_restart_ms = jzx_now_ms();
+            sup->children[i].last_restart_ms = jzx_loop_clock_ms(loop);
             uint32_t delay = jzx_supervisor_compute_delay(sup, &sup->children[i]);
             jzx_supervisor_schedule_restart(loop, supervisor_actor, i, delay);
         }
         break;
     case JZX_SUP_REST_FOR_ONE:
         for (size_t i = failed_idx; i < sup->child_count; ++i) {
-            jzx_supervisor_stop_child(loop, &sup->children[i]);
+            jzx_supervisor_stop_child(loop, sup, &sup->children[i]);
         }
         for (size_t i = failed_idx; i < sup->child_count; ++i) {
             sup->children[i].restart_count += 1;
-            sup->children[i].last_restart_ms = jzx_now_ms();
+            sup->children[i].last_restart_ms = jzx_loop_clock_ms(loop);
             uint32_t delay = jzx_supervisor_compute_delay(sup, &sup->children[i]);
             jzx_supervisor_schedule_restart(loop, supervisor_actor, i, delay);
         }
@@ -487,13 +1445,13 @@ static void jzx_supervisor_restart_strategy(jzx_loop* loop,
 
 static jzx_behavior_result jzx_supervisor_behavior(jzx_context* ctx, const jzx_message* msg) {
     jzx_actor* sup_actor = jzx_actor_table_lookup(&ctx->loop->actors, ctx->self);
-    if (!sup_actor || !sup_actor->supervisor_state) {
+    jzx_supervisor_state* sup = sup_actor ? jzx_actor_cold_of(ctx->loop, sup_actor)->supervisor_state : NULL;
+    if (!sup) {
         if (msg->data) {
             jzx_free(&ctx->loop->allocator, msg->data);
         }
         return JZX_BEHAVIOR_OK;
     }
-    jzx_supervisor_state* sup = sup_actor->supervisor_state;
     if (msg->tag == JZX_TAG_SYS_CHILD_EXIT && msg->data) {
         jzx_child_exit* ev = (jzx_child_exit*)msg->data;
         size_t idx = 0;
@@ -503,6 +1461,7 @@ static jzx_behavior_result jzx_supervisor_behavior(jzx_context* ctx, const jzx_m
         if (!child) {
             return JZX_BEHAVIOR_OK;
         }
+        jzx_index_map_remove(&sup->child_index, child->id);
         child->id = 0;
 
         int restart = 0;
@@ -514,13 +1473,16 @@ static jzx_behavior_result jzx_supervisor_behavior(jzx_context* ctx, const jzx_m
         }
 
         if (!restart) {
+            if (sup->dynamic) {
+                jzx_supervisor_release_slot(sup, idx);
+            }
             return JZX_BEHAVIOR_OK;
         }
 
-        uint64_t now = jzx_now_ms();
+        uint64_t now = jzx_loop_clock_ms(ctx->loop);
         if (!jzx_supervisor_allow_restart(sup, now)) {
             for (size_t i = 0; i < sup->child_count; ++i) {
-                jzx_supervisor_stop_child(ctx->loop, &sup->children[i]);
+                jzx_supervisor_stop_child(ctx->loop, sup, &sup->children[i]);
             }
             sup_actor->status = JZX_ACTOR_FAILED;
             return JZX_BEHAVIOR_FAIL;
@@ -533,9 +1495,11 @@ static jzx_behavior_result jzx_supervisor_behavior(jzx_context* ctx, const jzx_m
     if (msg->tag == JZX_TAG_SYS_CHILD_RESTART && msg->data) {
         jzx_child_restart* ev = (jzx_child_restart*)msg->data;
         uint32_t idx = ev->child_index;
+        uint32_t generation = ev->generation;
         jzx_free(&ctx->loop->allocator, ev);
-        if (idx < sup->child_count) {
-            (void)jzx_supervisor_spawn_child(ctx->loop, ctx->self, &sup->children[idx]);
+        if (idx < sup->child_count && sup->children[idx].in_use &&
+            sup->children[idx].generation == generation) {
+            jzx_supervisor_restart_child(ctx->loop, ctx->self, sup, idx);
         }
         return JZX_BEHAVIOR_OK;
     }
@@ -546,6 +1510,138 @@ static jzx_behavior_result jzx_supervisor_behavior(jzx_context* ctx, const jzx_m
     return JZX_BEHAVIOR_OK;
 }
 
+// -----------------------------------------------------------------------------
+// Wakeup / backend fd
+// -----------------------------------------------------------------------------
+
+static int jzx_set_nonblock_cloexec(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    int fdfl = fcntl(fd, F_GETFD);
+    if (fdfl < 0 || fcntl(fd, F_SETFD, fdfl | FD_CLOEXEC) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+#ifdef __linux__
+static uint32_t jzx_io_interest_to_epoll(uint32_t interest) {
+    uint32_t mask = 0;
+    if (interest & JZX_IO_READ) {
+        mask |= EPOLLIN;
+    }
+    if (interest & JZX_IO_WRITE) {
+        mask |= EPOLLOUT;
+    }
+    return mask;
+}
+#endif
+
+static jzx_err jzx_wake_init(jzx_loop* loop) {
+    if (pipe(loop->wake_fds) != 0) {
+        loop->wake_fds[0] = -1;
+        loop->wake_fds[1] = -1;
+        return JZX_ERR_UNKNOWN;
+    }
+    if (jzx_set_nonblock_cloexec(loop->wake_fds[0]) != 0 ||
+        jzx_set_nonblock_cloexec(loop->wake_fds[1]) != 0) {
+        return JZX_ERR_UNKNOWN;
+    }
+    atomic_store_explicit(&loop->wake_pending, 0, memory_order_relaxed);
+#ifdef __linux__
+    loop->backend_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->backend_fd < 0) {
+        return JZX_ERR_UNKNOWN;
+    }
+    struct epoll_event ev = {.events = EPOLLIN, .data = {.fd = loop->wake_fds[0]}};
+    if (epoll_ctl(loop->backend_fd, EPOLL_CTL_ADD, loop->wake_fds[0], &ev) != 0) {
+        return JZX_ERR_UNKNOWN;
+    }
+#else
+    loop->backend_fd = loop->wake_fds[0];
+#endif
+    return JZX_OK;
+}
+
+static void jzx_wake_deinit(jzx_loop* loop) {
+#ifdef __linux__
+    if (loop->backend_fd >= 0) {
+        close(loop->backend_fd);
+    }
+#endif
+    loop->backend_fd = -1;
+    for (int i = 0; i < 2; ++i) {
+        if (loop->wake_fds[i] >= 0) {
+            close(loop->wake_fds[i]);
+            loop->wake_fds[i] = -1;
+        }
+    }
+}
+
+// Any thread. A full pipe already guarantees a wakeup, so EAGAIN is ignored.
+static void jzx_wake_signal(jzx_loop* loop) {
+    if (loop->wake_fds[1] < 0) {
+        return;
+    }
+    uint8_t byte = 1;
+    ssize_t rv;
+    do {
+        rv = write(loop->wake_fds[1], &byte, 1);
+    } while (rv < 0 && errno == EINTR);
+}
+
+// Loop thread. Called with async_mutex held so a producer that observes
+// wake_pending == 0 afterwards always writes a fresh byte.
+static void jzx_wake_drain_locked(jzx_loop* loop) {
+    if (loop->wake_fds[0] < 0) {
+        return;
+    }
+    atomic_store_explicit(&loop->wake_pending, 0, memory_order_relaxed);
+    uint8_t buf[64];
+    while (read(loop->wake_fds[0], buf, sizeof(buf)) > 0) {
+    }
+}
+
+// Timed condvar waits use CLOCK_MONOTONIC so wall-clock steps cannot stretch
+// or cut them short. macOS has no pthread_condattr_setclock.
+static int jzx_cond_init_monotonic(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) {
+        return -1;
+    }
+#ifndef __APPLE__
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    int rc = pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return rc;
+}
+
+// Absolute deadline wait_ms from now on the clock of jzx_cond_init_monotonic.
+static struct timespec jzx_cond_deadline(uint32_t wait_ms) {
+    struct timespec ts;
+#ifdef __APPLE__
+    clock_gettime(CLOCK_REALTIME, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    ts.tv_sec += wait_ms / 1000u;
+    ts.tv_nsec += (long)(wait_ms % 1000u) * 1000000l;
+    if (ts.tv_nsec >= 1000000000l) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000l;
+    }
+    return ts;
+}
+
+void jzx_block_all_signals(void) {
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+}
+
 // -----------------------------------------------------------------------------
 // Async queue
 // -----------------------------------------------------------------------------
@@ -554,9 +1650,15 @@ static jzx_err jzx_async_queue_init(jzx_loop* loop) {
     if (pthread_mutex_init(&loop->async_mutex, NULL) != 0) {
         return JZX_ERR_UNKNOWN;
     }
+    if (jzx_cond_init_monotonic(&loop->async_cond) != 0) {
+        pthread_mutex_destroy(&loop->async_mutex);
+        return JZX_ERR_UNKNOWN;
+    }
     loop->async_mutex_initialized = 1;
     loop->async_head = NULL;
     loop->async_tail = NULL;
+    loop->async_waiters = 0;
+    atomic_store_explicit(&loop->load_async_depth, 0, memory_order_relaxed);
     return JZX_OK;
 }
 
@@ -569,8 +1671,10 @@ static void jzx_async_queue_destroy(jzx_loop* loop) {
     loop->async_head = NULL;
     loop->async_tail = NULL;
     pthread_mutex_unlock(&loop->async_mutex);
+    pthread_cond_destroy(&loop->async_cond);
     pthread_mutex_destroy(&loop->async_mutex);
     loop->async_mutex_initialized = 0;
+    jzx_pool_drain(loop, &loop->async_pool);
     while (head) {
         jzx_async_msg* next = head->next;
         jzx_free(&loop->allocator, head);
@@ -578,27 +1682,116 @@ static void jzx_async_queue_destroy(jzx_loop* loop) {
     }
 }
 
+// Waits (async_mutex held) until the queue is below async_high_water or the
+// timeout expires. Returns nonzero if the message may be admitted.
+static int jzx_async_admit_locked(jzx_loop* loop, uint32_t wait_ms) {
+    uint32_t limit = loop->cfg.async_high_water;
+    uint32_t depth = atomic_load_explicit(&loop->load_async_depth, memory_order_relaxed);
+    if (limit == 0 || depth < limit) {
+        return 1;
+    }
+    if (wait_ms == 0) {
+        return 0;
+    }
+    struct timespec ts = jzx_cond_deadline(wait_ms);
+    loop->async_waiters++;
+    int rc = 0;
+    while (atomic_load_explicit(&loop->load_async_depth, memory_order_relaxed) >= limit &&
+           rc == 0) {
+        rc = pthread_cond_timedwait(&loop->async_cond, &loop->async_mutex, &ts);
+    }
+    loop->async_waiters--;
+    return atomic_load_explicit(&loop->load_async_depth, memory_order_relaxed) < limit;
+}
+
+// Takes a recycled message from async_pool, falling back to the allocator.
+// Called with async_mutex held; drops it around the allocation.
+static jzx_async_msg* jzx_async_msg_get_locked(jzx_loop* loop) {
+    jzx_async_msg* msg = (jzx_async_msg*)loop->async_pool.head;
+    if (msg) {
+        loop->async_pool.head = *(void**)msg;
+        loop->async_pool.count--;
+        return msg;
+    }
+    pthread_mutex_unlock(&loop->async_mutex);
+    msg = (jzx_async_msg*)jzx_alloc(&loop->allocator, sizeof(jzx_async_msg));
+    pthread_mutex_lock(&loop->async_mutex);
+    return msg;
+}
+
+// Loop thread only: returns dispatched messages to async_pool in one locked
+// splice. `count` is the chain length.
+static void jzx_async_msg_put_chain(jzx_loop* loop, jzx_async_msg* head, jzx_async_msg* tail, uint32_t count) {
+    // Pool links live in the first word of the block, not in `next`.
+    for (jzx_async_msg* msg = head; msg;) {
+        jzx_async_msg* next = msg->next;
+        *(void**)msg = next;
+        msg = next;
+    }
+    pthread_mutex_lock(&loop->async_mutex);
+    uint32_t room = loop->cfg.pool_max > loop->async_pool.count ? loop->cfg.pool_max - loop->async_pool.count : 0;
+    if (count <= room) {
+        *(void**)tail = loop->async_pool.head;
+        loop->async_pool.head = head;
+        loop->async_pool.count += count;
+        head = NULL;
+    }
+    pthread_mutex_unlock(&loop->async_mutex);
+    while (head) {
+        void* next = *(void**)head;
+        jzx_free(&loop->allocator, head);
+        head = (jzx_async_msg*)next;
+    }
+}
+
 static jzx_err jzx_async_enqueue(jzx_loop* loop,
                                  jzx_actor_id target,
                                  void* data,
                                  size_t len,
                                  uint32_t tag,
-                                 jzx_actor_id sender) {
+                                 jzx_actor_id sender,
+                                 uint64_t deadline_ms,
+                                 int bounded,
+                                 uint32_t wait_ms) {
     if (!loop || !loop->async_mutex_initialized) {
         return JZX_ERR_INVALID_ARG;
     }
-    jzx_async_msg* msg = (jzx_async_msg*)jzx_alloc(&loop->allocator, sizeof(jzx_async_msg));
+    if (bounded && loop->cfg.async_high_water != 0 &&
+        atomic_load_explicit(&loop->load_async_depth, memory_order_relaxed) >=
+            loop->cfg.async_high_water &&
+        wait_ms == 0) {
+        // Fast rejection without allocating or taking the lock.
+        return JZX_ERR_OVERLOADED;
+    }
+
+    pthread_mutex_lock(&loop->async_mutex);
+    // Get the block first: admission and the enqueue below must happen in
+    // one hold of async_mutex, or producers admitted at limit-1 all enqueue.
+    jzx_async_msg* msg = jzx_async_msg_get_locked(loop);
     if (!msg) {
+        pthread_mutex_unlock(&loop->async_mutex);
         return JZX_ERR_NO_MEMORY;
     }
+    if (bounded && !jzx_async_admit_locked(loop, wait_ms)) {
+        int pooled = loop->async_pool.count < loop->cfg.pool_max;
+        if (pooled) {
+            *(void**)msg = loop->async_pool.head;
+            loop->async_pool.head = msg;
+            loop->async_pool.count++;
+        }
+        pthread_mutex_unlock(&loop->async_mutex);
+        if (!pooled) {
+            jzx_free(&loop->allocator, msg);
+        }
+        return JZX_ERR_OVERLOADED;
+    }
     msg->target = target;
     msg->data = data;
     msg->len = len;
     msg->tag = tag;
     msg->sender = sender;
+    msg->deadline_ms = deadline_ms;
     msg->next = NULL;
-
-    pthread_mutex_lock(&loop->async_mutex);
     if (!loop->async_head) {
         loop->async_head = msg;
         loop->async_tail = msg;
@@ -606,7 +1799,12 @@ static jzx_err jzx_async_enqueue(jzx_loop* loop,
         loop->async_tail->next = msg;
         loop->async_tail = msg;
     }
+    atomic_fetch_add_explicit(&loop->load_async_depth, 1, memory_order_relaxed);
+    int need_wake = !atomic_exchange_explicit(&loop->wake_pending, 1, memory_order_relaxed);
     pthread_mutex_unlock(&loop->async_mutex);
+    if (need_wake) {
+        jzx_wake_signal(loop);
+    }
     return JZX_OK;
 }
 
@@ -618,19 +1816,45 @@ static jzx_async_msg* jzx_async_detach(jzx_loop* loop) {
     jzx_async_msg* head = loop->async_head;
     loop->async_head = NULL;
     loop->async_tail = NULL;
+    atomic_store_explicit(&loop->load_async_depth, 0, memory_order_relaxed);
+    jzx_wake_drain_locked(loop);
+    if (loop->async_waiters > 0) {
+        pthread_cond_broadcast(&loop->async_cond);
+    }
     pthread_mutex_unlock(&loop->async_mutex);
     return head;
 }
 
 static void jzx_async_dispatch(jzx_loop* loop, jzx_async_msg* head) {
     jzx_async_msg* msg = head;
+    jzx_async_msg* tail = NULL;
+    uint32_t count = 0;
     while (msg) {
-        jzx_async_msg* next = msg->next;
-        (void)jzx_send_internal(loop, msg->target, msg->data, msg->len, msg->tag, msg->sender);
-        jzx_free(&loop->allocator, msg);
-        msg = next;
+        jzx_err err = jzx_send_internal_deadline(loop,
+                                                 msg->target,
+                                                 msg->data,
+                                                 msg->len,
+                                                 msg->tag,
+                                                 msg->sender,
+                                                 msg->deadline_ms);
+        if (err != JZX_OK) {
+            jzx_message dropped = {
+                .data = msg->data,
+                .len = msg->len,
+                .tag = msg->tag,
+                .sender = msg->sender,
+            };
+            jzx_release_message(loop, &dropped);
+        }
+        jzx_mem_rebind(loop, msg, NULL);
+        tail = msg;
+        count++;
+        msg = msg->next;
     }
-}
+    if (head) {
+        jzx_async_msg_put_chain(loop, head, tail, count);
+    }
+}
 
 static void jzx_async_drain(jzx_loop* loop) {
     jzx_async_msg* head = jzx_async_detach(loop);
@@ -653,73 +1877,242 @@ static int jzx_async_has_pending(jzx_loop* loop) {
 // Timer system
 // -----------------------------------------------------------------------------
 
-static void jzx_timer_insert_locked(jzx_loop* loop, jzx_timer_entry* entry) {
-    if (!loop->timer_head || entry->due_ms < loop->timer_head->due_ms) {
-        entry->next = loop->timer_head;
-        loop->timer_head = entry;
-        return;
+static void jzx_timer_heap_set(jzx_loop* loop, uint32_t pos, uint32_t slot) {
+    loop->timer_heap[pos] = slot;
+    loop->timers[slot].heap_index = pos;
+}
+
+static void jzx_timer_sift_up(jzx_loop* loop, uint32_t pos) {
+    uint32_t slot = loop->timer_heap[pos];
+    uint64_t key = loop->timers[slot].latest_ns;
+    while (pos > 0) {
+        uint32_t parent = (pos - 1u) / 2u;
+        if (loop->timers[loop->timer_heap[parent]].latest_ns <= key) {
+            break;
+        }
+        jzx_timer_heap_set(loop, pos, loop->timer_heap[parent]);
+        pos = parent;
     }
-    jzx_timer_entry* cur = loop->timer_head;
-    while (cur->next && cur->next->due_ms <= entry->due_ms) {
-        cur = cur->next;
+    jzx_timer_heap_set(loop, pos, slot);
+}
+
+static void jzx_timer_sift_down(jzx_loop* loop, uint32_t pos) {
+    uint32_t slot = loop->timer_heap[pos];
+    uint64_t key = loop->timers[slot].latest_ns;
+    for (;;) {
+        uint32_t child = pos * 2u + 1u;
+        if (child >= loop->timer_count) {
+            break;
+        }
+        if (child + 1u < loop->timer_count &&
+            loop->timers[loop->timer_heap[child + 1u]].latest_ns <
+                loop->timers[loop->timer_heap[child]].latest_ns) {
+            child++;
+        }
+        if (key <= loop->timers[loop->timer_heap[child]].latest_ns) {
+            break;
+        }
+        jzx_timer_heap_set(loop, pos, loop->timer_heap[child]);
+        pos = child;
     }
-    entry->next = cur->next;
-    cur->next = entry;
+    jzx_timer_heap_set(loop, pos, slot);
 }
 
-static void* jzx_timer_thread_main(void* arg) {
-    jzx_loop* loop = (jzx_loop*)arg;
+// Unlinks the timer from the heap and returns its slot to the free list.
+static void jzx_timer_remove_locked(jzx_loop* loop, jzx_timer_entry* entry) {
+    uint32_t pos = entry->heap_index;
+    uint32_t last = --loop->timer_count;
+    if (pos != last) {
+        jzx_timer_heap_set(loop, pos, loop->timer_heap[last]);
+        jzx_timer_sift_down(loop, pos);
+        jzx_timer_sift_up(loop, pos);
+    }
+    entry->id = 0;
+    entry->next_free = loop->timer_free;
+    loop->timer_free = (uint32_t)(entry - loop->timers);
+}
+
+// Doubles the slab and heap. Existing slots keep their index, so ids stay
+// valid; only the free list grows.
+static jzx_err jzx_timer_grow_locked(jzx_loop* loop) {
+    uint32_t old_cap = loop->timer_capacity;
+    if (old_cap >= (1u << 31u)) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    uint32_t cap = old_cap ? old_cap * 2u : 64u;
+    jzx_timer_entry* timers = (jzx_timer_entry*)jzx_alloc(&loop->allocator, sizeof(jzx_timer_entry) * cap);
+    uint32_t* heap = (uint32_t*)jzx_alloc(&loop->allocator, sizeof(uint32_t) * cap);
+    if (!timers || !heap) {
+        if (timers) jzx_free(&loop->allocator, timers);
+        if (heap) jzx_free(&loop->allocator, heap);
+        return JZX_ERR_NO_MEMORY;
+    }
+    // The slab outlives whichever actor happened to trigger the growth.
+    jzx_mem_rebind(loop, timers, NULL);
+    jzx_mem_rebind(loop, heap, NULL);
+    memset(timers, 0, sizeof(jzx_timer_entry) * cap);
+    if (old_cap) {
+        memcpy(timers, loop->timers, sizeof(jzx_timer_entry) * old_cap);
+        memcpy(heap, loop->timer_heap, sizeof(uint32_t) * loop->timer_count);
+        jzx_free(&loop->allocator, loop->timers);
+        jzx_free(&loop->allocator, loop->timer_heap);
+    }
+    for (uint32_t i = old_cap; i < cap; ++i) {
+        timers[i].next_free = i + 1u < cap ? i + 1u : loop->timer_free;
+    }
+    loop->timer_free = old_cap;
+    loop->timers = timers;
+    loop->timer_heap = heap;
+    loop->timer_capacity = cap;
+    return JZX_OK;
+}
+
+static jzx_timer_entry* jzx_timer_lookup_locked(jzx_loop* loop, jzx_timer_id id) {
+    uint32_t slot = (uint32_t)id;
+    if (id == 0 || slot >= loop->timer_capacity || loop->timers[slot].id != id) {
+        return NULL;
+    }
+    return &loop->timers[slot];
+}
+
+// Points the timerfd (if any) at the heap top and publishes it for the tick.
+// Called with timer_mutex held whenever the top may have changed.
+static void jzx_timer_arm_locked(jzx_loop* loop) {
+    uint64_t next = loop->timer_count ? loop->timers[loop->timer_heap[0]].latest_ns : UINT64_MAX;
+    atomic_store_explicit(&loop->timer_next_ns, next, memory_order_release);
+#ifdef __linux__
+    if (loop->timer_fd >= 0 && !loop->cfg.virtual_time && next != loop->timer_armed_ns) {
+        // An all-zero it_value disarms; a deadline of 0 still has to fire.
+        struct itimerspec its = {0};
+        if (next != UINT64_MAX) {
+            uint64_t at = next ? next : 1;
+            its.it_value.tv_sec = (time_t)(at / 1000000000ull);
+            its.it_value.tv_nsec = (long)(at % 1000000000ull);
+        }
+        (void)timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+        loop->timer_armed_ns = next;
+    }
+#endif
+}
+
+// Loop thread. Once the earliest slack window has closed, fires every timer
+// already due straight into its target's mailbox. The heap is ordered by
+// latest_ns, so the batch stops at the first timer whose window has not
+// opened yet.
+static void jzx_timer_fire_due(jzx_loop* loop, uint64_t now) {
+    if (atomic_load_explicit(&loop->timer_next_ns, memory_order_acquire) > now) {
+        return;
+    }
+#ifdef __linux__
+    if (loop->timer_fd >= 0) {
+        uint64_t expirations;
+        while (read(loop->timer_fd, &expirations, sizeof(expirations)) > 0) {
+        }
+    }
+#endif
+    loop->stats.timer_wakeups++;
     pthread_mutex_lock(&loop->timer_mutex);
-    while (!loop->timer_stop) {
-        uint64_t now = jzx_now_ms();
-        jzx_timer_entry* head = loop->timer_head;
-        if (!head) {
-            pthread_cond_wait(&loop->timer_cond, &loop->timer_mutex);
-            continue;
+    while (loop->timer_count > 0) {
+        jzx_timer_entry* entry = &loop->timers[loop->timer_heap[0]];
+        if (entry->due_ns > now) {
+            break;
         }
-        if (head->due_ms > now) {
-            uint64_t wait_ms = head->due_ms - now;
-            struct timespec ts;
-            clock_gettime(CLOCK_REALTIME, &ts);
-            ts.tv_sec += wait_ms / 1000ull;
-            ts.tv_nsec += (wait_ms % 1000ull) * 1000000ull;
-            if (ts.tv_nsec >= 1000000000ull) {
-                ts.tv_sec += 1;
-                ts.tv_nsec -= 1000000000ull;
+        jzx_timer_id id = entry->id;
+        jzx_message msg = {
+            .data = entry->data,
+            .len = entry->len,
+            .tag = entry->tag,
+            .sender = 0,
+        };
+        jzx_actor_id target = entry->target;
+        int periodic = entry->period_ns != 0;
+        if (periodic) {
+            // Re-arm from the previous due time so the phase does not drift;
+            // skip periods that are already over.
+            entry->due_ns += entry->period_ns;
+            if (entry->due_ns <= now) {
+                entry->due_ns = now + entry->period_ns;
             }
-            pthread_cond_timedwait(&loop->timer_cond, &loop->timer_mutex, &ts);
-            continue;
+            entry->latest_ns = entry->due_ns + entry->slack_ns;
+            jzx_timer_sift_down(loop, 0);
+        } else {
+            jzx_timer_remove_locked(loop, entry);
         }
-        loop->timer_head = head->next;
+        // Sending may run user release hooks; never hold the lock across it.
         pthread_mutex_unlock(&loop->timer_mutex);
-        jzx_async_enqueue(loop, head->target, head->data, head->len, head->tag, 0);
-        jzx_free(&loop->allocator, head);
+        loop->stats.timers_fired++;
+        jzx_err err;
+        if (periodic && jzx_id_resolve(loop, &target) == JZX_ID_REMOTE) {
+            // Route without the release jzx_send_internal would apply.
+            err = jzx_node_route(loop, target, msg.data, msg.len, msg.tag, 0, 0);
+        } else {
+            err = jzx_send_internal(loop, target, msg.data, msg.len, msg.tag, 0);
+        }
+        if (periodic) {
+            // The payload is borrowed for the interval's lifetime.
+            if (err == JZX_ERR_NO_SUCH_ACTOR) {
+                (void)jzx_cancel_timer(loop, id);
+            }
+        } else if (err != JZX_OK) {
+            jzx_release_message(loop, &msg);
+        }
         pthread_mutex_lock(&loop->timer_mutex);
     }
+    jzx_timer_arm_locked(loop);
     pthread_mutex_unlock(&loop->timer_mutex);
-    return NULL;
+}
+
+// Caps a wait so it ends by the next timer deadline, rounding up to whole
+// milliseconds. On Linux the timerfd ends the wait on time anyway.
+static uint32_t jzx_timer_clamp_wait_ms(jzx_loop* loop, uint32_t wait_ms) {
+    uint64_t next = atomic_load_explicit(&loop->timer_next_ns, memory_order_acquire);
+    if (next == UINT64_MAX || loop->cfg.virtual_time) {
+        return wait_ms;
+    }
+    uint64_t now = jzx_loop_clock_ns(loop);
+    uint64_t until = next > now ? (next - now + 999999ull) / 1000000ull : 0;
+    return until < wait_ms ? (uint32_t)until : wait_ms;
+}
+
+// Virtual time: with nothing runnable, jumps the clock to the next timer
+// deadline so the following tick fires it. Returns 0 if no timer is pending.
+static int jzx_virtual_advance(jzx_loop* loop) {
+    uint64_t next = atomic_load_explicit(&loop->timer_next_ns, memory_order_acquire);
+    if (next == UINT64_MAX) {
+        return 0;
+    }
+    uint64_t now = atomic_load_explicit(&loop->virtual_now_ns, memory_order_acquire);
+    if (next > now) {
+        atomic_store_explicit(&loop->virtual_now_ns, next, memory_order_release);
+    }
+    return 1;
 }
 
 static jzx_err jzx_timer_system_init(jzx_loop* loop) {
     if (pthread_mutex_init(&loop->timer_mutex, NULL) != 0) {
         return JZX_ERR_UNKNOWN;
     }
-    if (pthread_cond_init(&loop->timer_cond, NULL) != 0) {
-        pthread_mutex_destroy(&loop->timer_mutex);
-        return JZX_ERR_UNKNOWN;
-    }
     loop->timer_mutex_initialized = 1;
-    loop->timer_thread_running = 0;
-    loop->timer_stop = 0;
-    loop->timer_head = NULL;
-    loop->next_timer_id = 1;
-    if (pthread_create(&loop->timer_thread, NULL, jzx_timer_thread_main, loop) != 0) {
-        pthread_cond_destroy(&loop->timer_cond);
-        pthread_mutex_destroy(&loop->timer_mutex);
-        loop->timer_mutex_initialized = 0;
+    loop->timers = NULL;
+    loop->timer_heap = NULL;
+    loop->timer_capacity = 0;
+    loop->timer_count = 0;
+    loop->timer_free = UINT32_MAX;
+    loop->timer_armed_ns = UINT64_MAX;
+    atomic_store_explicit(&loop->timer_next_ns, UINT64_MAX, memory_order_relaxed);
+    loop->timer_fd = -1;
+#ifdef __linux__
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->timer_fd < 0) {
         return JZX_ERR_UNKNOWN;
     }
-    loop->timer_thread_running = 1;
+    if (loop->backend_fd >= 0) {
+        struct epoll_event ev = {.events = EPOLLIN, .data = {.fd = loop->timer_fd}};
+        if (epoll_ctl(loop->backend_fd, EPOLL_CTL_ADD, loop->timer_fd, &ev) != 0) {
+            return JZX_ERR_UNKNOWN;
+        }
+    }
+#endif
     return JZX_OK;
 }
 
@@ -727,28 +2120,18 @@ static void jzx_timer_system_shutdown(jzx_loop* loop) {
     if (!loop->timer_mutex_initialized) {
         return;
     }
-    pthread_mutex_lock(&loop->timer_mutex);
-    loop->timer_stop = 1;
-    pthread_cond_broadcast(&loop->timer_cond);
-    pthread_mutex_unlock(&loop->timer_mutex);
-
-    if (loop->timer_thread_running) {
-        pthread_join(loop->timer_thread, NULL);
-        loop->timer_thread_running = 0;
+    if (loop->timer_fd >= 0) {
+        close(loop->timer_fd);
+        loop->timer_fd = -1;
     }
-
-    pthread_mutex_lock(&loop->timer_mutex);
-    jzx_timer_entry* cur = loop->timer_head;
-    loop->timer_head = NULL;
-    pthread_mutex_unlock(&loop->timer_mutex);
-
-    while (cur) {
-        jzx_timer_entry* next = cur->next;
-        jzx_free(&loop->allocator, cur);
-        cur = next;
+    if (loop->timers) {
+        jzx_free(&loop->allocator, loop->timers);
+        jzx_free(&loop->allocator, loop->timer_heap);
     }
-
-    pthread_cond_destroy(&loop->timer_cond);
+    loop->timers = NULL;
+    loop->timer_heap = NULL;
+    loop->timer_capacity = 0;
+    loop->timer_count = 0;
     pthread_mutex_destroy(&loop->timer_mutex);
     loop->timer_mutex_initialized = 0;
 }
@@ -758,15 +2141,113 @@ static int jzx_timer_has_pending(jzx_loop* loop) {
         return 0;
     }
     pthread_mutex_lock(&loop->timer_mutex);
-    int has = loop->timer_head != NULL;
+    int has = loop->timer_count != 0;
     pthread_mutex_unlock(&loop->timer_mutex);
     return has;
 }
 
+// -----------------------------------------------------------------------------
+// Offload pool
+// -----------------------------------------------------------------------------
+
+static void* jzx_offload_worker_main(void* arg) {
+    jzx_loop* loop = (jzx_loop*)arg;
+    jzx_block_all_signals();
+    jzx_offload_pool* pool = &loop->offload;
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stop && pool->count == 0) {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+        if (pool->stop) {
+            break;
+        }
+        jzx_offload_job job = pool->jobs[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+        pool->stats.running++;
+        uint64_t start_ns = jzx_now_ns();
+        pool->stats.wait_us_total += (start_ns - job.submit_ns) / 1000ull;
+        pthread_mutex_unlock(&pool->mutex);
+
+        void* result = job.fn(job.arg);
+        uint64_t end_ns = jzx_now_ns();
+        // Unbounded like timer delivery: a finished job's result is never dropped.
+        (void)jzx_async_enqueue(loop, job.reply_to, result, 0, job.tag, 0, 0, 0, 0);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->stats.running--;
+        pool->stats.completed++;
+        pool->stats.run_us_total += (end_ns - start_ns) / 1000ull;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+static jzx_err jzx_offload_init(jzx_loop* loop) {
+    jzx_offload_pool* pool = &loop->offload;
+    if (loop->cfg.offload_threads == 0) {
+        return JZX_OK;
+    }
+    uint32_t cap = loop->cfg.offload_queue_cap ? loop->cfg.offload_queue_cap : 256;
+    pool->jobs = (jzx_offload_job*)jzx_alloc(&loop->allocator, sizeof(jzx_offload_job) * cap);
+    pool->threads = (pthread_t*)jzx_alloc(&loop->allocator, sizeof(pthread_t) * loop->cfg.offload_threads);
+    if (!pool->jobs || !pool->threads) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        return JZX_ERR_UNKNOWN;
+    }
+    if (pthread_cond_init(&pool->cond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->mutex);
+        return JZX_ERR_UNKNOWN;
+    }
+    pool->initialized = 1;
+    pool->capacity = cap;
+    pool->next_id = 1;
+    pool->stats.queue_cap = cap;
+    for (uint32_t i = 0; i < loop->cfg.offload_threads; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, jzx_offload_worker_main, loop) != 0) {
+            return JZX_ERR_UNKNOWN;
+        }
+        pool->thread_count++;
+    }
+    pool->stats.threads = pool->thread_count;
+    return JZX_OK;
+}
+
+// Jobs still queued at shutdown are discarded; running ones finish first.
+static void jzx_offload_shutdown(jzx_loop* loop) {
+    jzx_offload_pool* pool = &loop->offload;
+    if (pool->initialized) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stop = 1;
+        pthread_cond_broadcast(&pool->cond);
+        pthread_mutex_unlock(&pool->mutex);
+        for (uint32_t i = 0; i < pool->thread_count; ++i) {
+            pthread_join(pool->threads[i], NULL);
+        }
+        pthread_cond_destroy(&pool->cond);
+        pthread_mutex_destroy(&pool->mutex);
+        pool->initialized = 0;
+    }
+    if (pool->threads) {
+        jzx_free(&loop->allocator, pool->threads);
+        pool->threads = NULL;
+    }
+    if (pool->jobs) {
+        jzx_free(&loop->allocator, pool->jobs);
+        pool->jobs = NULL;
+    }
+    pool->thread_count = 0;
+}
+
 // -----------------------------------------------------------------------------
 // I O watchers
 // -----------------------------------------------------------------------------
 
+#define JZX_IO_EXTRA_FDS 3
+
 static jzx_err jzx_io_init(jzx_loop* loop, uint32_t capacity) {
     loop->io_capacity = capacity ? capacity : 1;
     loop->io_count = 0;
@@ -776,12 +2257,15 @@ static jzx_err jzx_io_init(jzx_loop* loop, uint32_t capacity) {
         return JZX_ERR_NO_MEMORY;
     }
     memset(loop->io_watchers, 0, sizeof(jzx_io_watch) * loop->io_capacity);
-    loop->io_pollfds = (struct pollfd*)jzx_alloc(&loop->allocator, sizeof(struct pollfd) * loop->io_capacity);
+    // Extra pollfd slots, after the watchers, for the wake pipe, signalfd and
+    // timerfd.
+    loop->io_pollfds = (struct pollfd*)jzx_alloc(&loop->allocator,
+                                                 sizeof(struct pollfd) * (loop->io_capacity + JZX_IO_EXTRA_FDS));
     if (!loop->io_pollfds) {
         return JZX_ERR_NO_MEMORY;
     }
-    memset(loop->io_pollfds, 0, sizeof(struct pollfd) * loop->io_capacity);
-    return JZX_OK;
+    memset(loop->io_pollfds, 0, sizeof(struct pollfd) * (loop->io_capacity + JZX_IO_EXTRA_FDS));
+    return jzx_index_map_init(&loop->io_index, loop->io_capacity, &loop->allocator);
 }
 
 static void jzx_io_deinit(jzx_loop* loop) {
@@ -793,6 +2277,7 @@ static void jzx_io_deinit(jzx_loop* loop) {
         jzx_free(&loop->allocator, loop->io_pollfds);
         loop->io_pollfds = NULL;
     }
+    jzx_index_map_deinit(&loop->io_index, &loop->allocator);
     loop->io_capacity = 0;
     loop->io_count = 0;
 }
@@ -802,13 +2287,14 @@ static jzx_err jzx_io_reserve(jzx_loop* loop, uint32_t new_cap) {
     if (!new_watchers) {
         return JZX_ERR_NO_MEMORY;
     }
-    struct pollfd* new_pollfds = (struct pollfd*)jzx_alloc(&loop->allocator, sizeof(struct pollfd) * new_cap);
+    struct pollfd* new_pollfds =
+        (struct pollfd*)jzx_alloc(&loop->allocator, sizeof(struct pollfd) * (new_cap + JZX_IO_EXTRA_FDS));
     if (!new_pollfds) {
         jzx_free(&loop->allocator, new_watchers);
         return JZX_ERR_NO_MEMORY;
     }
     memset(new_watchers, 0, sizeof(jzx_io_watch) * new_cap);
-    memset(new_pollfds, 0, sizeof(struct pollfd) * new_cap);
+    memset(new_pollfds, 0, sizeof(struct pollfd) * (new_cap + JZX_IO_EXTRA_FDS));
     if (loop->io_watchers) {
         memcpy(new_watchers, loop->io_watchers, sizeof(jzx_io_watch) * loop->io_count);
         jzx_free(&loop->allocator, loop->io_watchers);
@@ -824,26 +2310,36 @@ static jzx_err jzx_io_reserve(jzx_loop* loop, uint32_t new_cap) {
     return JZX_OK;
 }
 
+static inline uint64_t jzx_io_key(int fd) {
+    return (uint64_t)(uint32_t)fd;
+}
+
 static jzx_io_watch* jzx_io_find(jzx_loop* loop, int fd, uint32_t* idx_out) {
-    for (uint32_t i = 0; i < loop->io_count; ++i) {
-        if (loop->io_watchers[i].fd == fd) {
-            if (idx_out) {
-                *idx_out = i;
-            }
-            return &loop->io_watchers[i];
-        }
+    uint32_t idx = 0;
+    if (!jzx_index_map_get(&loop->io_index, jzx_io_key(fd), &idx)) {
+        return NULL;
     }
-    return NULL;
+    if (idx_out) {
+        *idx_out = idx;
+    }
+    return &loop->io_watchers[idx];
 }
 
 static void jzx_io_remove_index(jzx_loop* loop, uint32_t idx) {
     if (idx >= loop->io_count) {
         return;
     }
+#ifdef __linux__
+    if (loop->backend_fd >= 0) {
+        epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, loop->io_watchers[idx].fd, NULL);
+    }
+#endif
+    jzx_index_map_remove(&loop->io_index, jzx_io_key(loop->io_watchers[idx].fd));
     uint32_t last = loop->io_count - 1;
     if (idx != last) {
         loop->io_watchers[idx] = loop->io_watchers[last];
         loop->io_pollfds[idx] = loop->io_pollfds[last];
+        jzx_index_map_put_nogrow(&loop->io_index, jzx_io_key(loop->io_watchers[idx].fd), idx);
     }
     loop->io_count--;
     loop->io_dirty = 1;
@@ -886,45 +2382,479 @@ static void jzx_io_rebuild_pollfds(jzx_loop* loop) {
         return;
     }
     for (uint32_t i = 0; i < loop->io_count; ++i) {
-        loop->io_pollfds[i].fd = loop->io_watchers[i].fd;
+        loop->io_pollfds[i].fd = loop->io_watchers[i].armed ? loop->io_watchers[i].fd : -1;
         loop->io_pollfds[i].events = jzx_io_interest_to_poll(loop->io_watchers[i].interest);
         loop->io_pollfds[i].revents = 0;
     }
     loop->io_dirty = 0;
 }
 
+static void jzx_io_disarm(jzx_loop* loop, uint32_t idx) {
+    jzx_io_watch* watch = &loop->io_watchers[idx];
+    watch->armed = 0;
+    loop->io_pollfds[idx].fd = -1;
+#ifdef __linux__
+    if (loop->backend_fd >= 0) {
+        epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, watch->fd, NULL);
+    }
+#endif
+}
+
+// Applies the watch mode to one poll observation and sends at most one event.
+static void jzx_io_deliver(jzx_loop* loop, uint32_t idx, uint32_t readiness) {
+    jzx_io_watch* watch = &loop->io_watchers[idx];
+    if (readiness == 0 || !watch->armed) {
+        return;
+    }
+    if (watch->outstanding) {
+        watch->outstanding->readiness |= readiness;
+        loop->stats.io_events_coalesced++;
+        return;
+    }
+    jzx_actor* prev_charge = jzx_mem_charge_begin_id(loop, watch->owner);
+    jzx_io_event* ev = (jzx_io_event*)jzx_alloc(&loop->allocator, sizeof(jzx_io_event));
+    jzx_mem_charge_end(loop, prev_charge);
+    if (!ev) {
+        return;
+    }
+    ev->fd = watch->fd;
+    ev->readiness = readiness;
+    jzx_err err = jzx_send_internal(loop, watch->owner, ev, sizeof(jzx_io_event), JZX_TAG_SYS_IO, 0);
+    if (err != JZX_OK) {
+        jzx_free(&loop->allocator, ev);
+        return;
+    }
+    loop->stats.io_events++;
+    if (watch->interest & JZX_IO_COALESCE) {
+        watch->outstanding = ev;
+    }
+    if (watch->interest & JZX_IO_ONESHOT) {
+        jzx_io_disarm(loop, idx);
+    }
+}
+
+// Called as the owner dequeues an IO event: from here on the event belongs to
+// the behavior, so a coalescing watch must start a fresh one.
+static void jzx_io_on_dispatch(jzx_loop* loop, const jzx_io_event* ev) {
+    jzx_io_watch* watch = jzx_io_find(loop, ev->fd, NULL);
+    if (watch && watch->outstanding == ev) {
+        watch->outstanding = NULL;
+    }
+}
+
+static void jzx_signal_collect(jzx_loop* loop, int fd_ready);
+
+// Polls the watched fds plus the wake pipe, so a blocking wait also ends on
+// async sends, fired timers and stop requests.
 static void jzx_io_poll(jzx_loop* loop, uint32_t timeout_ms) {
-    if (loop->io_count == 0) {
+    if (loop->io_count == 0 && loop->signal_count == 0 && timeout_ms == 0) {
         return;
     }
     jzx_io_rebuild_pollfds(loop);
-    int wait_ms = (int)timeout_ms;
-    int rv = poll(loop->io_pollfds, loop->io_count, wait_ms);
-    if (rv <= 0) {
+    nfds_t nfds = loop->io_count;
+    if (loop->wake_fds[0] >= 0) {
+        loop->io_pollfds[nfds] = (struct pollfd){
+            .fd = loop->wake_fds[0],
+            .events = POLLIN,
+            .revents = 0,
+        };
+        nfds++;
+    }
+    nfds_t signal_slot = nfds;
+    if (loop->signal_fd >= 0 && loop->signal_count > 0) {
+        loop->io_pollfds[nfds] = (struct pollfd){
+            .fd = loop->signal_fd,
+            .events = POLLIN,
+            .revents = 0,
+        };
+        nfds++;
+    }
+    // The timerfd only needs to end the wait; the tick drains it.
+    if (loop->timer_fd >= 0 && timeout_ms != 0) {
+        loop->io_pollfds[nfds] = (struct pollfd){
+            .fd = loop->timer_fd,
+            .events = POLLIN,
+            .revents = 0,
+        };
+        nfds++;
+    }
+    int wait_ms = timeout_ms > INT32_MAX ? INT32_MAX : (int)timeout_ms;
+    int rv = poll(loop->io_pollfds, nfds, wait_ms);
+    loop->io_polled = 1;
+    if (loop->signal_count > 0) {
+        jzx_signal_collect(loop, rv > 0 && signal_slot < nfds && (loop->io_pollfds[signal_slot].revents & POLLIN));
+    }
+    if (rv < 0) {
         return;
     }
     for (uint32_t i = 0; i < loop->io_count; ++i) {
         struct pollfd* pfd = &loop->io_pollfds[i];
-        if (!pfd->revents) {
-            continue;
-        }
-        uint32_t readiness = jzx_io_revents_to_readiness(pfd->revents);
+        uint32_t readiness = pfd->revents ? jzx_io_revents_to_readiness(pfd->revents) : 0;
         pfd->revents = 0;
-        if (readiness == 0) {
-            continue;
+        jzx_io_deliver(loop, i, readiness);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Signals
+// -----------------------------------------------------------------------------
+
+#ifndef __linux__
+static jzx_loop* _Atomic jzx_signal_loops[JZX_SIGNAL_MAX];
+static struct sigaction jzx_signal_prev[JZX_SIGNAL_MAX];
+
+// Async-signal-safe: an atomic OR and a pipe write.
+static void jzx_signal_handler(int signo) {
+    int saved_errno = errno;
+    jzx_loop* loop = atomic_load_explicit(&jzx_signal_loops[signo], memory_order_acquire);
+    if (loop) {
+        atomic_fetch_or_explicit(&loop->signal_pending, 1ull << signo, memory_order_relaxed);
+        jzx_wake_signal(loop);
+    }
+    errno = saved_errno;
+}
+#endif
+
+// Queues an event for signo, or folds the arrival into the one still waiting
+// in the owner's mailbox.
+static void jzx_signal_note(jzx_loop* loop, int signo, int32_t pid) {
+    jzx_actor_id owner = loop->signal_owners[signo];
+    if (!owner) {
+        return;
+    }
+    jzx_signal_event* pending = loop->signal_outstanding[signo];
+    if (pending) {
+        pending->count++;
+        pending->pid = pid;
+        return;
+    }
+    jzx_actor* prev_charge = jzx_mem_charge_begin_id(loop, owner);
+    jzx_signal_event* ev = (jzx_signal_event*)jzx_alloc(&loop->allocator, sizeof(jzx_signal_event));
+    jzx_mem_charge_end(loop, prev_charge);
+    if (!ev) {
+        return;
+    }
+    ev->signo = signo;
+    ev->count = 1;
+    ev->pid = pid;
+    if (jzx_send_internal(loop, owner, ev, sizeof(jzx_signal_event), JZX_TAG_SYS_SIGNAL, 0) != JZX_OK) {
+        jzx_free(&loop->allocator, ev);
+        return;
+    }
+    loop->signal_outstanding[signo] = ev;
+}
+
+static void jzx_signal_collect(jzx_loop* loop, int fd_ready) {
+#ifdef __linux__
+    if (!fd_ready || loop->signal_fd < 0) {
+        return;
+    }
+    struct signalfd_siginfo info[16];
+    ssize_t n;
+    while ((n = read(loop->signal_fd, info, sizeof(info))) > 0) {
+        for (size_t i = 0; i < (size_t)n / sizeof(info[0]); ++i) {
+            if (info[i].ssi_signo < JZX_SIGNAL_MAX) {
+                jzx_signal_note(loop, (int)info[i].ssi_signo, (int32_t)info[i].ssi_pid);
+            }
         }
-        jzx_io_watch* watch = &loop->io_watchers[i];
-        jzx_io_event* ev = (jzx_io_event*)jzx_alloc(&loop->allocator, sizeof(jzx_io_event));
-        if (!ev) {
-            continue;
+    }
+#else
+    (void)fd_ready;
+    uint64_t bits = atomic_exchange_explicit(&loop->signal_pending, 0, memory_order_relaxed);
+    for (int signo = 1; bits && signo < JZX_SIGNAL_MAX; ++signo) {
+        if (bits & (1ull << signo)) {
+            bits &= ~(1ull << signo);
+            jzx_signal_note(loop, signo, 0);
         }
-        ev->fd = watch->fd;
-        ev->readiness = readiness;
-        jzx_err err = jzx_send_internal(loop, watch->owner, ev, sizeof(jzx_io_event), JZX_TAG_SYS_IO, 0);
-        if (err != JZX_OK) {
-            jzx_free(&loop->allocator, ev);
+    }
+#endif
+}
+
+static void jzx_signal_on_dispatch(jzx_loop* loop, const jzx_signal_event* ev) {
+    if (ev->signo > 0 && ev->signo < JZX_SIGNAL_MAX && loop->signal_outstanding[ev->signo] == ev) {
+        loop->signal_outstanding[ev->signo] = NULL;
+    }
+}
+
+#ifdef __linux__
+// Points the signalfd at the current watch set, creating it on first use.
+static jzx_err jzx_signal_update_fd(jzx_loop* loop) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int signo = 1; signo < JZX_SIGNAL_MAX; ++signo) {
+        if (loop->signal_owners[signo]) {
+            sigaddset(&mask, signo);
+        }
+    }
+    int created = loop->signal_fd < 0;
+    int fd = signalfd(loop->signal_fd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    loop->signal_fd = fd;
+    if (created && loop->backend_fd >= 0) {
+        struct epoll_event ev = {.events = EPOLLIN, .data = {.fd = fd}};
+        (void)epoll_ctl(loop->backend_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    return JZX_OK;
+}
+#endif
+
+static void jzx_signal_release(jzx_loop* loop, int signo) {
+    loop->signal_owners[signo] = 0;
+    loop->signal_outstanding[signo] = NULL;
+    loop->signal_count--;
+#ifdef __linux__
+    // Consume anything already queued before unblocking, so a pending
+    // arrival is not handed to the default disposition.
+    jzx_signal_collect(loop, 1);
+    (void)jzx_signal_update_fd(loop);
+    if (!loop->signal_was_blocked[signo]) {
+        sigset_t one;
+        sigemptyset(&one);
+        sigaddset(&one, signo);
+        pthread_sigmask(SIG_UNBLOCK, &one, NULL);
+    }
+#else
+    sigaction(signo, &jzx_signal_prev[signo], NULL);
+    atomic_store_explicit(&jzx_signal_loops[signo], NULL, memory_order_release);
+#endif
+}
+
+static void jzx_signal_remove_actor(jzx_loop* loop, jzx_actor_id actor) {
+    if (loop->signal_count == 0) {
+        return;
+    }
+    for (int signo = 1; signo < JZX_SIGNAL_MAX; ++signo) {
+        if (loop->signal_owners[signo] == actor) {
+            jzx_signal_release(loop, signo);
+        }
+    }
+}
+
+static void jzx_signal_deinit(jzx_loop* loop) {
+    // Drop every owner first so draining the signalfd sends nothing.
+    jzx_actor_id owners[JZX_SIGNAL_MAX];
+    memcpy(owners, loop->signal_owners, sizeof(owners));
+    memset(loop->signal_owners, 0, sizeof(loop->signal_owners));
+    for (int signo = 1; signo < JZX_SIGNAL_MAX && loop->signal_count > 0; ++signo) {
+        if (owners[signo]) {
+            jzx_signal_release(loop, signo);
+        }
+    }
+    if (loop->signal_fd >= 0) {
+        close(loop->signal_fd);
+        loop->signal_fd = -1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Watchdog
+// -----------------------------------------------------------------------------
+
+#ifdef JZX_HAVE_BACKTRACE
+// Watchdog of the loop whose tick is running on this thread, for the handler.
+static _Thread_local jzx_watchdog* jzx_watchdog_current;
+
+static void jzx_watchdog_on_signal(int signo) {
+    (void)signo;
+    int saved_errno = errno;
+    jzx_watchdog* wd = jzx_watchdog_current;
+    if (wd) {
+        uint64_t seq = atomic_load_explicit(&wd->call_seq, memory_order_relaxed);
+        // Only sample if the overrunning call is still the one running.
+        if (atomic_load_explicit(&wd->call_start_ns, memory_order_relaxed) != 0 &&
+            atomic_load_explicit(&wd->sample_request, memory_order_acquire) == seq) {
+            wd->sample_depth = (uint32_t)backtrace(wd->sample, JZX_WATCHDOG_STACK_MAX);
+            atomic_store_explicit(&wd->sample_seq, seq, memory_order_release);
+        }
+    }
+    errno = saved_errno;
+}
+
+// The sampling handler is process-wide: loops sampling with the same signal
+// share it, and the disposition it replaced comes back with the last of them.
+static pthread_mutex_t jzx_watchdog_sig_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t jzx_watchdog_sig_users[JZX_SIGNAL_MAX];
+static struct sigaction jzx_watchdog_prev[JZX_SIGNAL_MAX];
+
+// Refuses a signal something else already handles (a profiler, the
+// application, jzx_watch_signal) rather than silently taking it over.
+static jzx_err jzx_watchdog_sig_acquire(int signo) {
+    jzx_err err = JZX_OK;
+    pthread_mutex_lock(&jzx_watchdog_sig_mutex);
+    if (jzx_watchdog_sig_users[signo] == 0) {
+        struct sigaction old;
+        if (sigaction(signo, NULL, &old) != 0) {
+            err = JZX_ERR_INVALID_ARG;
+        } else if ((old.sa_flags & SA_SIGINFO) || (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN)) {
+            err = JZX_ERR_IO_REG_FAILED;
+        } else {
+            struct sigaction sa;
+            memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = jzx_watchdog_on_signal;
+            sigemptyset(&sa.sa_mask);
+            sa.sa_flags = SA_RESTART;
+            if (sigaction(signo, &sa, &jzx_watchdog_prev[signo]) != 0) {
+                err = JZX_ERR_INVALID_ARG;
+            }
         }
     }
+    if (err == JZX_OK) {
+        jzx_watchdog_sig_users[signo]++;
+    }
+    pthread_mutex_unlock(&jzx_watchdog_sig_mutex);
+    return err;
+}
+
+static void jzx_watchdog_sig_release(int signo) {
+    pthread_mutex_lock(&jzx_watchdog_sig_mutex);
+    if (--jzx_watchdog_sig_users[signo] == 0) {
+        sigaction(signo, &jzx_watchdog_prev[signo], NULL);
+    }
+    pthread_mutex_unlock(&jzx_watchdog_sig_mutex);
+}
+
+static void* jzx_watchdog_main(void* arg) {
+    jzx_watchdog* wd = (jzx_watchdog*)arg;
+    jzx_block_all_signals();
+    uint64_t signaled = 0;
+    pthread_mutex_lock(&wd->mutex);
+    while (!wd->stop) {
+        uint64_t wait_ns = wd->threshold_ns;
+        uint64_t seq = atomic_load(&wd->call_seq);
+        uint64_t start = atomic_load(&wd->call_start_ns);
+        // A changed seq means start may belong to a later call; look again
+        // on the next round.
+        if (start != 0 && seq != signaled && seq == atomic_load(&wd->call_seq)) {
+            uint64_t due = start + wd->threshold_ns;
+            uint64_t now = jzx_now_ns();
+            if (now >= due) {
+                atomic_store_explicit(&wd->sample_request, seq, memory_order_release);
+                pthread_kill(wd->loop_thread, wd->signo);
+                signaled = seq;
+            } else {
+                wait_ns = due - now;
+            }
+        }
+        uint32_t wait_ms = (uint32_t)((wait_ns + 999999u) / 1000000u);
+        struct timespec ts = jzx_cond_deadline(wait_ms);
+        pthread_cond_timedwait(&wd->cond, &wd->mutex, &ts);
+    }
+    pthread_mutex_unlock(&wd->mutex);
+    return NULL;
+}
+#endif
+
+static jzx_err jzx_watchdog_init(jzx_loop* loop) {
+    jzx_watchdog* wd = &loop->watchdog;
+    wd->threshold_ns = (uint64_t)loop->cfg.watchdog_threshold_us * 1000u;
+    if (!wd->threshold_ns || !(loop->cfg.watchdog_flags & JZX_WATCHDOG_STACK)) {
+        return JZX_OK;
+    }
+#ifdef JZX_HAVE_BACKTRACE
+    wd->signo = loop->cfg.watchdog_signal ? loop->cfg.watchdog_signal : SIGPROF;
+    if (wd->signo <= 0 || wd->signo >= JZX_SIGNAL_MAX || wd->signo == SIGKILL || wd->signo == SIGSTOP) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    // The first backtrace() may load the unwinder; do it outside the handler.
+    void* prime[1];
+    (void)backtrace(prime, 1);
+    jzx_err err = jzx_watchdog_sig_acquire(wd->signo);
+    if (err != JZX_OK) {
+        return err;
+    }
+    if (pthread_mutex_init(&wd->mutex, NULL) != 0) {
+        jzx_watchdog_sig_release(wd->signo);
+        return JZX_ERR_UNKNOWN;
+    }
+    if (jzx_cond_init_monotonic(&wd->cond) != 0) {
+        pthread_mutex_destroy(&wd->mutex);
+        jzx_watchdog_sig_release(wd->signo);
+        return JZX_ERR_UNKNOWN;
+    }
+    if (pthread_create(&wd->thread, NULL, jzx_watchdog_main, wd) != 0) {
+        pthread_cond_destroy(&wd->cond);
+        pthread_mutex_destroy(&wd->mutex);
+        jzx_watchdog_sig_release(wd->signo);
+        return JZX_ERR_UNKNOWN;
+    }
+    wd->sampling = 1;
+#endif
+    return JZX_OK;
+}
+
+static void jzx_watchdog_shutdown(jzx_loop* loop) {
+    jzx_watchdog* wd = &loop->watchdog;
+    if (!wd->sampling) {
+        return;
+    }
+    pthread_mutex_lock(&wd->mutex);
+    wd->stop = 1;
+    pthread_cond_signal(&wd->cond);
+    pthread_mutex_unlock(&wd->mutex);
+    pthread_join(wd->thread, NULL);
+    pthread_cond_destroy(&wd->cond);
+    pthread_mutex_destroy(&wd->mutex);
+#ifdef JZX_HAVE_BACKTRACE
+    jzx_watchdog_sig_release(wd->signo);
+#endif
+    wd->sampling = 0;
+}
+
+// Tick start/end: points the signal handler at this loop for the tick.
+static void jzx_watchdog_attach(jzx_loop* loop, int attach) {
+#ifdef JZX_HAVE_BACKTRACE
+    if (attach) {
+        loop->watchdog.loop_thread = pthread_self();
+        jzx_watchdog_current = &loop->watchdog;
+    } else {
+        jzx_watchdog_current = NULL;
+    }
+#else
+    (void)loop;
+    (void)attach;
+#endif
+}
+
+static inline uint64_t jzx_watchdog_begin(jzx_watchdog* wd) {
+    uint64_t start = jzx_now_ns();
+    atomic_store(&wd->call_seq, atomic_load_explicit(&wd->call_seq, memory_order_relaxed) + 1u);
+    atomic_store(&wd->call_start_ns, start);
+    return start;
+}
+
+// After a timed call: reports it if it overran and applies JZX_WATCHDOG_FAIL.
+static void jzx_watchdog_end(jzx_loop* loop,
+                             jzx_actor_id actor,
+                             uint32_t tag,
+                             uint64_t start_ns,
+                             jzx_behavior_result* result) {
+    jzx_watchdog* wd = &loop->watchdog;
+    uint64_t duration = jzx_now_ns() - start_ns;
+    atomic_store(&wd->call_start_ns, 0);
+    if (duration < wd->threshold_ns) {
+        return;
+    }
+    int sampled = atomic_load_explicit(&wd->sample_seq, memory_order_acquire) ==
+                  atomic_load_explicit(&wd->call_seq, memory_order_relaxed);
+    loop->stats.watchdog_overruns++;
+    loop->stats.watchdog_samples += sampled ? 1u : 0u;
+    if (loop->cfg.watchdog_fn) {
+        jzx_watchdog_report report;
+        memset(&report, 0, sizeof(report));
+        report.actor = actor;
+        report.tag = tag;
+        report.duration_ns = duration;
+        if (sampled) {
+            report.stack_depth = wd->sample_depth;
+            memcpy(report.stack, wd->sample, sizeof(void*) * wd->sample_depth);
+        }
+        loop->cfg.watchdog_fn(loop->cfg.watchdog_ctx, &report);
+    }
+    if ((loop->cfg.watchdog_flags & JZX_WATCHDOG_FAIL) && *result != JZX_BEHAVIOR_STOP) {
+        *result = JZX_BEHAVIOR_FAIL;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -955,6 +2885,7 @@ void jzx_config_init(jzx_config* cfg) {
     cfg->max_actors_per_tick = 1024;
     cfg->max_io_watchers = 1024;
     cfg->io_poll_timeout_ms = 10;
+    cfg->pool_max = 256;
 }
 
 static void apply_defaults(jzx_config* cfg) {
@@ -982,6 +2913,9 @@ static void apply_defaults(jzx_config* cfg) {
     if (cfg->io_poll_timeout_ms == 0) {
         cfg->io_poll_timeout_ms = 10;
     }
+    if (cfg->pool_max == 0) {
+        cfg->pool_max = 256;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -1004,11 +2938,31 @@ jzx_loop* jzx_loop_create(const jzx_config* cfg) {
     memset(loop, 0, sizeof(*loop));
     loop->cfg = local;
     loop->allocator = local.allocator;
+    if (local.mem_accounting || local.actor_mem_limit) {
+        // Everything the loop allocates from here on carries a size header.
+        loop->mem_enabled = 1;
+        loop->mem_thread = pthread_self();
+        loop->allocator.alloc = jzx_mem_alloc;
+        loop->allocator.free = jzx_mem_free;
+        loop->allocator.ctx = loop;
+    }
+    loop->rng_state = local.sched_seed ? local.sched_seed | 1u : (jzx_now_ns() ^ (uint64_t)(uintptr_t)loop) | 1u;
+    atomic_store_explicit(&loop->virtual_now_ns, JZX_VIRTUAL_EPOCH_NS, memory_order_relaxed);
+    loop->wake_fds[0] = -1;
+    loop->wake_fds[1] = -1;
+    loop->backend_fd = -1;
+    loop->signal_fd = -1;
+
+    if (jzx_wake_init(loop) != JZX_OK) {
+        jzx_loop_destroy(loop);
+        return NULL;
+    }
 
     if (jzx_actor_table_init(&loop->actors, local.max_actors, &loop->allocator) != JZX_OK) {
         jzx_loop_destroy(loop);
         return NULL;
     }
+    loop->mem_actors_ready = loop->mem_enabled;
     if (jzx_run_queue_init(&loop->run_queue, local.max_actors, &loop->allocator) != JZX_OK) {
         jzx_loop_destroy(loop);
         return NULL;
@@ -1025,6 +2979,18 @@ jzx_loop* jzx_loop_create(const jzx_config* cfg) {
         jzx_loop_destroy(loop);
         return NULL;
     }
+    if (jzx_offload_init(loop) != JZX_OK) {
+        jzx_loop_destroy(loop);
+        return NULL;
+    }
+    if (jzx_watchdog_init(loop) != JZX_OK) {
+        jzx_loop_destroy(loop);
+        return NULL;
+    }
+    if (jzx_perf_init(loop) != JZX_OK) {
+        jzx_loop_destroy(loop);
+        return NULL;
+    }
     loop->running = 0;
     loop->stop_requested = 0;
     return loop;
@@ -1034,90 +3000,205 @@ void jzx_loop_destroy(jzx_loop* loop) {
     if (!loop) {
         return;
     }
+    // Frees below no longer touch per-actor counters while slots go away.
+    loop->mem_actors_ready = 0;
+    jzx_node_shutdown(loop);
+    jzx_record_shutdown(loop);
+    jzx_watchdog_shutdown(loop);
+    jzx_perf_shutdown(loop);
     jzx_timer_system_shutdown(loop);
+    jzx_offload_shutdown(loop);
     jzx_async_queue_destroy(loop);
     jzx_io_deinit(loop);
-    for (uint32_t i = 0; i < loop->actors.capacity; ++i) {
-        jzx_actor* actor = loop->actors.slots ? loop->actors.slots[i] : NULL;
+    jzx_signal_deinit(loop);
+    jzx_wake_deinit(loop);
+    if (loop->drain_watches) {
+        jzx_free(&loop->allocator, loop->drain_watches);
+    }
+    for (uint32_t i = 0; loop->actors.hot && i < loop->actors.capacity; ++i) {
+        jzx_actor* actor = jzx_actor_table_at(&loop->actors, i);
         if (actor) {
-            jzx_mailbox_deinit(&actor->mailbox, &loop->allocator);
-            jzx_free(&loop->allocator, actor);
-            loop->actors.slots[i] = NULL;
+            jzx_mailbox_deinit(&actor->mailbox, loop);
+            if (loop->actors.cold[i].on_stop) {
+                loop->actors.cold[i].on_stop(loop, actor->state);
+            }
+            if (loop->actors.cold[i].supervisor_state) {
+                jzx_supervisor_state_destroy(loop->actors.cold[i].supervisor_state, &loop->allocator);
+            }
         }
     }
+    for (uint32_t i = 0; i < JZX_MAILBOX_POOL_CLASSES; ++i) {
+        jzx_pool_drain(loop, &loop->mailbox_pools[i]);
+    }
     jzx_actor_table_deinit(&loop->actors, &loop->allocator);
     jzx_run_queue_deinit(&loop->run_queue, &loop->allocator);
-    jzx_free(&loop->allocator, loop);
+    // The loop itself came from the configured allocator, not the shim.
+    jzx_allocator base = loop->cfg.allocator;
+    jzx_free(&base, loop);
 }
 
-int jzx_loop_run(jzx_loop* loop) {
-    if (!loop) {
-        return JZX_ERR_INVALID_ARG;
+static void jzx_publish_load(jzx_loop* loop, uint64_t tick_ns) {
+    uint64_t tick_us64 = tick_ns / 1000ull;
+    uint32_t tick_us = tick_us64 > UINT32_MAX ? UINT32_MAX : (uint32_t)tick_us64;
+    uint32_t avg = atomic_load_explicit(&loop->load_avg_tick_us, memory_order_relaxed);
+    // Exponentially weighted moving average with alpha = 1/8.
+    int64_t delta = (int64_t)tick_us - (int64_t)avg;
+    avg = (uint32_t)((int64_t)avg + delta / 8);
+    atomic_store_explicit(&loop->load_last_tick_us, tick_us, memory_order_relaxed);
+    atomic_store_explicit(&loop->load_avg_tick_us, avg, memory_order_relaxed);
+    atomic_store_explicit(&loop->load_run_queue_len, loop->run_queue.count, memory_order_relaxed);
+}
+
+// One bounded scheduler pass: drain async sends, poll IO without blocking and
+// run up to max_actors_per_tick actors.
+static void jzx_loop_tick(jzx_loop* loop) {
+    uint64_t tick_start_ns = jzx_now_ns();
+    loop->now_ns = loop->cfg.virtual_time ? jzx_loop_clock_ns(loop) : tick_start_ns;
+    loop->stats.ticks++;
+    if (loop->watchdog.sampling) {
+        jzx_watchdog_attach(loop, 1);
+    }
+    jzx_async_drain(loop);
+    if (!loop->io_polled) {
+        jzx_io_poll(loop, 0);
     }
-    if (loop->running) {
-        return JZX_ERR_LOOP_CLOSED;
+    loop->io_polled = 0;
+    jzx_timer_fire_due(loop, loop->now_ns);
+    if (loop->cfg.sched_seed) {
+        jzx_run_queue_shuffle(loop);
     }
-    loop->running = 1;
-    int rc = JZX_OK;
-    while (!loop->stop_requested) {
-        jzx_async_drain(loop);
-        jzx_io_poll(loop, 0);
-        uint32_t actors_processed = 0;
-        while (actors_processed < loop->cfg.max_actors_per_tick) {
-            jzx_actor* actor = jzx_run_queue_pop(&loop->run_queue);
-            if (!actor) {
+    uint32_t actors_processed = 0;
+    while (actors_processed < loop->cfg.max_actors_per_tick) {
+        uint32_t slot = 0;
+        if (jzx_run_queue_pop(&loop->run_queue, &slot) != 0) {
+            break;
+        }
+        jzx_actor* actor = &loop->actors.hot[slot];
+        actor->in_run_queue = 0;
+        if (actor->status == JZX_ACTOR_STOPPING ||
+            actor->status == JZX_ACTOR_FAILED) {
+            jzx_teardown_actor(loop, actor);
+            continue;
+        }
+
+        uint32_t processed_msgs = 0;
+        uint64_t now_ms = 0;
+        loop->current_actor = actor;
+        while (processed_msgs < loop->cfg.max_msgs_per_actor) {
+            jzx_message msg;
+            uint64_t deadline_ms = 0;
+            if (jzx_mailbox_pop(&actor->mailbox, &msg, &deadline_ms) != 0) {
                 break;
             }
-            actor->in_run_queue = 0;
-            if (actor->status == JZX_ACTOR_STOPPING ||
-                actor->status == JZX_ACTOR_FAILED) {
-                jzx_teardown_actor(loop, actor);
-                continue;
-            }
-
-            uint32_t processed_msgs = 0;
-            while (processed_msgs < loop->cfg.max_msgs_per_actor) {
-                jzx_message msg;
-                if (jzx_mailbox_pop(&actor->mailbox, &msg) != 0) {
-                    break;
+            if (deadline_ms != 0) {
+                if (now_ms == 0) {
+                    now_ms = jzx_loop_clock_ms(loop);
                 }
-                jzx_context ctx = {
-                    .state = actor->state,
-                    .self = actor->id,
-                    .loop = loop,
-                };
-                jzx_behavior_result result = actor->behavior(&ctx, &msg);
-                processed_msgs++;
-                if (result == JZX_BEHAVIOR_STOP) {
-                    actor->status = JZX_ACTOR_STOPPING;
-                    break;
-                } else if (result == JZX_BEHAVIOR_FAIL) {
-                    actor->status = JZX_ACTOR_FAILED;
-                    break;
+                if (now_ms > deadline_ms) {
+                    loop->stats.messages_expired++;
+                    jzx_release_message(loop, &msg);
+                    continue;
                 }
             }
-            if (actor->status == JZX_ACTOR_STOPPING ||
-                actor->status == JZX_ACTOR_FAILED) {
+            if (msg.tag == JZX_TAG_SYS_IO && msg.data) {
+                jzx_io_on_dispatch(loop, (const jzx_io_event*)msg.data);
+            } else if (msg.tag == JZX_TAG_SYS_SIGNAL && msg.data) {
+                jzx_signal_on_dispatch(loop, (const jzx_signal_event*)msg.data);
+            }
+            jzx_context ctx = {
+                .state = actor->state,
+                .self = actor->id,
+                .loop = loop,
+            };
+            uint64_t call_start_ns = loop->watchdog.threshold_ns ? jzx_watchdog_begin(&loop->watchdog) : 0;
+            uint64_t perf_before[JZX_PERF_MAX_COUNTERS];
+            int perf_sampled = loop->perf && jzx_perf_begin(loop->perf, perf_before);
+            jzx_behavior_result result = actor->behavior(&ctx, &msg);
+            if (perf_sampled) {
+                jzx_perf_end(loop, actor->id, msg.tag, perf_before);
+            }
+            if (call_start_ns) {
+                jzx_watchdog_end(loop, actor->id, msg.tag, call_start_ns, &result);
+            }
+            processed_msgs++;
+            if (result == JZX_BEHAVIOR_STOP) {
+                actor->status = JZX_ACTOR_STOPPING;
+                break;
+            } else if (result == JZX_BEHAVIOR_FAIL) {
+                actor->status = JZX_ACTOR_FAILED;
+                break;
+            } else if (result == JZX_BEHAVIOR_HIBERNATE) {
+                actor->hibernate_requested = 1;
+            }
+        }
+        loop->current_actor = NULL;
+        if (actor->status == JZX_ACTOR_STOPPING ||
+            actor->status == JZX_ACTOR_FAILED) {
+            // A behavior that messaged itself before stopping is queued again;
+            // the teardown then happens when that entry is popped.
+            if (!actor->in_run_queue) {
                 jzx_teardown_actor(loop, actor);
-            } else if (jzx_mailbox_has_items(&actor->mailbox)) {
+            }
+        } else {
+            if (actor->auto_hibernate) {
+                jzx_actor_cold_of(loop, actor)->last_active_ms = loop->now_ns / 1000000u;
+            }
+            if (actor->drain_watched) {
+                jzx_drain_check(loop, actor, 0);
+            }
+            if (jzx_mailbox_has_items(&actor->mailbox)) {
                 jzx_schedule_actor(loop, actor);
+            } else if (actor->hibernate_requested && jzx_actor_can_hibernate(loop, actor)) {
+                jzx_actor_enter_hibernation(loop, actor);
             }
-            actors_processed++;
         }
+        actors_processed++;
+    }
+    if (loop->drain_retry) {
+        jzx_drain_retry(loop);
+    }
+    jzx_hibernate_sweep(loop, loop->now_ns / 1000000u);
+    if (loop->mem_limit_pending) {
+        jzx_mem_process_limits(loop);
+    }
+    if (loop->watchdog.sampling) {
+        jzx_watchdog_attach(loop, 0);
+    }
+    jzx_publish_load(loop, jzx_now_ns() - tick_start_ns);
+}
 
+static int jzx_loop_is_drained(jzx_loop* loop) {
+    return loop->run_queue.count == 0 &&
+           loop->actors.used == 0 &&
+           !jzx_async_has_pending(loop) &&
+           !jzx_timer_has_pending(loop) &&
+           loop->io_count == 0;
+}
+
+int jzx_loop_run(jzx_loop* loop) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (loop->running) {
+        return JZX_ERR_LOOP_CLOSED;
+    }
+    loop->running = 1;
+    loop->mem_thread = pthread_self();
+    int rc = JZX_OK;
+    while (!loop->stop_requested) {
+        jzx_loop_tick(loop);
         if (loop->run_queue.count == 0) {
-            if (loop->actors.used == 0 &&
-                !jzx_async_has_pending(loop) &&
-                !jzx_timer_has_pending(loop) &&
-                loop->io_count == 0) {
+            if (jzx_loop_is_drained(loop)) {
                 break;
             }
-            jzx_io_poll(loop, loop->cfg.io_poll_timeout_ms);
-            struct timespec ts = {
-                .tv_sec = 0,
-                .tv_nsec = 1000000,
-            };
-            nanosleep(&ts, NULL);
+            // Simulated time skips the wait when a timer is pending.
+            if (loop->cfg.virtual_time && jzx_virtual_advance(loop)) {
+                continue;
+            }
+            // Blocks until IO, an async send, a fired timer or a stop request.
+            if (!loop->stop_requested) {
+                jzx_io_poll(loop, jzx_timer_clamp_wait_ms(loop, loop->cfg.io_poll_timeout_ms));
+            }
         }
     }
     loop->running = 0;
@@ -1125,37 +3206,150 @@ int jzx_loop_run(jzx_loop* loop) {
     return rc;
 }
 
+int jzx_loop_run_once(jzx_loop* loop, uint32_t timeout_ms) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (loop->running) {
+        return JZX_ERR_LOOP_CLOSED;
+    }
+    // Like jzx_loop_run, a stop request ends the drive and is consumed.
+    if (loop->stop_requested) {
+        loop->stop_requested = 0;
+        return 2;
+    }
+    loop->running = 1;
+    loop->mem_thread = pthread_self();
+    if (loop->cfg.virtual_time && loop->run_queue.count == 0 && !jzx_async_has_pending(loop) &&
+        jzx_virtual_advance(loop)) {
+        timeout_ms = 0;
+    }
+    if (timeout_ms != 0 && loop->run_queue.count == 0 && !jzx_async_has_pending(loop)) {
+        int64_t next = jzx_loop_next_deadline(loop);
+        if (next >= 0 && (uint64_t)next < timeout_ms) {
+            timeout_ms = (uint32_t)next;
+        }
+        jzx_io_poll(loop, timeout_ms);
+    }
+    if (!loop->stop_requested) {
+        jzx_loop_tick(loop);
+    }
+    loop->running = 0;
+    if (loop->stop_requested) {
+        loop->stop_requested = 0;
+        return 2;
+    }
+    return jzx_loop_is_drained(loop) ? 0 : 1;
+}
+
+int64_t jzx_loop_next_deadline(jzx_loop* loop) {
+    if (!loop) {
+        return -1;
+    }
+    if (loop->run_queue.count > 0 || jzx_async_has_pending(loop)) {
+        return 0;
+    }
+    if (!loop->timer_mutex_initialized) {
+        return -1;
+    }
+    pthread_mutex_lock(&loop->timer_mutex);
+    int64_t out = -1;
+    if (loop->timer_count && loop->cfg.virtual_time) {
+        // The next jzx_loop_run_once jumps the clock to the deadline.
+        out = 0;
+    } else if (loop->timer_count) {
+        // Timers fire at the end of their slack window; round up so an
+        // embedder's timer never fires before the batch is due.
+        uint64_t now = jzx_loop_clock_ns(loop);
+        uint64_t due = loop->timers[loop->timer_heap[0]].latest_ns;
+        out = due > now ? (int64_t)((due - now + 999999ull) / 1000000ull) : 0;
+    }
+    pthread_mutex_unlock(&loop->timer_mutex);
+    return out;
+}
+
+int jzx_loop_backend_fd(jzx_loop* loop) {
+    return loop ? loop->backend_fd : -1;
+}
+
+uint64_t jzx_loop_now_ms(jzx_loop* loop) {
+    return loop ? jzx_loop_clock_ms(loop) : jzx_now_ms();
+}
+
+uint64_t jzx_loop_now_ns(jzx_loop* loop) {
+    return loop ? jzx_loop_clock_ns(loop) : jzx_now_ns();
+}
+
+jzx_err jzx_loop_advance_ns(jzx_loop* loop, uint64_t ns) {
+    if (!loop || !loop->cfg.virtual_time) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    atomic_fetch_add_explicit(&loop->virtual_now_ns, ns, memory_order_acq_rel);
+    return JZX_OK;
+}
+
+uint64_t jzx_ctx_now_ns(const jzx_context* ctx) {
+    return ctx->loop->now_ns;
+}
+
+jzx_err jzx_loop_get_stats(jzx_loop* loop, jzx_loop_stats* out) {
+    if (!loop || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    *out = loop->stats;
+    out->mem_bytes = atomic_load_explicit(&loop->mem_bytes, memory_order_relaxed);
+    out->mem_peak_bytes = atomic_load_explicit(&loop->mem_peak, memory_order_relaxed);
+    return JZX_OK;
+}
+
+jzx_err jzx_loop_get_load(jzx_loop* loop, jzx_loop_load* out) {
+    if (!loop || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    out->async_depth = atomic_load_explicit(&loop->load_async_depth, memory_order_relaxed);
+    out->run_queue_len = atomic_load_explicit(&loop->load_run_queue_len, memory_order_relaxed);
+    out->last_tick_us = atomic_load_explicit(&loop->load_last_tick_us, memory_order_relaxed);
+    out->avg_tick_us = atomic_load_explicit(&loop->load_avg_tick_us, memory_order_relaxed);
+    return JZX_OK;
+}
+
 void jzx_loop_request_stop(jzx_loop* loop) {
     if (!loop) {
         return;
     }
     loop->stop_requested = 1;
-    if (loop->timer_mutex_initialized) {
-        pthread_mutex_lock(&loop->timer_mutex);
-        pthread_cond_broadcast(&loop->timer_cond);
-        pthread_mutex_unlock(&loop->timer_mutex);
-    }
+    jzx_wake_signal(loop);
 }
 
 // -----------------------------------------------------------------------------
 // Actor APIs
 // -----------------------------------------------------------------------------
 
-static jzx_actor* jzx_actor_create(jzx_loop* loop, const jzx_spawn_opts* opts) {
-    jzx_actor* actor = (jzx_actor*)jzx_alloc(&loop->allocator, sizeof(jzx_actor));
+// Claims a table slot and fills in everything but the mailbox.
+static jzx_actor* jzx_actor_create(jzx_loop* loop,
+                                   const jzx_spawn_opts* opts,
+                                   jzx_actor_id supervisor) {
+    jzx_actor* actor = jzx_actor_table_insert(&loop->actors);
     if (!actor) {
         return NULL;
     }
-    memset(actor, 0, sizeof(*actor));
+    jzx_actor_cold* cold = jzx_actor_cold_of(loop, actor);
     actor->status = JZX_ACTOR_RUNNING;
     actor->behavior = opts->behavior;
     actor->state = opts->state;
-    actor->supervisor = opts->supervisor;
-    if (jzx_mailbox_init(&actor->mailbox,
-                         opts->mailbox_cap ? opts->mailbox_cap : loop->cfg.default_mailbox_cap,
-                         &loop->allocator) != JZX_OK) {
-        jzx_free(&loop->allocator, actor);
-        return NULL;
+    actor->auto_hibernate = opts->hibernate_after_ms != 0;
+    cold->supervisor = supervisor;
+    cold->hibernate_after_ms = opts->hibernate_after_ms;
+    cold->on_hibernate = opts->on_hibernate;
+    cold->on_wake = opts->on_wake;
+    cold->on_stop = opts->on_stop;
+    if (actor->auto_hibernate) {
+        cold->last_active_ms = jzx_loop_clock_ms(loop);
+    }
+    cold->mem_limit = opts->mem_limit ? opts->mem_limit : loop->cfg.actor_mem_limit;
+    cold->mem_action = opts->mem_limit_action ? opts->mem_limit_action : loop->cfg.mem_limit_action;
+    if (cold->mem_action == JZX_MEM_ACTION_DEFAULT) {
+        cold->mem_action = JZX_MEM_NOTIFY;
     }
     return actor;
 }
@@ -1164,45 +3358,131 @@ jzx_err jzx_spawn(jzx_loop* loop, const jzx_spawn_opts* opts, jzx_actor_id* out_
     if (!loop || !opts || !opts->behavior) {
         return JZX_ERR_INVALID_ARG;
     }
-    jzx_actor* actor = jzx_actor_create(loop, opts);
+    // Child exits are delivered locally, so the supervisor must be one of ours.
+    jzx_actor_id supervisor = opts->supervisor;
+    if (supervisor && jzx_id_resolve(loop, &supervisor) != JZX_ID_LOCAL) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = jzx_actor_create(loop, opts, supervisor);
     if (!actor) {
-        return JZX_ERR_NO_MEMORY;
+        return JZX_ERR_MAX_ACTORS;
     }
-    jzx_err err = jzx_actor_table_insert(&loop->actors, actor, &loop->allocator, out_id);
+    // The mailbox is allocated once the actor has an id so it is charged to it.
+    jzx_actor* prev_charge = jzx_mem_charge_begin(loop, actor);
+    jzx_err err = jzx_mailbox_init(&actor->mailbox,
+                                   opts->mailbox_cap ? opts->mailbox_cap : loop->cfg.default_mailbox_cap,
+                                   opts->mailbox_mode,
+                                   loop);
+    jzx_mem_charge_end(loop, prev_charge);
     if (err != JZX_OK) {
-        jzx_mailbox_deinit(&actor->mailbox, &loop->allocator);
-        jzx_free(&loop->allocator, actor);
+        jzx_actor_table_remove(&loop->actors, actor);
         return err;
     }
+    if (actor->auto_hibernate) {
+        loop->hibernate_auto_count++;
+    }
+    if (out_id) {
+        *out_id = actor->id;
+    }
     return JZX_OK;
 }
 
-static jzx_err jzx_send_internal(jzx_loop* loop,
-                                 jzx_actor_id target,
-                                 void* data,
-                                 size_t len,
-                                 uint32_t tag,
-                                 jzx_actor_id sender) {
+static inline void jzx_record_send(jzx_loop* loop,
+                                   jzx_actor_id sender,
+                                   jzx_actor_id target,
+                                   uint32_t tag,
+                                   const void* data,
+                                   size_t len) {
+    if (loop->recorder) {
+        if (!sender && loop->current_actor) {
+            sender = loop->current_actor->id;
+        }
+        jzx_record_note(loop->recorder, jzx_loop_clock_ns(loop), sender, target, tag, data, len);
+    }
+}
+
+static jzx_err jzx_send_internal_deadline(jzx_loop* loop,
+                                          jzx_actor_id target,
+                                          void* data,
+                                          size_t len,
+                                          uint32_t tag,
+                                          jzx_actor_id sender,
+                                          uint64_t deadline_ms) {
     if (!loop) {
         return JZX_ERR_INVALID_ARG;
     }
+    switch (jzx_id_resolve(loop, &target)) {
+    case JZX_ID_LOCAL:
+        break;
+    case JZX_ID_REMOTE: {
+        jzx_err err = jzx_node_route(loop, target, data, len, tag, sender, deadline_ms);
+        if (err == JZX_OK) {
+            // The frame holds a copy; the message is delivered as far as
+            // this loop is concerned.
+            jzx_message msg = {.data = data, .len = len, .tag = tag, .sender = sender};
+            jzx_release_message(loop, &msg);
+        }
+        return err;
+    }
+    default:
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
     jzx_actor* actor = jzx_actor_table_lookup(&loop->actors, target);
     if (!actor) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
+    if (actor->mem_over && jzx_actor_cold_of(loop, actor)->mem_action == JZX_MEM_REJECT) {
+        return JZX_ERR_MEMORY_LIMIT;
+    }
+    jzx_err err = jzx_actor_wake(loop, actor);
+    if (err != JZX_OK) {
+        return err;
+    }
     jzx_message msg = {
         .data = data,
         .len = len,
         .tag = tag,
         .sender = sender,
     };
-    if (jzx_mailbox_push(&actor->mailbox, &msg) != 0) {
-        return JZX_ERR_MAILBOX_FULL;
+    if (deadline_ms == 0) {
+        if (jzx_mailbox_push(&actor->mailbox, &msg) != 0) {
+            return JZX_ERR_MAILBOX_FULL;
+        }
+    } else {
+        jzx_actor* prev_charge = jzx_mem_charge_begin(loop, actor);
+        int rc = jzx_mailbox_push_deadline(&actor->mailbox, &msg, deadline_ms, &loop->allocator);
+        jzx_mem_charge_end(loop, prev_charge);
+        if (rc == -2) {
+            return JZX_ERR_NO_MEMORY;
+        }
+        if (rc != 0) {
+            return JZX_ERR_MAILBOX_FULL;
+        }
     }
+    jzx_record_send(loop, sender, target, tag, data, len);
     jzx_schedule_actor(loop, actor);
     return JZX_OK;
 }
 
+static jzx_err jzx_send_internal(jzx_loop* loop,
+                                 jzx_actor_id target,
+                                 void* data,
+                                 size_t len,
+                                 uint32_t tag,
+                                 jzx_actor_id sender) {
+    return jzx_send_internal_deadline(loop, target, data, len, tag, sender, 0);
+}
+
+jzx_err jzx_send_from(jzx_loop* loop,
+                      jzx_actor_id target,
+                      void* data,
+                      size_t len,
+                      uint32_t tag,
+                      jzx_actor_id sender,
+                      uint64_t deadline_ms) {
+    return jzx_send_internal_deadline(loop, target, data, len, tag, sender, deadline_ms);
+}
+
 jzx_err jzx_send(jzx_loop* loop,
                  jzx_actor_id target,
                  void* data,
@@ -1216,14 +3496,87 @@ jzx_err jzx_send_async(jzx_loop* loop,
                        void* data,
                        size_t len,
                        uint32_t tag) {
-    return jzx_async_enqueue(loop, target, data, len, tag, 0);
+    return jzx_async_enqueue(loop, target, data, len, tag, 0, 0, 1, 0);
+}
+
+jzx_err jzx_send_async_wait(jzx_loop* loop,
+                            jzx_actor_id target,
+                            void* data,
+                            size_t len,
+                            uint32_t tag,
+                            uint32_t timeout_ms) {
+    return jzx_async_enqueue(loop, target, data, len, tag, 0, 0, 1, timeout_ms);
+}
+
+jzx_err jzx_send_deadline(jzx_loop* loop,
+                          jzx_actor_id target,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          uint64_t deadline_ms) {
+    return jzx_send_internal_deadline(loop, target, data, len, tag, 0, deadline_ms);
+}
+
+jzx_err jzx_send_async_deadline(jzx_loop* loop,
+                                jzx_actor_id target,
+                                void* data,
+                                size_t len,
+                                uint32_t tag,
+                                uint64_t deadline_ms) {
+    return jzx_async_enqueue(loop, target, data, len, tag, 0, deadline_ms, 1, 0);
+}
+
+jzx_err jzx_send_keyed(jzx_loop* loop,
+                       jzx_actor_id target,
+                       uint64_t key,
+                       void* data,
+                       size_t len,
+                       uint32_t tag) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_id_kind kind = jzx_id_resolve(loop, &target);
+    if (kind == JZX_ID_REMOTE) {
+        // Conflation happens in the target's mailbox, which is out of reach.
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = kind == JZX_ID_LOCAL ? jzx_actor_table_lookup(&loop->actors, target) : NULL;
+    if (!actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    jzx_message msg = {
+        .data = data,
+        .len = len,
+        .tag = tag,
+        .sender = 0,
+    };
+    if (actor->mem_over && jzx_actor_cold_of(loop, actor)->mem_action == JZX_MEM_REJECT) {
+        return JZX_ERR_MEMORY_LIMIT;
+    }
+    jzx_err err = jzx_actor_wake(loop, actor);
+    if (err != JZX_OK) {
+        return err;
+    }
+    jzx_message replaced;
+    int rc = jzx_mailbox_push_keyed(&actor->mailbox, key, &msg, &replaced);
+    if (rc < 0) {
+        return JZX_ERR_MAILBOX_FULL;
+    }
+    jzx_record_send(loop, 0, target, tag, data, len);
+    if (rc > 0) {
+        loop->stats.messages_conflated++;
+        jzx_release_message(loop, &replaced);
+        return JZX_OK;
+    }
+    jzx_schedule_actor(loop, actor);
+    return JZX_OK;
 }
 
 jzx_err jzx_actor_stop(jzx_loop* loop, jzx_actor_id id) {
     if (!loop) {
         return JZX_ERR_INVALID_ARG;
     }
-    jzx_actor* actor = jzx_actor_table_lookup(&loop->actors, id);
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
     if (!actor) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
@@ -1232,11 +3585,156 @@ jzx_err jzx_actor_stop(jzx_loop* loop, jzx_actor_id id) {
     return JZX_OK;
 }
 
+jzx_err jzx_actor_hibernate(jzx_loop* loop, jzx_actor_id id) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
+    if (!actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    if (actor->hibernated) {
+        return JZX_OK;
+    }
+    if (jzx_actor_is_idle(loop, actor)) {
+        jzx_actor_enter_hibernation(loop, actor);
+    } else {
+        actor->hibernate_requested = 1;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_actor_mailbox_depth(jzx_loop* loop, jzx_actor_id id, uint32_t* out_depth) {
+    if (!loop || !out_depth) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
+    if (!actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    *out_depth = actor->mailbox.count;
+    return JZX_OK;
+}
+
+jzx_err jzx_watch_mailbox(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint32_t depth,
+                          jzx_actor_id watcher,
+                          uint32_t tag) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = jzx_actor_lookup(loop, target);
+    jzx_actor* watcher_actor = jzx_actor_lookup(loop, watcher);
+    if (!actor || !watcher_actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    target = actor->id;
+    watcher = watcher_actor->id;
+    jzx_drain_watch* w = NULL;
+    for (uint32_t i = 0; i < loop->drain_count; ++i) {
+        jzx_drain_watch* it = &loop->drain_watches[i];
+        if (it->target == target && it->watcher == watcher && it->tag == tag) {
+            w = it;
+            break;
+        }
+    }
+    if (!w) {
+        if (loop->drain_count == loop->drain_cap) {
+            uint32_t cap = loop->drain_cap ? loop->drain_cap * 2u : 16u;
+            jzx_drain_watch* grown =
+                (jzx_drain_watch*)jzx_alloc(&loop->allocator, sizeof(jzx_drain_watch) * cap);
+            if (!grown) {
+                return JZX_ERR_NO_MEMORY;
+            }
+            if (loop->drain_watches) {
+                memcpy(grown, loop->drain_watches, sizeof(jzx_drain_watch) * loop->drain_count);
+                jzx_free(&loop->allocator, loop->drain_watches);
+            }
+            loop->drain_watches = grown;
+            loop->drain_cap = cap;
+        }
+        w = &loop->drain_watches[loop->drain_count++];
+        w->target = target;
+        w->watcher = watcher;
+        w->tag = tag;
+    }
+    w->depth = depth;
+    w->fired = 0;
+    jzx_drain_check(loop, actor, 0);
+    return JZX_OK;
+}
+
+void* jzx_loop_alloc(jzx_loop* loop, size_t size) {
+    return loop ? jzx_alloc(&loop->allocator, size) : NULL;
+}
+
+void jzx_loop_free(jzx_loop* loop, void* ptr) {
+    if (loop && ptr) {
+        jzx_free(&loop->allocator, ptr);
+    }
+}
+
+void* jzx_ctx_alloc(jzx_context* ctx, size_t size) {
+    if (!ctx || !ctx->loop) {
+        return NULL;
+    }
+    jzx_loop* loop = ctx->loop;
+    jzx_actor* prev_charge = jzx_mem_charge_begin_id(loop, ctx->self);
+    void* ptr = jzx_alloc(&loop->allocator, size);
+    jzx_mem_charge_end(loop, prev_charge);
+    return ptr;
+}
+
+static void jzx_actor_mem_fill(const jzx_actor* actor, const jzx_actor_cold* cold, jzx_actor_mem* out) {
+    out->id = actor->id;
+    out->bytes = cold->mem_bytes;
+    out->peak_bytes = cold->mem_peak;
+    out->limit = cold->mem_limit;
+}
+
+jzx_err jzx_actor_get_mem(jzx_loop* loop, jzx_actor_id id, jzx_actor_mem* out) {
+    if (!loop || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
+    if (!actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    jzx_actor_mem_fill(actor, jzx_actor_cold_of(loop, actor), out);
+    return JZX_OK;
+}
+
+size_t jzx_loop_mem_top(jzx_loop* loop, jzx_actor_mem* out, size_t cap) {
+    if (!loop || !out || cap == 0) {
+        return 0;
+    }
+    size_t count = 0;
+    for (uint32_t i = 0; i < loop->actors.capacity; ++i) {
+        jzx_actor* actor = jzx_actor_table_at(&loop->actors, i);
+        const jzx_actor_cold* cold = &loop->actors.cold[i];
+        if (!actor || cold->mem_bytes == 0) {
+            continue;
+        }
+        if (count == cap && cold->mem_bytes <= out[cap - 1].bytes) {
+            continue;
+        }
+        // Insertion into the sorted prefix; cap is expected to be small.
+        size_t pos = count < cap ? count++ : cap - 1;
+        while (pos > 0 && out[pos - 1].bytes < cold->mem_bytes) {
+            out[pos] = out[pos - 1];
+            pos--;
+        }
+        jzx_actor_mem_fill(actor, cold, &out[pos]);
+    }
+    return count;
+}
+
 jzx_err jzx_actor_fail(jzx_loop* loop, jzx_actor_id id) {
     if (!loop) {
         return JZX_ERR_INVALID_ARG;
     }
-    jzx_actor* actor = jzx_actor_table_lookup(&loop->actors, id);
+    jzx_actor* actor = jzx_actor_lookup(loop, id);
     if (!actor) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
@@ -1256,6 +3754,9 @@ jzx_err jzx_spawn_supervisor(jzx_loop* loop,
     if (!loop || !init || !init->children || init->child_count == 0) {
         return JZX_ERR_INVALID_ARG;
     }
+    if (init->supervisor.strategy == JZX_SUP_SIMPLE_ONE_FOR_ONE && init->child_count != 1) {
+        return JZX_ERR_INVALID_ARG;
+    }
     jzx_supervisor_state* state = jzx_supervisor_state_create(init, &loop->allocator);
     if (!state) {
         return JZX_ERR_NO_MEMORY;
@@ -1266,6 +3767,11 @@ jzx_err jzx_spawn_supervisor(jzx_loop* loop,
         .supervisor = parent,
         .mailbox_cap = 0,
     };
+    if (state->dynamic) {
+        // Each child can have one CHILD_EXIT and one restart timer outstanding;
+        // size the mailbox so exit storms are never dropped.
+        opts.mailbox_cap = jzx_sat_mul32(loop->cfg.max_actors, 2);
+    }
     jzx_actor_id sup_id = 0;
     jzx_err err = jzx_spawn(loop, &opts, &sup_id);
     if (err != JZX_OK) {
@@ -1277,10 +3783,10 @@ jzx_err jzx_spawn_supervisor(jzx_loop* loop,
         jzx_supervisor_state_destroy(state, &loop->allocator);
         return JZX_ERR_UNKNOWN;
     }
-    sup_actor->supervisor_state = state;
+    jzx_actor_cold_of(loop, sup_actor)->supervisor_state = state;
 
     for (size_t i = 0; i < state->child_count; ++i) {
-        err = jzx_supervisor_spawn_child(loop, sup_id, &state->children[i]);
+        err = jzx_supervisor_spawn_child(loop, sup_id, state, i);
         if (err != JZX_OK) {
             (void)jzx_actor_fail(loop, sup_id);
             return err;
@@ -1300,14 +3806,94 @@ jzx_err jzx_supervisor_child_id(jzx_loop* loop,
     if (!loop || !out_id) {
         return JZX_ERR_INVALID_ARG;
     }
-    jzx_actor* sup_actor = jzx_actor_table_lookup(&loop->actors, supervisor);
-    if (!sup_actor || !sup_actor->supervisor_state) {
+    jzx_supervisor_state* sup = jzx_supervisor_state_of(loop, supervisor);
+    if (!sup) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
-    if (index >= sup_actor->supervisor_state->child_count) {
+    if (index >= sup->child_count) {
         return JZX_ERR_INVALID_ARG;
     }
-    *out_id = sup_actor->supervisor_state->children[index].id;
+    *out_id = sup->children[index].id;
+    return JZX_OK;
+}
+
+jzx_err jzx_supervisor_start_child(jzx_loop* loop,
+                                   jzx_actor_id supervisor,
+                                   void* state,
+                                   jzx_actor_id* out_id) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_supervisor_state* sup = jzx_supervisor_state_of(loop, supervisor);
+    if (!sup) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    if (!sup->dynamic) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    size_t idx = 0;
+    jzx_err err = jzx_supervisor_acquire_slot(sup, &loop->allocator, &idx);
+    if (err != JZX_OK) {
+        return err;
+    }
+    jzx_child_state* child = &sup->children[idx];
+    child->spec = sup->child_template;
+    if (state) {
+        child->spec.state = state;
+    }
+    child->id = 0;
+    child->restart_count = 0;
+    child->in_use = 1;
+    sup->active_count++;
+    err = jzx_supervisor_spawn_child(loop, supervisor, sup, idx);
+    if (err != JZX_OK) {
+        jzx_supervisor_release_slot(sup, idx);
+        return err;
+    }
+    if (out_id) {
+        *out_id = sup->children[idx].id;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_supervisor_terminate_child(jzx_loop* loop,
+                                       jzx_actor_id supervisor,
+                                       jzx_actor_id child_id) {
+    if (!loop) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_supervisor_state* sup = jzx_supervisor_state_of(loop, supervisor);
+    if (!sup) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    if (!sup->dynamic) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (jzx_id_resolve(loop, &child_id) != JZX_ID_LOCAL) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    size_t idx = 0;
+    jzx_child_state* child = jzx_supervisor_find_child(sup, child_id, &idx);
+    if (!child) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    // Unregistering first makes the resulting CHILD_EXIT a no-op for the supervisor.
+    jzx_supervisor_stop_child(loop, sup, child);
+    jzx_supervisor_release_slot(sup, idx);
+    return JZX_OK;
+}
+
+jzx_err jzx_supervisor_count_children(jzx_loop* loop,
+                                      jzx_actor_id supervisor,
+                                      size_t* out_count) {
+    if (!loop || !out_count) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_supervisor_state* sup = jzx_supervisor_state_of(loop, supervisor);
+    if (!sup) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    *out_count = sup->dynamic ? sup->active_count : sup->child_count;
     return JZX_OK;
 }
 
@@ -1315,92 +3901,200 @@ jzx_err jzx_supervisor_child_id(jzx_loop* loop,
 // Timers & IO
 // -----------------------------------------------------------------------------
 
-jzx_err jzx_send_after(jzx_loop* loop,
-                       jzx_actor_id target,
-                       uint32_t ms,
-                       void* data,
-                       size_t len,
-                       uint32_t tag,
-                       jzx_timer_id* out_timer) {
-    if (!loop) {
+static jzx_err jzx_timer_add(jzx_loop* loop,
+                             jzx_actor_id target,
+                             uint64_t delay_ns,
+                             uint64_t period_ns,
+                             uint64_t slack_ns,
+                             void* data,
+                             size_t len,
+                             uint32_t tag,
+                             jzx_timer_id* out_timer) {
+    if (!loop || !loop->timer_mutex_initialized) {
         return JZX_ERR_INVALID_ARG;
     }
-    if (!jzx_actor_table_lookup(&loop->actors, target)) {
+    // Remote targets are routed when the timer fires, so the peer only has
+    // to be connected by then.
+    jzx_id_kind kind = jzx_id_resolve(loop, &target);
+    if (kind == JZX_ID_UNROUTABLE ||
+        (kind == JZX_ID_LOCAL && !jzx_actor_table_lookup(&loop->actors, target))) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
-    jzx_timer_entry* entry = (jzx_timer_entry*)jzx_alloc(&loop->allocator, sizeof(jzx_timer_entry));
-    if (!entry) {
+    pthread_mutex_lock(&loop->timer_mutex);
+    if (loop->timer_free == UINT32_MAX && jzx_timer_grow_locked(loop) != JZX_OK) {
+        pthread_mutex_unlock(&loop->timer_mutex);
         return JZX_ERR_NO_MEMORY;
     }
+    uint32_t slot = loop->timer_free;
+    jzx_timer_entry* entry = &loop->timers[slot];
+    loop->timer_free = entry->next_free;
+    entry->generation++;
+    if (entry->generation == 0) {
+        entry->generation = 1;
+    }
+    entry->id = ((uint64_t)entry->generation << 32u) | slot;
     entry->target = target;
     entry->data = data;
     entry->len = len;
     entry->tag = tag;
-    entry->next = NULL;
-
-    pthread_mutex_lock(&loop->timer_mutex);
-    entry->id = loop->next_timer_id++;
-    entry->due_ms = jzx_now_ms() + (uint64_t)ms;
-    jzx_timer_insert_locked(loop, entry);
-    pthread_cond_broadcast(&loop->timer_cond);
+    entry->period_ns = period_ns;
+    entry->slack_ns = slack_ns;
+    entry->due_ns = jzx_loop_clock_ns(loop) + delay_ns;
+    entry->latest_ns = entry->due_ns + slack_ns;
+    jzx_timer_id id = entry->id;
+    uint32_t pos = loop->timer_count++;
+    jzx_timer_heap_set(loop, pos, slot);
+    jzx_timer_sift_up(loop, pos);
+    // Only a new earliest deadline changes when the loop must wake.
+    int new_top = loop->timer_heap[0] == slot;
+    if (new_top) {
+        jzx_timer_arm_locked(loop);
+    }
     pthread_mutex_unlock(&loop->timer_mutex);
+#ifndef __linux__
+    // Without a timerfd the loop's wait is only bounded by the deadline it
+    // saw when it went to sleep.
+    if (new_top) {
+        jzx_wake_signal(loop);
+    }
+#endif
 
     if (out_timer) {
-        *out_timer = entry->id;
+        *out_timer = id;
     }
     return JZX_OK;
 }
 
+jzx_err jzx_send_after(jzx_loop* loop,
+                       jzx_actor_id target,
+                       uint32_t ms,
+                       void* data,
+                       size_t len,
+                       uint32_t tag,
+                       jzx_timer_id* out_timer) {
+    return jzx_timer_add(loop, target, (uint64_t)ms * 1000000ull, 0, 0, data, len, tag, out_timer);
+}
+
+jzx_err jzx_send_after_slack(jzx_loop* loop,
+                             jzx_actor_id target,
+                             uint32_t ms,
+                             uint32_t slack_ms,
+                             void* data,
+                             size_t len,
+                             uint32_t tag,
+                             jzx_timer_id* out_timer) {
+    return jzx_timer_add(loop, target, (uint64_t)ms * 1000000ull, 0, (uint64_t)slack_ms * 1000000ull, data, len,
+                         tag, out_timer);
+}
+
+jzx_err jzx_send_interval(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint32_t period_ms,
+                          uint32_t slack_ms,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          jzx_timer_id* out_timer) {
+    return jzx_send_interval_ns(loop, target, (uint64_t)period_ms * 1000000ull, (uint64_t)slack_ms * 1000000ull,
+                                data, len, tag, out_timer);
+}
+
+jzx_err jzx_send_after_ns(jzx_loop* loop,
+                          jzx_actor_id target,
+                          uint64_t delay_ns,
+                          uint64_t slack_ns,
+                          void* data,
+                          size_t len,
+                          uint32_t tag,
+                          jzx_timer_id* out_timer) {
+    return jzx_timer_add(loop, target, delay_ns, 0, slack_ns, data, len, tag, out_timer);
+}
+
+jzx_err jzx_send_interval_ns(jzx_loop* loop,
+                             jzx_actor_id target,
+                             uint64_t period_ns,
+                             uint64_t slack_ns,
+                             void* data,
+                             size_t len,
+                             uint32_t tag,
+                             jzx_timer_id* out_timer) {
+    if (period_ns == 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    return jzx_timer_add(loop, target, period_ns, period_ns, slack_ns, data, len, tag, out_timer);
+}
+
 jzx_err jzx_cancel_timer(jzx_loop* loop, jzx_timer_id timer) {
     if (!loop || !loop->timer_mutex_initialized) {
         return JZX_ERR_INVALID_ARG;
     }
     pthread_mutex_lock(&loop->timer_mutex);
-    jzx_timer_entry* prev = NULL;
-    jzx_timer_entry* cur = loop->timer_head;
-    while (cur) {
-        if (cur->id == timer) {
-            if (prev) {
-                prev->next = cur->next;
-            } else {
-                loop->timer_head = cur->next;
-            }
-            pthread_mutex_unlock(&loop->timer_mutex);
-            jzx_free(&loop->allocator, cur);
-            return JZX_OK;
-        }
-        prev = cur;
-        cur = cur->next;
+    jzx_timer_entry* entry = jzx_timer_lookup_locked(loop, timer);
+    if (!entry) {
+        pthread_mutex_unlock(&loop->timer_mutex);
+        return JZX_ERR_TIMER_INVALID;
     }
+    jzx_timer_remove_locked(loop, entry);
+    jzx_timer_arm_locked(loop);
     pthread_mutex_unlock(&loop->timer_mutex);
-    return JZX_ERR_TIMER_INVALID;
+    return JZX_OK;
 }
 
 jzx_err jzx_watch_fd(jzx_loop* loop, int fd, jzx_actor_id owner, uint32_t interest) {
-    if (!loop || fd < 0 || interest == 0) {
+    if (!loop || fd < 0 || (interest & (JZX_IO_READ | JZX_IO_WRITE)) == 0) {
         return JZX_ERR_INVALID_ARG;
     }
-    if (!jzx_actor_table_lookup(&loop->actors, owner)) {
+    jzx_actor* owner_actor = jzx_actor_lookup(loop, owner);
+    if (!owner_actor) {
         return JZX_ERR_NO_SUCH_ACTOR;
     }
+    owner = owner_actor->id;
     jzx_io_watch* existing = jzx_io_find(loop, fd, NULL);
+#ifdef __linux__
+    // Best effort: fds epoll rejects (regular files) are still polled by the
+    // loop itself, they just do not make the backend fd readable.
+    if (loop->backend_fd >= 0) {
+        struct epoll_event ev = {.events = jzx_io_interest_to_epoll(interest), .data = {.fd = fd}};
+        int op = existing && existing->armed ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        (void)epoll_ctl(loop->backend_fd, op, fd, &ev);
+    }
+#endif
     if (existing) {
         existing->owner = owner;
         existing->interest = interest;
+        existing->armed = 1;
+        // An event still queued for the previous registration stays with
+        // whoever receives it; new readiness starts a fresh one.
+        existing->outstanding = NULL;
         loop->io_dirty = 1;
         return JZX_OK;
     }
     if (loop->io_count == loop->io_capacity) {
         jzx_err err = jzx_io_reserve(loop, loop->io_capacity * 2);
         if (err != JZX_OK) {
+#ifdef __linux__
+            if (loop->backend_fd >= 0) {
+                epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, NULL);
+            }
+#endif
             return err;
         }
     }
+    jzx_err err = jzx_index_map_put(&loop->io_index, jzx_io_key(fd), loop->io_count, &loop->allocator);
+    if (err != JZX_OK) {
+#ifdef __linux__
+        if (loop->backend_fd >= 0) {
+            epoll_ctl(loop->backend_fd, EPOLL_CTL_DEL, fd, NULL);
+        }
+#endif
+        return err;
+    }
     loop->io_watchers[loop->io_count] = (jzx_io_watch){
         .fd = fd,
         .owner = owner,
         .interest = interest,
         .active = 1,
+        .armed = 1,
     };
     loop->io_pollfds[loop->io_count] = (struct pollfd){
         .fd = fd,
@@ -1424,3 +4118,172 @@ jzx_err jzx_unwatch_fd(jzx_loop* loop, int fd) {
     jzx_io_remove_index(loop, idx);
     return JZX_OK;
 }
+
+jzx_err jzx_rearm_fd(jzx_loop* loop, int fd) {
+    if (!loop || fd < 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    uint32_t idx = 0;
+    jzx_io_watch* watch = jzx_io_find(loop, fd, &idx);
+    if (!watch) {
+        return JZX_ERR_IO_NOT_WATCHED;
+    }
+    if (watch->armed) {
+        return JZX_OK;
+    }
+    watch->armed = 1;
+    loop->io_pollfds[idx].fd = fd;
+#ifdef __linux__
+    if (loop->backend_fd >= 0) {
+        struct epoll_event ev = {.events = jzx_io_interest_to_epoll(watch->interest), .data = {.fd = fd}};
+        (void)epoll_ctl(loop->backend_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+#endif
+    return JZX_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Offload APIs
+// -----------------------------------------------------------------------------
+
+jzx_err jzx_offload(jzx_loop* loop,
+                    jzx_offload_fn fn,
+                    void* arg,
+                    jzx_actor_id reply_to,
+                    uint32_t tag,
+                    jzx_offload_id* out_id) {
+    if (!loop || !fn || !loop->offload.initialized) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_offload_pool* pool = &loop->offload;
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->count == pool->capacity) {
+        pool->stats.rejected++;
+        pthread_mutex_unlock(&pool->mutex);
+        return JZX_ERR_OVERLOADED;
+    }
+    uint32_t slot = (pool->head + pool->count) % pool->capacity;
+    jzx_offload_id id = pool->next_id++;
+    pool->jobs[slot] = (jzx_offload_job){
+        .fn = fn,
+        .arg = arg,
+        .reply_to = reply_to,
+        .tag = tag,
+        .id = id,
+        .submit_ns = jzx_now_ns(),
+    };
+    pool->count++;
+    pool->stats.submitted++;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+    if (out_id) {
+        *out_id = id;
+    }
+    return JZX_OK;
+}
+
+jzx_err jzx_offload_cancel(jzx_loop* loop, jzx_offload_id id) {
+    if (!loop || !loop->offload.initialized) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_offload_pool* pool = &loop->offload;
+    pthread_mutex_lock(&pool->mutex);
+    for (uint32_t i = 0; i < pool->count; ++i) {
+        uint32_t slot = (pool->head + i) % pool->capacity;
+        if (pool->jobs[slot].id != id) {
+            continue;
+        }
+        // Close the gap so FIFO order of the remaining jobs is preserved.
+        for (uint32_t j = i; j + 1 < pool->count; ++j) {
+            uint32_t dst = (pool->head + j) % pool->capacity;
+            uint32_t src = (pool->head + j + 1) % pool->capacity;
+            pool->jobs[dst] = pool->jobs[src];
+        }
+        pool->count--;
+        pool->stats.cancelled++;
+        pthread_mutex_unlock(&pool->mutex);
+        return JZX_OK;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return JZX_ERR_OFFLOAD_INVALID;
+}
+
+jzx_err jzx_offload_get_stats(jzx_loop* loop, jzx_offload_stats* out) {
+    if (!loop || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_offload_pool* pool = &loop->offload;
+    if (!pool->initialized) {
+        memset(out, 0, sizeof(*out));
+        return JZX_OK;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    *out = pool->stats;
+    out->queued = pool->count;
+    pthread_mutex_unlock(&pool->mutex);
+    return JZX_OK;
+}
+
+jzx_err jzx_watch_signal(jzx_loop* loop, int signo, jzx_actor_id owner) {
+    if (!loop || signo <= 0 || signo >= JZX_SIGNAL_MAX || signo == SIGKILL || signo == SIGSTOP) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_actor* owner_actor = jzx_actor_lookup(loop, owner);
+    if (!owner_actor) {
+        return JZX_ERR_NO_SUCH_ACTOR;
+    }
+    owner = owner_actor->id;
+    if (loop->signal_owners[signo]) {
+        loop->signal_owners[signo] = owner;
+        loop->signal_outstanding[signo] = NULL;
+        return JZX_OK;
+    }
+#ifdef __linux__
+    sigset_t one;
+    sigset_t old;
+    sigemptyset(&one);
+    sigaddset(&one, signo);
+    if (pthread_sigmask(SIG_BLOCK, &one, &old) != 0) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    loop->signal_was_blocked[signo] = sigismember(&old, signo) == 1;
+    loop->signal_owners[signo] = owner;
+    jzx_err err = jzx_signal_update_fd(loop);
+    if (err != JZX_OK) {
+        loop->signal_owners[signo] = 0;
+        if (!loop->signal_was_blocked[signo]) {
+            pthread_sigmask(SIG_UNBLOCK, &one, NULL);
+        }
+        return err;
+    }
+#else
+    jzx_loop* expected = NULL;
+    if (!atomic_compare_exchange_strong(&jzx_signal_loops[signo], &expected, loop)) {
+        // Another loop already owns this signal process-wide.
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = jzx_signal_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(signo, &sa, &jzx_signal_prev[signo]) != 0) {
+        atomic_store(&jzx_signal_loops[signo], NULL);
+        return JZX_ERR_INVALID_ARG;
+    }
+    loop->signal_owners[signo] = owner;
+#endif
+    loop->signal_count++;
+    return JZX_OK;
+}
+
+jzx_err jzx_unwatch_signal(jzx_loop* loop, int signo) {
+    if (!loop || signo <= 0 || signo >= JZX_SIGNAL_MAX) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (!loop->signal_owners[signo]) {
+        return JZX_ERR_IO_NOT_WATCHED;
+    }
+    jzx_signal_release(loop, signo);
+    return JZX_OK;
+}
@@ -0,0 +1,788 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // memfd_create, MSG_CMSG_CLOEXEC
+#endif
+
+#include "jzx/shm.h"
+#include "jzx_internal.h"
+
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define JZX_SHM_MAGIC 0x314d48535a584a00ull // "\0JZXSHM1"
+#define JZX_SHM_VERSION 2u
+#define JZX_SHM_DEFAULT_RING (1u << 20)
+#define JZX_SHM_MIN_RING 4096u
+#define JZX_SHM_MAX_RING (1u << 30)
+// Record header length marking the rest of the ring as unused; the consumer
+// skips to offset 0.
+#define JZX_SHM_PAD UINT32_MAX
+// Records drained per activation before the reader yields to other actors.
+#define JZX_SHM_DRAIN_BATCH 256u
+// Only when a full mailbox cannot be watched, or memory ran out.
+#define JZX_SHM_RETRY_MS 1u
+#define JZX_SHM_TAG_DRAIN 0xffff0402u
+
+// -----------------------------------------------------------------------------
+// Shared layout
+// -----------------------------------------------------------------------------
+
+// One direction. head is written only by the producer and tail only by the
+// consumer; each sits on its own cache line, as do the wakeup flags both
+// sides touch.
+typedef struct {
+    _Alignas(64) _Atomic uint64_t head;
+    _Alignas(64) _Atomic uint64_t tail;
+    // Set by the consumer before it goes idle; the producer clears it and
+    // writes the eventfd when it finds it set.
+    _Alignas(64) _Atomic uint32_t waiting;
+    // Set by the producer when a proxy found the ring full; the consumer
+    // clears it once it has freed space and writes the other direction's
+    // eventfd, waking the producer's reader to flush its proxies.
+    _Alignas(64) _Atomic uint32_t full;
+} jzx_shm_ring;
+
+// Mapped at offset 0 of the memfd, followed by ring 0's data (creator to
+// acceptor) and ring 1's data (acceptor to creator).
+typedef struct {
+    _Alignas(64) uint64_t magic;
+    uint32_t version;
+    uint32_t ring_bytes;
+    _Atomic uint64_t roots[2];
+    jzx_shm_ring rings[2];
+} jzx_shm_region;
+
+// Records are 16-byte aligned, so a pad marker always fits before the end.
+typedef struct {
+    uint32_t len;
+    uint32_t tag;
+    uint64_t target;
+} jzx_shm_record;
+
+_Static_assert(sizeof(jzx_shm_record) == 16, "shm record header must stay 16 bytes");
+_Static_assert(sizeof(jzx_shm_region) % 64 == 0, "shm ring data must start cache-aligned");
+
+// Payload bytes plus header, rounded to the record alignment.
+static inline uint64_t jzx_shm_record_size(uint64_t len) {
+    return (sizeof(jzx_shm_record) + len + 15u) & ~(uint64_t)15u;
+}
+
+// A message a proxy took from its mailbox while the ring was full. Its
+// payload is handed to cfg.release only once it is in the ring.
+typedef struct jzx_shm_held {
+    jzx_message msg;
+    struct jzx_shm_held* next;
+} jzx_shm_held;
+
+typedef struct jzx_shm_proxy_state {
+    jzx_shm_link* link;
+    jzx_actor_id self;
+    jzx_actor_id remote;
+    jzx_shm_held* held;
+    jzx_shm_held* held_tail;
+    struct jzx_shm_proxy_state* next;
+} jzx_shm_proxy_state;
+
+struct jzx_shm_link {
+    jzx_loop* loop;
+    jzx_shm_region* region;
+    size_t map_len;
+    jzx_shm_ring* out;
+    jzx_shm_ring* in;
+    uint8_t* out_data;
+    uint8_t* in_data;
+    uint64_t mask;
+    int side; // 0 = creator, 1 = acceptor
+    int sock;
+    int out_efd; // written to wake the peer's reader
+    int in_efd;  // watched by our reader
+    jzx_actor_id reader;
+    jzx_actor_id owner;
+    int down;
+    int retry_pending;
+    jzx_shm_proxy_state* proxies;
+    jzx_shm_stats stats;
+};
+
+// -----------------------------------------------------------------------------
+// Ring operations
+// -----------------------------------------------------------------------------
+
+static jzx_err jzx_shm_ring_put(jzx_shm_link* link,
+                                jzx_actor_id target,
+                                const void* data,
+                                size_t len,
+                                uint32_t tag) {
+    uint64_t cap = link->mask + 1u;
+    uint64_t need = jzx_shm_record_size(len);
+    if (need > cap / 2u) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_shm_ring* ring = link->out;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint64_t off = head & link->mask;
+    uint64_t pad = off + need > cap ? cap - off : 0;
+    if (head + pad + need - tail > cap) {
+        link->stats.send_full++;
+        return JZX_ERR_OVERLOADED;
+    }
+    if (pad) {
+        jzx_shm_record* marker = (jzx_shm_record*)(link->out_data + off);
+        marker->len = JZX_SHM_PAD;
+        head += pad;
+        off = 0;
+    }
+    jzx_shm_record* rec = (jzx_shm_record*)(link->out_data + off);
+    rec->len = (uint32_t)len;
+    rec->tag = tag;
+    rec->target = target;
+    if (len) {
+        memcpy(rec + 1, data, len);
+    }
+    // Publishing head and then reading the flag must not be reordered against
+    // the reader's store of the flag and re-read of head (see jzx_shm_drain).
+    atomic_store_explicit(&ring->head, head + need, memory_order_seq_cst);
+    link->stats.sent++;
+    if (atomic_exchange_explicit(&ring->waiting, 0u, memory_order_seq_cst)) {
+        uint64_t one = 1;
+        if (write(link->out_efd, &one, sizeof(one)) == (ssize_t)sizeof(one)) {
+            link->stats.wakeups++;
+        }
+    }
+    return JZX_OK;
+}
+
+static void jzx_shm_mark_down(jzx_shm_link* link) {
+    if (link->down) {
+        return;
+    }
+    link->down = 1;
+    (void)jzx_unwatch_fd(link->loop, link->sock);
+    (void)jzx_unwatch_fd(link->loop, link->in_efd);
+    if (link->owner) {
+        (void)jzx_send(link->loop, link->owner, NULL, 0, JZX_TAG_SHM_DOWN);
+    }
+}
+
+// Drains again once `full_target` (0 = none) has room, or after a short
+// delay when there is nothing to watch.
+static void jzx_shm_schedule_retry(jzx_shm_link* link, jzx_actor_id full_target) {
+    if (link->retry_pending) {
+        return;
+    }
+    if ((full_target &&
+         jzx_watch_mailbox(link->loop, full_target, UINT32_MAX, link->reader, JZX_SHM_TAG_DRAIN) == JZX_OK) ||
+        jzx_send_after(link->loop, link->reader, JZX_SHM_RETRY_MS, NULL, 0, JZX_SHM_TAG_DRAIN, NULL) ==
+            JZX_OK) {
+        link->retry_pending = 1;
+    }
+}
+
+// Delivers up to a batch of inbound records. A record whose target's mailbox
+// is full stays at the tail until the target drains, so a slow receiver
+// backs up into the ring and from there into the peer's sends.
+static void jzx_shm_drain_batch(jzx_shm_link* link) {
+    jzx_shm_ring* ring = link->in;
+    uint64_t cap = link->mask + 1u;
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    for (uint32_t n = 0; n < JZX_SHM_DRAIN_BATCH;) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (head - tail > cap) {
+            // The peer never gets more than a ring ahead; treat it as corrupt.
+            jzx_shm_mark_down(link);
+            return;
+        }
+        if (head == tail) {
+            atomic_store_explicit(&ring->waiting, 1u, memory_order_seq_cst);
+            if (atomic_load_explicit(&ring->head, memory_order_seq_cst) == tail) {
+                return;
+            }
+            atomic_store_explicit(&ring->waiting, 0u, memory_order_relaxed);
+            continue;
+        }
+        uint64_t off = tail & link->mask;
+        const jzx_shm_record* rec = (const jzx_shm_record*)(link->in_data + off);
+        if (rec->len == JZX_SHM_PAD) {
+            tail += cap - off;
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+            continue;
+        }
+        uint32_t len = rec->len;
+        uint64_t size = jzx_shm_record_size(len);
+        if (size > cap / 2u || off + size > cap || size > head - tail) {
+            // The peer never writes this; treat the ring as corrupt.
+            jzx_shm_mark_down(link);
+            return;
+        }
+        void* copy = NULL;
+        if (len) {
+            copy = jzx_loop_alloc(link->loop, len);
+            if (!copy) {
+                jzx_shm_schedule_retry(link, 0);
+                return;
+            }
+            memcpy(copy, rec + 1, len);
+        }
+        jzx_actor_id target = (jzx_actor_id)rec->target;
+        jzx_err err = jzx_send(link->loop, target, copy, len, rec->tag);
+        if (err == JZX_ERR_MAILBOX_FULL || err == JZX_ERR_MEMORY_LIMIT) {
+            jzx_loop_free(link->loop, copy);
+            link->stats.redeliveries++;
+            jzx_shm_schedule_retry(link, err == JZX_ERR_MAILBOX_FULL ? target : 0);
+            return;
+        }
+        if (err == JZX_OK) {
+            link->stats.received++;
+        } else {
+            jzx_loop_free(link->loop, copy);
+            link->stats.dropped++;
+        }
+        tail += size;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+        ++n;
+    }
+    // Batch used up with records left: continue after the actors queued
+    // behind us have run.
+    if (jzx_send(link->loop, link->reader, NULL, 0, JZX_SHM_TAG_DRAIN) == JZX_OK) {
+        link->retry_pending = 1;
+    }
+}
+
+static void jzx_shm_drain(jzx_shm_link* link) {
+    jzx_shm_drain_batch(link);
+    // Storing tail and then reading the flag pairs with the producer's store
+    // of the flag and re-read of tail (see jzx_shm_proxy_put).
+    if (!link->down && atomic_load_explicit(&link->in->full, memory_order_seq_cst) &&
+        atomic_exchange_explicit(&link->in->full, 0u, memory_order_seq_cst)) {
+        uint64_t one = 1;
+        if (write(link->out_efd, &one, sizeof(one)) == (ssize_t)sizeof(one)) {
+            link->stats.wakeups++;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Actors
+// -----------------------------------------------------------------------------
+
+static void jzx_shm_check_socket(jzx_shm_link* link) {
+    char buf[64];
+    for (;;) {
+        ssize_t n = recv(link->sock, buf, sizeof(buf), 0);
+        if (n > 0) {
+            continue; // nothing is sent after the handshake; ignore
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        break;
+    }
+    jzx_shm_mark_down(link);
+}
+
+static void jzx_shm_release(jzx_loop* loop, const jzx_message* msg) {
+    if (loop->cfg.release) {
+        loop->cfg.release(loop->cfg.release_ctx, msg);
+    }
+}
+
+// Puts msg into the ring for p's remote actor. Returns 0 if the ring is full;
+// the peer's reader then wakes ours once it has made room.
+static int jzx_shm_proxy_put(jzx_shm_proxy_state* p, const jzx_message* msg) {
+    jzx_shm_link* link = p->link;
+    jzx_err err = jzx_shm_ring_put(link, p->remote, msg->data, msg->len, msg->tag);
+    if (err == JZX_ERR_OVERLOADED) {
+        atomic_store_explicit(&link->out->full, 1u, memory_order_seq_cst);
+        // The reader may have made room before seeing the flag.
+        err = jzx_shm_ring_put(link, p->remote, msg->data, msg->len, msg->tag);
+        if (err == JZX_ERR_OVERLOADED) {
+            return 0;
+        }
+    }
+    if (err != JZX_OK) {
+        // Larger than half the ring: it can never be sent.
+        link->stats.dropped++;
+    }
+    jzx_shm_release(link->loop, msg);
+    return 1;
+}
+
+// Sends p's held messages in order until the ring fills again.
+static void jzx_shm_proxy_flush(jzx_shm_proxy_state* p) {
+    while (p->held && jzx_shm_proxy_put(p, &p->held->msg)) {
+        jzx_shm_held* h = p->held;
+        p->held = h->next;
+        jzx_loop_free(p->link->loop, h);
+    }
+    if (!p->held) {
+        p->held_tail = NULL;
+    }
+}
+
+static void jzx_shm_proxy_drop_held(jzx_shm_proxy_state* p) {
+    while (p->held) {
+        jzx_shm_held* h = p->held;
+        p->held = h->next;
+        p->link->stats.dropped++;
+        jzx_shm_release(p->link->loop, &h->msg);
+        jzx_loop_free(p->link->loop, h);
+    }
+    p->held_tail = NULL;
+}
+
+static jzx_behavior_result jzx_shm_reader_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_shm_link* link = (jzx_shm_link*)ctx->state;
+    if (msg->tag == JZX_SHM_TAG_DRAIN) {
+        link->retry_pending = 0;
+        jzx_shm_drain(link);
+        return JZX_BEHAVIOR_OK;
+    }
+    if (msg->tag != JZX_TAG_SYS_IO || !msg->data) {
+        return JZX_BEHAVIOR_OK;
+    }
+    jzx_io_event* ev = (jzx_io_event*)msg->data;
+    int fd = ev->fd;
+    jzx_loop_free(link->loop, ev);
+    if (fd == link->in_efd) {
+        uint64_t count;
+        (void)read(link->in_efd, &count, sizeof(count));
+        for (jzx_shm_proxy_state* p = link->proxies; p && !link->down; p = p->next) {
+            jzx_shm_proxy_flush(p);
+        }
+        // A pending retry drains anyway; draining now would only jump the
+        // records ahead of a full mailbox.
+        if (!link->retry_pending) {
+            jzx_shm_drain(link);
+        }
+    } else if (fd == link->sock && !link->down) {
+        jzx_shm_check_socket(link);
+    }
+    return JZX_BEHAVIOR_OK;
+}
+
+static jzx_behavior_result jzx_shm_proxy_behavior(jzx_context* ctx, const jzx_message* msg) {
+    jzx_shm_proxy_state* p = (jzx_shm_proxy_state*)ctx->state;
+    jzx_shm_link* link = p->link;
+    if (link->down) {
+        link->stats.dropped++;
+        jzx_shm_release(link->loop, msg);
+        return JZX_BEHAVIOR_OK;
+    }
+    // Later messages queue behind held ones to keep the order.
+    if (!p->held && jzx_shm_proxy_put(p, msg)) {
+        return JZX_BEHAVIOR_OK;
+    }
+    jzx_shm_held* h = (jzx_shm_held*)jzx_loop_alloc(link->loop, sizeof(jzx_shm_held));
+    if (!h) {
+        link->stats.dropped++;
+        jzx_shm_release(link->loop, msg);
+        return JZX_BEHAVIOR_OK;
+    }
+    h->msg = *msg;
+    h->next = NULL;
+    if (p->held_tail) {
+        p->held_tail->next = h;
+    } else {
+        p->held = h;
+    }
+    p->held_tail = h;
+    link->stats.proxy_held++;
+    return JZX_BEHAVIOR_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Setup
+// -----------------------------------------------------------------------------
+
+static void jzx_shm_link_free(jzx_shm_link* link) {
+    jzx_loop* loop = link->loop;
+    jzx_shm_proxy_state* p = link->proxies;
+    while (p) {
+        jzx_shm_proxy_state* next = p->next;
+        (void)jzx_actor_stop(loop, p->self);
+        jzx_shm_proxy_drop_held(p);
+        jzx_loop_free(loop, p);
+        p = next;
+    }
+    if (link->reader) {
+        (void)jzx_actor_stop(loop, link->reader);
+    }
+    if (link->in_efd >= 0) {
+        (void)jzx_unwatch_fd(loop, link->in_efd);
+        close(link->in_efd);
+    }
+    if (link->out_efd >= 0) {
+        close(link->out_efd);
+    }
+    if (link->sock >= 0) {
+        if (!link->down) {
+            (void)jzx_unwatch_fd(loop, link->sock);
+        }
+        close(link->sock);
+    }
+    if (link->region) {
+        munmap(link->region, link->map_len);
+    }
+    jzx_loop_free(loop, link);
+}
+
+static jzx_shm_link* jzx_shm_link_new(jzx_loop* loop, int sock, const jzx_shm_opts* opts) {
+    jzx_shm_link* link = (jzx_shm_link*)jzx_loop_alloc(loop, sizeof(jzx_shm_link));
+    if (!link) {
+        return NULL;
+    }
+    memset(link, 0, sizeof(*link));
+    link->loop = loop;
+    link->sock = sock;
+    link->out_efd = -1;
+    link->in_efd = -1;
+    link->owner = opts ? opts->owner : 0;
+    return link;
+}
+
+// Points the link at its halves of the mapped region and starts the reader.
+// Takes ownership of sock on success.
+static jzx_err jzx_shm_link_start(jzx_shm_link* link, const jzx_shm_opts* opts) {
+    jzx_shm_region* r = link->region;
+    uint8_t* data = (uint8_t*)(r + 1);
+    link->mask = (uint64_t)r->ring_bytes - 1u;
+    link->out = &r->rings[link->side];
+    link->in = &r->rings[1 - link->side];
+    link->out_data = data + (size_t)r->ring_bytes * (size_t)link->side;
+    link->in_data = data + (size_t)r->ring_bytes * (size_t)(1 - link->side);
+    atomic_store_explicit(&r->roots[link->side], opts ? opts->root : 0, memory_order_release);
+
+    int flags = fcntl(link->sock, F_GETFL, 0);
+    if (flags < 0 || fcntl(link->sock, F_SETFL, flags | O_NONBLOCK) != 0) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    jzx_spawn_opts spawn = {.behavior = jzx_shm_reader_behavior, .state = link};
+    jzx_err err = jzx_spawn(link->loop, &spawn, &link->reader);
+    if (err != JZX_OK) {
+        return err;
+    }
+    err = jzx_watch_fd(link->loop, link->in_efd, link->reader, JZX_IO_READ);
+    if (err == JZX_OK) {
+        err = jzx_watch_fd(link->loop, link->sock, link->reader, JZX_IO_READ);
+        if (err != JZX_OK) {
+            (void)jzx_unwatch_fd(link->loop, link->in_efd);
+        }
+    }
+    if (err != JZX_OK) {
+        // Let the caller close the fds without the loop still polling them.
+        (void)jzx_actor_stop(link->loop, link->reader);
+        link->reader = 0;
+        link->down = 1;
+        return err;
+    }
+    // Anything the peer sent before the reader existed found the flag clear
+    // and did not signal; look once.
+    return jzx_send(link->loop, link->reader, NULL, 0, JZX_SHM_TAG_DRAIN);
+}
+
+static uint32_t jzx_shm_ring_size(uint32_t want) {
+    if (want == 0) {
+        return JZX_SHM_DEFAULT_RING;
+    }
+    uint32_t size = JZX_SHM_MIN_RING;
+    while (size < want && size < JZX_SHM_MAX_RING) {
+        size <<= 1;
+    }
+    return size;
+}
+
+jzx_err jzx_shm_connect(jzx_loop* loop, int sock, const jzx_shm_opts* opts, jzx_shm_link** out) {
+    if (!loop || sock < 0 || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    uint32_t ring_bytes = jzx_shm_ring_size(opts ? opts->ring_bytes : 0);
+    size_t map_len = sizeof(jzx_shm_region) + 2u * (size_t)ring_bytes;
+    jzx_shm_link* link = jzx_shm_link_new(loop, sock, opts);
+    if (!link) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    link->side = 0;
+    int mem_fd = memfd_create("jzx-shm", MFD_CLOEXEC);
+    int efd0 = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int efd1 = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    jzx_err err = JZX_ERR_IO_REG_FAILED;
+    if (mem_fd < 0 || efd0 < 0 || efd1 < 0 || ftruncate(mem_fd, (off_t)map_len) != 0) {
+        goto fail;
+    }
+    void* map = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, 0);
+    if (map == MAP_FAILED) {
+        goto fail;
+    }
+    link->region = (jzx_shm_region*)map;
+    link->map_len = map_len;
+    // The memfd starts zeroed: heads, tails and roots are already 0.
+    link->region->version = JZX_SHM_VERSION;
+    link->region->ring_bytes = ring_bytes;
+    atomic_store_explicit(&link->region->rings[0].waiting, 1u, memory_order_relaxed);
+    atomic_store_explicit(&link->region->rings[1].waiting, 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    link->region->magic = JZX_SHM_MAGIC;
+
+    int fds[3] = {mem_fd, efd0, efd1};
+    char cbuf[CMSG_SPACE(sizeof(fds))];
+    memset(cbuf, 0, sizeof(cbuf));
+    char byte = 'J';
+    struct iovec iov = {.iov_base = &byte, .iov_len = 1};
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = cbuf;
+    mh.msg_controllen = sizeof(cbuf);
+    struct cmsghdr* cm = CMSG_FIRSTHDR(&mh);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+    ssize_t sent;
+    do {
+        sent = sendmsg(sock, &mh, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != 1) {
+        goto fail;
+    }
+    close(mem_fd);
+    mem_fd = -1;
+    // Ring 0 carries our sends; the peer watches efd0 for it.
+    link->out_efd = efd0;
+    link->in_efd = efd1;
+    efd0 = efd1 = -1;
+    err = jzx_shm_link_start(link, opts);
+    if (err != JZX_OK) {
+        goto fail;
+    }
+    *out = link;
+    return JZX_OK;
+
+fail:
+    if (mem_fd >= 0) {
+        close(mem_fd);
+    }
+    if (efd0 >= 0) {
+        close(efd0);
+    }
+    if (efd1 >= 0) {
+        close(efd1);
+    }
+    link->sock = -1; // still the caller's
+    jzx_shm_link_free(link);
+    return err;
+}
+
+jzx_err jzx_shm_accept(jzx_loop* loop, int sock, const jzx_shm_opts* opts, uint32_t timeout_ms, jzx_shm_link** out) {
+    if (!loop || sock < 0 || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    struct pollfd pfd = {.fd = sock, .events = POLLIN};
+    int ready;
+    do {
+        ready = poll(&pfd, 1, (int)timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    int fds[3] = {-1, -1, -1};
+    char cbuf[CMSG_SPACE(sizeof(fds))];
+    char byte;
+    struct iovec iov = {.iov_base = &byte, .iov_len = 1};
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = cbuf;
+    mh.msg_controllen = sizeof(cbuf);
+    ssize_t got;
+    do {
+        got = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+    } while (got < 0 && errno == EINTR);
+    if (got != 1) {
+        return JZX_ERR_IO_REG_FAILED;
+    }
+    for (struct cmsghdr* cm = CMSG_FIRSTHDR(&mh); cm; cm = CMSG_NXTHDR(&mh, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS &&
+            cm->cmsg_len == CMSG_LEN(sizeof(fds))) {
+            memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+        }
+    }
+    jzx_err err = JZX_ERR_IO_REG_FAILED;
+    jzx_shm_link* link = NULL;
+    struct stat st;
+    if (fds[0] < 0 || fds[1] < 0 || fds[2] < 0 || (mh.msg_flags & MSG_CTRUNC) || fstat(fds[0], &st) != 0 ||
+        (size_t)st.st_size < sizeof(jzx_shm_region)) {
+        goto fail;
+    }
+    link = jzx_shm_link_new(loop, sock, opts);
+    if (!link) {
+        err = JZX_ERR_NO_MEMORY;
+        goto fail;
+    }
+    link->side = 1;
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    if (map == MAP_FAILED) {
+        goto fail;
+    }
+    link->region = (jzx_shm_region*)map;
+    link->map_len = (size_t)st.st_size;
+    uint32_t ring_bytes = link->region->ring_bytes;
+    if (link->region->magic != JZX_SHM_MAGIC || link->region->version != JZX_SHM_VERSION ||
+        ring_bytes < JZX_SHM_MIN_RING || (ring_bytes & (ring_bytes - 1u)) ||
+        link->map_len < sizeof(jzx_shm_region) + 2u * (size_t)ring_bytes) {
+        goto fail;
+    }
+    close(fds[0]);
+    fds[0] = -1;
+    link->out_efd = fds[2];
+    link->in_efd = fds[1];
+    fds[1] = fds[2] = -1;
+    err = jzx_shm_link_start(link, opts);
+    if (err != JZX_OK) {
+        goto fail;
+    }
+    *out = link;
+    return JZX_OK;
+
+fail:
+    for (int i = 0; i < 3; ++i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+    if (link) {
+        link->sock = -1;
+        jzx_shm_link_free(link);
+    }
+    return err;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+jzx_actor_id jzx_shm_peer_root(jzx_shm_link* link) {
+    if (!link) {
+        return 0;
+    }
+    return (jzx_actor_id)atomic_load_explicit(&link->region->roots[1 - link->side], memory_order_acquire);
+}
+
+jzx_err jzx_shm_send(jzx_shm_link* link, jzx_actor_id target, const void* data, size_t len, uint32_t tag) {
+    if (!link || (len && !data) || len > UINT32_MAX - 1u) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    if (link->down) {
+        return JZX_ERR_LOOP_CLOSED;
+    }
+    return jzx_shm_ring_put(link, target, data, len, tag);
+}
+
+jzx_err jzx_shm_proxy(jzx_shm_link* link, jzx_actor_id remote, jzx_actor_id* out_proxy) {
+    if (!link || !out_proxy) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    jzx_shm_proxy_state* p = (jzx_shm_proxy_state*)jzx_loop_alloc(link->loop, sizeof(jzx_shm_proxy_state));
+    if (!p) {
+        return JZX_ERR_NO_MEMORY;
+    }
+    memset(p, 0, sizeof(*p));
+    p->link = link;
+    p->remote = remote;
+    jzx_spawn_opts spawn = {.behavior = jzx_shm_proxy_behavior, .state = p};
+    jzx_err err = jzx_spawn(link->loop, &spawn, &p->self);
+    if (err != JZX_OK) {
+        jzx_loop_free(link->loop, p);
+        return err;
+    }
+    p->next = link->proxies;
+    link->proxies = p;
+    *out_proxy = p->self;
+    return JZX_OK;
+}
+
+jzx_err jzx_shm_get_stats(jzx_shm_link* link, jzx_shm_stats* out) {
+    if (!link || !out) {
+        return JZX_ERR_INVALID_ARG;
+    }
+    *out = link->stats;
+    return JZX_OK;
+}
+
+void jzx_shm_close(jzx_shm_link* link) {
+    if (link) {
+        jzx_shm_link_free(link);
+    }
+}
+
+#else // !__linux__
+
+struct jzx_shm_link {
+    int unused;
+};
+
+jzx_err jzx_shm_connect(jzx_loop* loop, int sock, const jzx_shm_opts* opts, jzx_shm_link** out) {
+    (void)loop;
+    (void)sock;
+    (void)opts;
+    (void)out;
+    return JZX_ERR_UNKNOWN;
+}
+
+jzx_err jzx_shm_accept(jzx_loop* loop, int sock, const jzx_shm_opts* opts, uint32_t timeout_ms, jzx_shm_link** out) {
+    (void)loop;
+    (void)sock;
+    (void)opts;
+    (void)timeout_ms;
+    (void)out;
+    return JZX_ERR_UNKNOWN;
+}
+
+jzx_actor_id jzx_shm_peer_root(jzx_shm_link* link) {
+    (void)link;
+    return 0;
+}
+
+jzx_err jzx_shm_send(jzx_shm_link* link, jzx_actor_id target, const void* data, size_t len, uint32_t tag) {
+    (void)link;
+    (void)target;
+    (void)data;
+    (void)len;
+    (void)tag;
+    return JZX_ERR_UNKNOWN;
+}
+
+jzx_err jzx_shm_proxy(jzx_shm_link* link, jzx_actor_id remote, jzx_actor_id* out_proxy) {
+    (void)link;
+    (void)remote;
+    (void)out_proxy;
+    return JZX_ERR_UNKNOWN;
+}
+
+jzx_err jzx_shm_get_stats(jzx_shm_link* link, jzx_shm_stats* out) {
+    (void)link;
+    (void)out;
+    return JZX_ERR_UNKNOWN;
+}
+
+void jzx_shm_close(jzx_shm_link* link) {
+    (void)link;
+}
+
+#endif // __linux__
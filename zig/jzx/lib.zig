@@ -2,6 +2,13 @@ const std = @import("std");
 
 pub const c = @cImport({
     @cInclude("jzx/jzx.h");
+    @cInclude("jzx/net.h");
+    @cInclude("jzx/file.h");
+    @cInclude("jzx/record.h");
+    @cInclude("jzx/perf.h");
+    @cInclude("jzx/metrics.h");
+    @cInclude("jzx/shm.h");
+    @cInclude("jzx/node.h");
 });
 
 pub const LoopError = error{
@@ -11,10 +18,13 @@ pub const LoopError = error{
     NoSuchActor,
     IoRegistrationFailed,
     NotWatched,
+    Overloaded,
+    OffloadInvalid,
+    MemoryLimit,
     Unknown,
 };
 
-pub const BehaviorResult = enum { ok, stop, fail };
+pub const BehaviorResult = enum { ok, stop, fail, hibernate };
 
 pub const ActorContext = struct {
     loop: *c.jzx_loop,
@@ -24,6 +34,7 @@ pub const ActorContext = struct {
 pub const SpawnOptions = struct {
     supervisor: c.jzx_actor_id = 0,
     mailbox_cap: u32 = 0,
+    mailbox_mode: c.jzx_mailbox_mode = c.JZX_MAILBOX_FIFO,
 };
 
 pub const Loop = struct {
@@ -58,6 +69,26 @@ pub const Loop = struct {
         c.jzx_loop_request_stop(self.ptr);
     }
 
+    /// Runs a single tick, waiting up to `timeout_ms` if idle. Returns false
+    /// once every actor has exited and nothing is pending, or when a stop was
+    /// requested.
+    pub fn runOnce(self: *Loop, timeout_ms: u32) !bool {
+        const rc = c.jzx_loop_run_once(self.ptr, timeout_ms);
+        if (rc < 0) return mapError(rc);
+        return rc == 1;
+    }
+
+    /// Milliseconds until the next tick is needed, or null if nothing is scheduled.
+    pub fn nextDeadline(self: *Loop) ?u64 {
+        const ms = c.jzx_loop_next_deadline(self.ptr);
+        if (ms < 0) return null;
+        return @intCast(ms);
+    }
+
+    pub fn backendFd(self: *Loop) c_int {
+        return c.jzx_loop_backend_fd(self.ptr);
+    }
+
     pub fn watchFd(self: *Loop, fd: c_int, actor: c.jzx_actor_id, interest: u32) !void {
         const rc = c.jzx_watch_fd(self.ptr, fd, actor, interest);
         if (rc == c.JZX_OK) return;
@@ -69,6 +100,18 @@ pub const Loop = struct {
         if (rc == c.JZX_OK) return;
         return mapError(rc);
     }
+
+    pub fn watchSignal(self: *Loop, signo: c_int, actor: c.jzx_actor_id) !void {
+        const rc = c.jzx_watch_signal(self.ptr, signo, actor);
+        if (rc == c.JZX_OK) return;
+        return mapError(rc);
+    }
+
+    pub fn unwatchSignal(self: *Loop, signo: c_int) !void {
+        const rc = c.jzx_unwatch_signal(self.ptr, signo);
+        if (rc == c.JZX_OK) return;
+        return mapError(rc);
+    }
 };
 
 fn ensurePointerType(comptime T: type) void {
@@ -111,6 +154,7 @@ pub fn Actor(comptime State: type, comptime MsgPtr: type) type {
                 .state = shim,
                 .supervisor = opts.supervisor,
                 .mailbox_cap = opts.mailbox_cap,
+                .mailbox_mode = opts.mailbox_mode,
             };
             var actor_id: c.jzx_actor_id = 0;
             const rc = c.jzx_spawn(loop, &spawn_opts, &actor_id);
@@ -159,6 +203,7 @@ pub fn Actor(comptime State: type, comptime MsgPtr: type) type {
                 .ok => c.JZX_BEHAVIOR_OK,
                 .stop => c.JZX_BEHAVIOR_STOP,
                 .fail => c.JZX_BEHAVIOR_FAIL,
+                .hibernate => c.JZX_BEHAVIOR_HIBERNATE,
             };
         }
     };
@@ -171,6 +216,9 @@ fn mapError(code: c_int) LoopError {
         c.JZX_ERR_NO_SUCH_ACTOR => LoopError.NoSuchActor,
         c.JZX_ERR_IO_REG_FAILED => LoopError.IoRegistrationFailed,
         c.JZX_ERR_IO_NOT_WATCHED => LoopError.NotWatched,
+        c.JZX_ERR_OVERLOADED => LoopError.Overloaded,
+        c.JZX_ERR_OFFLOAD_INVALID => LoopError.OffloadInvalid,
+        c.JZX_ERR_MEMORY_LIMIT => LoopError.MemoryLimit,
         else => LoopError.Unknown,
     };
 }
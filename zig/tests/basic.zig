@@ -109,6 +109,172 @@ test "async send dispatches message" {
     try std.testing.expectEqual(@as(u32, 7), state);
 }
 
+test "embedded loop is driven through the backend fd" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state = TimerState{ .target = 2 };
+    var opts = c.jzx_spawn_opts{
+        .behavior = timer_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    try std.testing.expectEqual(@as(?u64, null), loop.nextDeadline());
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_after(loop.ptr, actor_id, 5, null, 0, 0, null));
+    try std.testing.expect(loop.nextDeadline().? <= 5);
+
+    var payload: u32 = 1;
+    var thread = try std.Thread.spawn(.{}, async_sender, .{AsyncArgs{
+        .loop = loop.ptr,
+        .actor = actor_id,
+        .payload = &payload,
+    }});
+    defer thread.join();
+
+    const fd = loop.backendFd();
+    try std.testing.expect(fd >= 0);
+    var spins: u32 = 0;
+    while (try loop.runOnce(0)) : (spins += 1) {
+        try std.testing.expect(spins < 1000);
+        var fds = [_]posix.pollfd{.{ .fd = fd, .events = posix.POLL.IN, .revents = 0 }};
+        const timeout: i32 = if (loop.nextDeadline()) |ms| @intCast(ms) else 1000;
+        _ = try posix.poll(&fds, timeout);
+    }
+    try std.testing.expectEqual(@as(u32, 2), state.hits);
+}
+
+test "embedded loop reports and consumes a stop request" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = increment_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    loop.requestStop();
+    try std.testing.expectEqual(@as(c_int, 2), c.jzx_loop_run_once(loop.ptr, 0));
+    // Consumed: the next tick runs normally.
+    var payload: u32 = 3;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, &payload, @sizeOf(u32), 0));
+    try std.testing.expect(c.jzx_loop_run_once(loop.ptr, 0) != 2);
+    try std.testing.expectEqual(@as(u32, 3), state);
+}
+
+test "async admission rejects past high water mark" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.async_high_water = 2;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = increment_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    var payload: u32 = 1;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_async(loop.ptr, actor_id, &payload, @sizeOf(u32), 0));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_async(loop.ptr, actor_id, &payload, @sizeOf(u32), 0));
+    try std.testing.expectEqual(c.JZX_ERR_OVERLOADED, c.jzx_send_async(loop.ptr, actor_id, &payload, @sizeOf(u32), 0));
+    try std.testing.expectEqual(c.JZX_ERR_OVERLOADED, c.jzx_send_async_wait(loop.ptr, actor_id, &payload, @sizeOf(u32), 0, 5));
+
+    var load: c.jzx_loop_load = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_load(loop.ptr, &load));
+    try std.testing.expectEqual(@as(u32, 2), load.async_depth);
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 1), state);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_load(loop.ptr, &load));
+    try std.testing.expectEqual(@as(u32, 0), load.async_depth);
+}
+
+const OffloadState = struct {
+    results: u32 = 0,
+    sum: usize = 0,
+};
+
+fn doubleJob(arg: ?*anyopaque) callconv(.c) ?*anyopaque {
+    std.Thread.sleep(10 * std.time.ns_per_ms);
+    return @ptrFromInt(@intFromPtr(arg) * 2);
+}
+
+fn offloadBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*OffloadState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    state.results += 1;
+    state.sum += @intFromPtr(msg_ptr.data);
+    return if (state.results == 3) c.JZX_BEHAVIOR_STOP else c.JZX_BEHAVIOR_OK;
+}
+
+test "offload pool delivers results and honours its queue bound" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.offload_threads = 1;
+    cfg.offload_queue_cap = 4;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state = OffloadState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = offloadBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    var ids: [8]c.jzx_offload_id = undefined;
+    var submitted: usize = 0;
+    var rejected: usize = 0;
+    var arg: usize = 1;
+    while (arg <= 8) : (arg += 1) {
+        var id: c.jzx_offload_id = 0;
+        const rc = c.jzx_offload(loop.ptr, doubleJob, @ptrFromInt(arg), actor_id, 1, &id);
+        if (rc == c.JZX_OK) {
+            ids[submitted] = id;
+            submitted += 1;
+        } else {
+            try std.testing.expectEqual(c.JZX_ERR_OVERLOADED, rc);
+            rejected += 1;
+        }
+    }
+    try std.testing.expect(rejected > 0);
+    try std.testing.expect(submitted >= 4);
+
+    // The single worker is still on the first job, so everything past the
+    // third is still queued and can be cancelled.
+    for (ids[3..submitted]) |id| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_offload_cancel(loop.ptr, id));
+    }
+    try std.testing.expectEqual(c.JZX_ERR_OFFLOAD_INVALID, c.jzx_offload_cancel(loop.ptr, ids[3]));
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 3), state.results);
+    try std.testing.expectEqual(@as(usize, 2 * (1 + 2 + 3)), state.sum);
+
+    var stats: c.jzx_offload_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_offload_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 3), stats.completed);
+    try std.testing.expectEqual(@as(u64, rejected), stats.rejected);
+}
+
 test "timer delivers message" {
     var loop = try jzx.Loop.create(null);
     defer loop.deinit();
@@ -182,171 +348,1538 @@ test "many timers fire" {
     try std.testing.expectEqual(timer_count, timer_state.hits);
 }
 
-const PingPongState = struct {
-    loop: *c.jzx_loop,
-    partner: *?c.jzx_actor_id,
-    remaining: u32,
-    hits: u32,
+test "interval timer re-fires until its target stops" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var timer_state = TimerState{ .target = 3 };
+    var opts = c.jzx_spawn_opts{
+        .behavior = timer_behavior,
+        .state = &timer_state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    var timer_id: c.jzx_timer_id = 0;
+    try std.testing.expectEqual(c.JZX_ERR_INVALID_ARG, c.jzx_send_interval(loop.ptr, actor_id, 0, 0, null, 0, 0, &timer_id));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_interval(loop.ptr, actor_id, 2, 1, null, 0, 0, &timer_id));
+
+    // run() returns once the stopped target's interval has cancelled itself.
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 3), timer_state.hits);
+    try std.testing.expectEqual(c.JZX_ERR_TIMER_INVALID, c.jzx_cancel_timer(loop.ptr, timer_id));
+}
+
+test "timers with slack share a wakeup" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    const timer_count: u32 = 16;
+    var timer_state = TimerState{ .target = timer_count };
+    var opts = c.jzx_spawn_opts{
+        .behavior = timer_behavior,
+        .state = &timer_state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    var i: u32 = 0;
+    while (i < timer_count) : (i += 1) {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send_after_slack(loop.ptr, actor_id, i, 50, null, 0, 0, null));
+    }
+    try loop.run();
+
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, timer_count), stats.timers_fired);
+    try std.testing.expect(stats.timer_wakeups <= 2);
+}
+
+const NowState = struct {
+    fired_ns: u64 = 0,
 };
 
-fn pingPongBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
-    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
-    const state = @as(*PingPongState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+fn nowBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
     _ = msg;
-    state.hits += 1;
-    if (state.remaining == 0) {
-        return c.JZX_BEHAVIOR_STOP;
-    }
-    state.remaining -= 1;
-    if (state.partner.*) |partner_id| {
-        var payload: u32 = 1;
-        _ = c.jzx_send(state.loop, partner_id, &payload, @sizeOf(u32), 0);
-    }
-    return c.JZX_BEHAVIOR_OK;
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*NowState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    state.fired_ns = c.jzx_ctx_now_ns(ctx);
+    return c.JZX_BEHAVIOR_STOP;
 }
 
-test "ping pong actors share work fairly" {
-    var loop = try jzx.Loop.create(null);
+test "nanosecond timer fires on the monotonic clock" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.io_poll_timeout_ms = 1000;
+    var loop = try jzx.Loop.create(cfg);
     defer loop.deinit();
 
-    var id_a: c.jzx_actor_id = 0;
-    var id_b: c.jzx_actor_id = 0;
-    var partner_a: ?c.jzx_actor_id = 0;
-    var partner_b: ?c.jzx_actor_id = 0;
-    var state_a = PingPongState{ .loop = loop.ptr, .partner = &partner_a, .remaining = 10, .hits = 0 };
-    var state_b = PingPongState{ .loop = loop.ptr, .partner = &partner_b, .remaining = 10, .hits = 0 };
+    var state = NowState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = nowBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
 
-    var opts_a = c.jzx_spawn_opts{ .behavior = pingPongBehavior, .state = &state_a, .supervisor = 0, .mailbox_cap = 0 };
-    var opts_b = c.jzx_spawn_opts{ .behavior = pingPongBehavior, .state = &state_b, .supervisor = 0, .mailbox_cap = 0 };
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts_a, &id_a));
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts_b, &id_b));
-    partner_a = id_b;
-    partner_b = id_a;
+    const start = c.jzx_loop_now_ns(loop.ptr);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_after_ns(loop.ptr, actor_id, 300_000, 0, null, 0, 0, null));
+    try loop.run();
+    // The tick that delivered it started after the deadline, and well before
+    // the 1s poll timeout would have ended the wait.
+    try std.testing.expect(state.fired_ns >= start + 300_000);
+    try std.testing.expect(state.fired_ns < start + 500_000_000);
+}
 
-    var init: u32 = 1;
-    _ = c.jzx_send(loop.ptr, id_a, &init, @sizeOf(u32), 0);
-    _ = c.jzx_send(loop.ptr, id_b, &init, @sizeOf(u32), 0);
+test "virtual time jumps to the next timer deadline" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.virtual_time = 1;
+    cfg.sched_seed = 42;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+    try std.testing.expectEqual(@as(u64, c.JZX_VIRTUAL_EPOCH_NS), c.jzx_loop_now_ns(loop.ptr));
+
+    var timer_state = TimerState{ .target = 3 };
+    var opts = c.jzx_spawn_opts{
+        .behavior = timer_behavior,
+        .state = &timer_state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    // An hourly interval: three fires take three simulated hours.
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_interval(loop.ptr, actor_id, 3_600_000, 0, null, 0, 0, null));
 
+    const wall_start = std.time.milliTimestamp();
     try loop.run();
-    try std.testing.expectEqual(@as(u32, 11), state_a.hits);
-    try std.testing.expectEqual(@as(u32, 11), state_b.hits);
+    try std.testing.expectEqual(@as(u32, 3), timer_state.hits);
+    try std.testing.expect(c.jzx_loop_now_ms(loop.ptr) >= 1000 + 3 * 3_600_000);
+    try std.testing.expect(std.time.milliTimestamp() - wall_start < 1000);
 }
 
-const CounterState = struct {
-    total: u32 = 0,
+const WatchdogState = struct {
+    reports: u32 = 0,
+    last: c.jzx_watchdog_report = undefined,
 };
 
-const CounterMsg = struct {
-    value: u32,
+fn slowBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    _ = ctx;
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    if (msg_ptr.tag == 9) {
+        std.Thread.sleep(30 * std.time.ns_per_ms);
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+fn watchdogReport(ctx: ?*anyopaque, report: [*c]const c.jzx_watchdog_report) callconv(.c) void {
+    const state = @as(*WatchdogState, @ptrCast(@alignCast(ctx.?)));
+    state.reports += 1;
+    state.last = report.*;
+}
+
+test "watchdog reports and fails an overrunning behavior" {
+    var state = WatchdogState{};
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.watchdog_threshold_us = 10_000;
+    cfg.watchdog_flags = c.JZX_WATCHDOG_STACK | c.JZX_WATCHDOG_FAIL;
+    cfg.watchdog_fn = watchdogReport;
+    cfg.watchdog_ctx = &state;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var opts = c.jzx_spawn_opts{
+        .behavior = slowBehavior,
+        .state = null,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, null, 0, 1));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, null, 0, 9));
+    for (0..3) |_| {
+        _ = c.jzx_loop_run_once(loop.ptr, 0);
+    }
+
+    try std.testing.expectEqual(@as(u32, 1), state.reports);
+    try std.testing.expectEqual(actor_id, state.last.actor);
+    try std.testing.expectEqual(@as(u32, 9), state.last.tag);
+    try std.testing.expect(state.last.duration_ns >= 30 * std.time.ns_per_ms);
+    // JZX_WATCHDOG_FAIL tore the actor down once the call returned.
+    try std.testing.expectEqual(c.JZX_ERR_NO_SUCH_ACTOR, c.jzx_send(loop.ptr, actor_id, null, 0, 1));
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 1), stats.watchdog_overruns);
+}
+
+test "perf counters accumulate per actor and per tag" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.perf_counters = 1;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var opts = c.jzx_spawn_opts{
+        .behavior = slowBehavior,
+        .state = null,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    for (0..4) |i| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, null, 0, @intCast(i % 2)));
+    }
+    _ = c.jzx_loop_run_once(loop.ptr, 0);
+
+    var stats: c.jzx_perf_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_perf_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 4), stats.calls);
+    try std.testing.expectEqual(@as(u32, 2), stats.tags);
+    var counts: c.jzx_perf_counts = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_perf_get_actor(loop.ptr, actor_id, &counts));
+    try std.testing.expectEqual(@as(u64, 4), counts.calls);
+    var tags: [4]c.jzx_perf_tag_counts = undefined;
+    var tag_count: u32 = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_perf_get_tags(loop.ptr, &tags, tags.len, &tag_count));
+    try std.testing.expectEqual(@as(u32, 2), tag_count);
+    for (tags[0..tag_count]) |entry| {
+        try std.testing.expectEqual(@as(u64, 2), entry.counts.calls);
+    }
+}
+
+test "perf tag map stops growing at its cap" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.perf_counters = 1;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var opts = c.jzx_spawn_opts{
+        .behavior = slowBehavior,
+        .state = null,
+        .supervisor = 0,
+        .mailbox_cap = 4096,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    const extra = 100;
+    for (0..c.JZX_PERF_MAX_TAGS + extra) |i| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, null, 0, @intCast(10 + i)));
+    }
+    for (0..50) |_| {
+        _ = c.jzx_loop_run_once(loop.ptr, 0);
+    }
+
+    var stats: c.jzx_perf_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_perf_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u32, c.JZX_PERF_MAX_TAGS), stats.tags);
+    try std.testing.expectEqual(@as(u64, extra), stats.untagged);
+    try std.testing.expectEqual(@as(u64, 0), stats.failed);
+    // Tags past the cap still reach the totals.
+    try std.testing.expectEqual(@as(u64, c.JZX_PERF_MAX_TAGS + extra), stats.total.calls);
+}
+
+test "metrics exporter serves OpenMetrics over a unix socket" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var dir_buf: [std.fs.max_path_bytes]u8 = undefined;
+    const dir_path = try tmp.dir.realpath(".", &dir_buf);
+    var path_buf: [std.fs.max_path_bytes]u8 = undefined;
+    const path = try std.fmt.bufPrintZ(&path_buf, "{s}/metrics.sock", .{dir_path});
+
+    var mopts = c.jzx_metrics_opts{ .unix_path = path.ptr, .port = 0 };
+    var exporter: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_metrics_start(loop.ptr, &mopts, &exporter));
+
+    const stream = try std.net.connectUnixSocket(path);
+    defer stream.close();
+    _ = try posix.write(stream.handle, "GET /metrics HTTP/1.1\r\nHost: jzx\r\n\r\n");
+    for (0..5) |_| {
+        _ = c.jzx_loop_run_once(loop.ptr, 1);
+    }
+    var buf: [8192]u8 = undefined;
+    var len: usize = 0;
+    while (len < buf.len) {
+        const n = try posix.read(stream.handle, buf[len..]);
+        if (n == 0) break;
+        len += n;
+    }
+    const response = buf[0..len];
+    try std.testing.expect(std.mem.startsWith(u8, response, "HTTP/1.1 200 OK\r\n"));
+    try std.testing.expect(std.mem.indexOf(u8, response, "jzx_actors{state=\"running\"} 1\n") != null);
+    try std.testing.expect(std.mem.endsWith(u8, response, "# EOF\n"));
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_metrics_stop(loop.ptr, exporter));
+    _ = c.jzx_loop_run_once(loop.ptr, 0);
+}
+
+const ReplaySink = struct {
+    hits: u32 = 0,
+    sum: u32 = 0,
 };
 
-fn counterBehavior(state: *CounterState, msg: *CounterMsg, ctx: jzx.ActorContext) jzx.BehaviorResult {
-    _ = ctx;
-    state.total += msg.value;
-    return .stop;
+fn replaySinkBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    const state = @as(*ReplaySink, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    state.hits += 1;
+    if (msg_ptr.data) |data| {
+        state.sum += @as(*const u32, @ptrCast(@alignCast(data))).*;
+        c.jzx_loop_free(ctx_ptr.loop, data);
+    }
+    return c.JZX_BEHAVIOR_OK;
 }
 
-test "typed actor increments state" {
+fn replayResolve(ctx: ?*anyopaque, recorded: c.jzx_actor_id, first_tag: u32, opts: [*c]c.jzx_spawn_opts) callconv(.c) c.jzx_err {
+    _ = recorded;
+    if (first_tag != 5) return c.JZX_ERR_INVALID_ARG;
+    opts.*.behavior = replaySinkBehavior;
+    opts.*.state = ctx;
+    return c.JZX_OK;
+}
+
+test "recorded traffic replays into stand-in actors" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var dir_buf: [std.fs.max_path_bytes]u8 = undefined;
+    const dir_path = try tmp.dir.realpath(".", &dir_buf);
+    var path_buf: [std.fs.max_path_bytes]u8 = undefined;
+    const path = try std.fmt.bufPrintZ(&path_buf, "{s}/traffic.jzxrec", .{dir_path});
+
+    var live = ReplaySink{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = replaySinkBehavior,
+        .state = &live,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+    var other_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &other_id));
+
+    var rec_opts = c.jzx_record_opts{ .path = path.ptr, .payloads = 1, .buffer_bytes = 0 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_record_start(loop.ptr, &rec_opts));
+    for (1..11) |i| {
+        const value = @as(*u32, @ptrCast(@alignCast(c.jzx_loop_alloc(loop.ptr, @sizeOf(u32)).?)));
+        value.* = @intCast(i);
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor_id, value, @sizeOf(u32), 5));
+    }
+    // A target the resolver declines.
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, other_id, null, 0, 6));
+    while (live.hits < 11) {
+        _ = c.jzx_loop_run_once(loop.ptr, 0);
+    }
+    var rec_stats: c.jzx_record_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_record_stop(loop.ptr, &rec_stats));
+    try std.testing.expectEqual(@as(u64, 11), rec_stats.records);
+    try std.testing.expectEqual(@as(u64, 0), rec_stats.dropped);
+
+    var replayed = ReplaySink{};
+    var replay_opts = c.jzx_replay_opts{ .path = path.ptr, .resolve = replayResolve, .ctx = &replayed, .realtime = 0 };
+    var replay_stats: c.jzx_replay_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_replay(loop.ptr, &replay_opts, &replay_stats));
+    try std.testing.expectEqual(@as(u64, 10), replay_stats.delivered);
+    try std.testing.expectEqual(@as(u64, 1), replay_stats.skipped);
+    try std.testing.expectEqual(@as(u32, 10), replayed.hits);
+    try std.testing.expectEqual(live.sum, replayed.sum);
+}
+
+test "shared-memory link carries messages between two loops" {
+    var a = try jzx.Loop.create(null);
+    defer a.deinit();
+    var b = try jzx.Loop.create(null);
+    defer b.deinit();
+
+    var sink = ReplaySink{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = replaySinkBehavior,
+        .state = &sink,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var sink_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(b.ptr, &opts, &sink_id));
+
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    var a_opts = c.jzx_shm_opts{ .ring_bytes = 4096, .root = 0, .owner = 0 };
+    var b_opts = c.jzx_shm_opts{ .ring_bytes = 0, .root = sink_id, .owner = 0 };
+    var a_link: ?*c.jzx_shm_link = null;
+    var b_link: ?*c.jzx_shm_link = null;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_connect(a.ptr, fds[0], &a_opts, &a_link));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_accept(b.ptr, fds[1], &b_opts, 1000, &b_link));
+    const remote = c.jzx_shm_peer_root(a_link);
+    try std.testing.expectEqual(sink_id, remote);
+
+    var proxy: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_proxy(a_link, remote, &proxy));
+    var values: [100]u32 = undefined;
+    for (&values, 1..) |*v, i| {
+        v.* = @intCast(i);
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(a.ptr, proxy, v, @sizeOf(u32), 5));
+    }
+    var spins: u32 = 0;
+    while (sink.hits < values.len and spins < 1000) : (spins += 1) {
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+        _ = c.jzx_loop_run_once(b.ptr, 1);
+    }
+    try std.testing.expectEqual(@as(u32, 100), sink.hits);
+    try std.testing.expectEqual(@as(u32, 5050), sink.sum);
+
+    var stats: c.jzx_shm_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_get_stats(b_link, &stats));
+    try std.testing.expectEqual(@as(u64, 100), stats.received);
+
+    c.jzx_shm_close(a_link);
+    c.jzx_shm_close(b_link);
+    _ = c.jzx_loop_run_once(a.ptr, 0);
+    _ = c.jzx_loop_run_once(b.ptr, 0);
+}
+
+test "shared-memory proxy keeps messages until the peer drains a full ring" {
+    var a = try jzx.Loop.create(null);
+    defer a.deinit();
+    var b = try jzx.Loop.create(null);
+    defer b.deinit();
+
+    var sink = ReplaySink{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = replaySinkBehavior,
+        .state = &sink,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var sink_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(b.ptr, &opts, &sink_id));
+
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    var a_opts = c.jzx_shm_opts{ .ring_bytes = 4096, .root = 0, .owner = 0 };
+    var b_opts = c.jzx_shm_opts{ .ring_bytes = 0, .root = sink_id, .owner = 0 };
+    var a_link: ?*c.jzx_shm_link = null;
+    var b_link: ?*c.jzx_shm_link = null;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_connect(a.ptr, fds[0], &a_opts, &a_link));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_accept(b.ptr, fds[1], &b_opts, 1000, &b_link));
+
+    var proxy: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_proxy(a_link, c.jzx_shm_peer_root(a_link), &proxy));
+    // 200 messages of 512 bytes are far more than a 4 KiB ring holds.
+    var payloads: [200][128]u32 = undefined;
+    for (&payloads, 1..) |*p, i| {
+        p[0] = @intCast(i);
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(a.ptr, proxy, p, @sizeOf([128]u32), 5));
+    }
+    for (0..4) |_| {
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+    }
+    var stats: c.jzx_shm_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_get_stats(a_link, &stats));
+    try std.testing.expect(stats.proxy_held > 0);
+
+    var spins: u32 = 0;
+    while (sink.hits < payloads.len and spins < 2000) : (spins += 1) {
+        _ = c.jzx_loop_run_once(b.ptr, 0);
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+    }
+    try std.testing.expectEqual(@as(u32, 200), sink.hits);
+    try std.testing.expectEqual(@as(u32, 20100), sink.sum);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_shm_get_stats(a_link, &stats));
+    try std.testing.expectEqual(@as(u64, 0), stats.dropped);
+
+    c.jzx_shm_close(a_link);
+    c.jzx_shm_close(b_link);
+    _ = c.jzx_loop_run_once(a.ptr, 0);
+    _ = c.jzx_loop_run_once(b.ptr, 0);
+}
+
+test "node transport routes node-qualified ids over a socketpair" {
+    var a = try jzx.Loop.create(null);
+    defer a.deinit();
+    var b = try jzx.Loop.create(null);
+    defer b.deinit();
+
+    var sink = ReplaySink{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = replaySinkBehavior,
+        .state = &sink,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var sink_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(b.ptr, &opts, &sink_id));
+
+    var a_opts = c.jzx_node_opts{ .node_id = 1, .unix_path = null, .batch_bytes = 0, .max_queued = 0, .max_frame = 0, .owner = 0 };
+    var b_opts = c.jzx_node_opts{ .node_id = 2, .unix_path = null, .batch_bytes = 0, .max_queued = 0, .max_frame = 0, .owner = 0 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_start(a.ptr, &a_opts));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_start(b.ptr, &b_opts));
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_adopt(a.ptr, fds[0]));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_adopt(b.ptr, fds[1]));
+    var spins: u32 = 0;
+    while (c.jzx_node_connected(a.ptr, 2) == 0 and spins < 100) : (spins += 1) {
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+        _ = c.jzx_loop_run_once(b.ptr, 1);
+    }
+    try std.testing.expectEqual(@as(c_int, 1), c.jzx_node_connected(a.ptr, 2));
+
+    const remote = c.jzx_node_actor(2, sink_id);
+    var values: [100]u32 = undefined;
+    for (&values, 1..) |*v, i| {
+        v.* = @intCast(i);
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(a.ptr, remote, v, @sizeOf(u32), 5));
+    }
+    try std.testing.expectEqual(c.JZX_ERR_NO_SUCH_ACTOR, c.jzx_send(a.ptr, c.jzx_node_actor(7, sink_id), null, 0, 5));
+    spins = 0;
+    while (sink.hits < values.len and spins < 1000) : (spins += 1) {
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+        _ = c.jzx_loop_run_once(b.ptr, 1);
+    }
+    try std.testing.expectEqual(@as(u32, 100), sink.hits);
+    try std.testing.expectEqual(@as(u32, 5050), sink.sum);
+
+    var stats: c.jzx_node_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_get_stats(a.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 100), stats.frames_out);
+    try std.testing.expect(stats.writev_calls < 100);
+
+    c.jzx_node_stop(a.ptr);
+    spins = 0;
+    while (c.jzx_node_connected(b.ptr, 1) != 0 and spins < 100) : (spins += 1) {
+        _ = c.jzx_loop_run_once(b.ptr, 1);
+    }
+    try std.testing.expectEqual(@as(c_int, 0), c.jzx_node_connected(b.ptr, 1));
+    c.jzx_node_stop(b.ptr);
+}
+
+test "node timers route remote ids and accept self-qualified ones" {
+    var a = try jzx.Loop.create(null);
+    defer a.deinit();
+    var b = try jzx.Loop.create(null);
+    defer b.deinit();
+
+    var remote_sink = ReplaySink{};
+    var local_sink = ReplaySink{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = replaySinkBehavior,
+        .state = &remote_sink,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var remote_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(b.ptr, &opts, &remote_id));
+    opts.state = &local_sink;
+    var local_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(a.ptr, &opts, &local_id));
+
+    var a_opts = c.jzx_node_opts{ .node_id = 1, .unix_path = null, .batch_bytes = 0, .max_queued = 0, .max_frame = 0, .owner = 0 };
+    var b_opts = c.jzx_node_opts{ .node_id = 2, .unix_path = null, .batch_bytes = 0, .max_queued = 0, .max_frame = 0, .owner = 0 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_start(a.ptr, &a_opts));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_start(b.ptr, &b_opts));
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_adopt(a.ptr, fds[0]));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_adopt(b.ptr, fds[1]));
+    var spins: u32 = 0;
+    while (c.jzx_node_connected(a.ptr, 2) == 0 and spins < 100) : (spins += 1) {
+        _ = c.jzx_loop_run_once(a.ptr, 0);
+        _ = c.jzx_loop_run_once(b.ptr, 1);
+    }
+    try std.testing.expectEqual(@as(c_int, 1), c.jzx_node_connected(a.ptr, 2));
+
+    // The frame is built when the timer fires, from a payload that must
+    // outlive the timer like any other.
+    var value: u32 = 42;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_after(a.ptr, c.jzx_node_actor(2, remote_id), 1, &value, @sizeOf(u32), 5, null));
+    // Ids naming this loop's own node are local ids.
+    const self_id = c.jzx_node_actor(1, local_id);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_after(a.ptr, self_id, 1, null, 0, 5, null));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_keyed(a.ptr, self_id, 1, null, 0, 5));
+    var depth: u32 = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_actor_mailbox_depth(a.ptr, self_id, &depth));
+    try std.testing.expectEqual(@as(u32, 1), depth);
+    // Conflation needs the target's mailbox, so keyed sends stay local.
+    try std.testing.expectEqual(c.JZX_ERR_INVALID_ARG, c.jzx_send_keyed(a.ptr, c.jzx_node_actor(2, remote_id), 1, null, 0, 5));
+
+    spins = 0;
+    while ((remote_sink.hits < 1 or local_sink.hits < 2) and spins < 1000) : (spins += 1) {
+        _ = c.jzx_loop_run_once(a.ptr, 1);
+        _ = c.jzx_loop_run_once(b.ptr, 0);
+    }
+    try std.testing.expectEqual(@as(u32, 1), remote_sink.hits);
+    try std.testing.expectEqual(@as(u32, 42), remote_sink.sum);
+    try std.testing.expectEqual(@as(u32, 2), local_sink.hits);
+
+    c.jzx_node_stop(a.ptr);
+    c.jzx_node_stop(b.ptr);
+}
+
+const PingPongState = struct {
+    loop: *c.jzx_loop,
+    partner: *?c.jzx_actor_id,
+    remaining: u32,
+    hits: u32,
+};
+
+fn pingPongBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*PingPongState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    _ = msg;
+    state.hits += 1;
+    if (state.remaining == 0) {
+        return c.JZX_BEHAVIOR_STOP;
+    }
+    state.remaining -= 1;
+    if (state.partner.*) |partner_id| {
+        var payload: u32 = 1;
+        _ = c.jzx_send(state.loop, partner_id, &payload, @sizeOf(u32), 0);
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+test "ping pong actors share work fairly" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var id_a: c.jzx_actor_id = 0;
+    var id_b: c.jzx_actor_id = 0;
+    var partner_a: ?c.jzx_actor_id = 0;
+    var partner_b: ?c.jzx_actor_id = 0;
+    var state_a = PingPongState{ .loop = loop.ptr, .partner = &partner_a, .remaining = 10, .hits = 0 };
+    var state_b = PingPongState{ .loop = loop.ptr, .partner = &partner_b, .remaining = 10, .hits = 0 };
+
+    var opts_a = c.jzx_spawn_opts{ .behavior = pingPongBehavior, .state = &state_a, .supervisor = 0, .mailbox_cap = 0 };
+    var opts_b = c.jzx_spawn_opts{ .behavior = pingPongBehavior, .state = &state_b, .supervisor = 0, .mailbox_cap = 0 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts_a, &id_a));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts_b, &id_b));
+    partner_a = id_b;
+    partner_b = id_a;
+
+    var init: u32 = 1;
+    _ = c.jzx_send(loop.ptr, id_a, &init, @sizeOf(u32), 0);
+    _ = c.jzx_send(loop.ptr, id_b, &init, @sizeOf(u32), 0);
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 11), state_a.hits);
+    try std.testing.expectEqual(@as(u32, 11), state_b.hits);
+}
+
+const CounterState = struct {
+    total: u32 = 0,
+};
+
+const CounterMsg = struct {
+    value: u32,
+};
+
+fn counterBehavior(state: *CounterState, msg: *CounterMsg, ctx: jzx.ActorContext) jzx.BehaviorResult {
+    _ = ctx;
+    state.total += msg.value;
+    return .stop;
+}
+
+test "typed actor increments state" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var counter = CounterState{};
+    var actor = try jzx.Actor(CounterState, *CounterMsg).spawn(
+        loop.ptr,
+        std.heap.c_allocator,
+        &counter,
+        &counterBehavior,
+        .{},
+    );
+    defer actor.destroy();
+
+    var msg = CounterMsg{ .value = 8 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor.getId(), &msg, @sizeOf(CounterMsg), 0));
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 8), counter.total);
+}
+
+const ConflateState = struct {
+    seen: u32 = 0,
+    last: u32 = 0,
+};
+
+fn conflateBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    const state = @as(*ConflateState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    state.seen += 1;
+    if (msg_ptr.data) |data_ptr| {
+        state.last = @as(*const u32, @ptrCast(@alignCast(data_ptr))).*;
+    }
+    return c.JZX_BEHAVIOR_STOP;
+}
+
+fn countRelease(ctx: ?*anyopaque, msg: [*c]const c.jzx_message) callconv(.c) void {
+    _ = msg;
+    const count = @as(*u32, @ptrCast(@alignCast(ctx.?)));
+    count.* += 1;
+}
+
+test "conflating mailbox keeps latest value per key" {
+    var released: u32 = 0;
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.release = countRelease;
+    cfg.release_ctx = &released;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state = ConflateState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = conflateBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 1,
+        .mailbox_mode = c.JZX_MAILBOX_CONFLATING,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    var payloads = [_]u32{ 1, 2, 3, 4 };
+    for (&payloads) |*value| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send_keyed(loop.ptr, actor_id, 42, value, @sizeOf(u32), 0));
+    }
+    // A different key needs its own slot, and the single slot is taken.
+    try std.testing.expectEqual(c.JZX_ERR_MAILBOX_FULL, c.jzx_send_keyed(loop.ptr, actor_id, 7, &payloads[0], @sizeOf(u32), 0));
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 1), state.seen);
+    try std.testing.expectEqual(@as(u32, 4), state.last);
+    try std.testing.expectEqual(@as(u32, 3), released);
+}
+
+test "expired deadline messages are dropped before dispatch" {
+    var released: u32 = 0;
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.release = countRelease;
+    cfg.release_ctx = &released;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = increment_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const now = c.jzx_loop_now_ms(loop.ptr);
+    var stale: u32 = 100;
+    var fresh: u32 = 5;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_deadline(loop.ptr, actor_id, &stale, @sizeOf(u32), 1, now + 1));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send_deadline(loop.ptr, actor_id, &fresh, @sizeOf(u32), 1, now + 60_000));
+    std.Thread.sleep(5 * std.time.ns_per_ms);
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 5), state);
+    try std.testing.expectEqual(@as(u32, 1), released);
+
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 1), stats.messages_expired);
+}
+
+fn io_behavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    if (msg_ptr.tag == c.JZX_TAG_SYS_IO and msg_ptr.data != null) {
+        const data_ptr = msg_ptr.data.?;
+        const state_ptr = @as(*u32, @ptrFromInt(@intFromPtr(ctx_ptr.state.?)));
+        const event = @as(*c.jzx_io_event, @ptrFromInt(@intFromPtr(data_ptr)));
+        if ((event.readiness & c.JZX_IO_READ) != 0) {
+            state_ptr.* += 1;
+        }
+        c.jzx_loop_free(ctx_ptr.loop, data_ptr);
+        return c.JZX_BEHAVIOR_STOP;
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+fn pipe_writer(fd: posix.fd_t) void {
+    const msg = "ping";
+    _ = posix.write(fd, msg) catch {};
+}
+
+test "io watcher delivers readiness" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = io_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const pipefds = try posix.pipe();
+    defer {
+        posix.close(pipefds[0]);
+        posix.close(pipefds[1]);
+    }
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
+
+    var writer = try std.Thread.spawn(.{}, pipe_writer, .{pipefds[1]});
+    writer.join();
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 1), state);
+}
+
+test "io watcher payloads free cleanly under memory accounting" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.mem_accounting = 1;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = io_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const pipefds = try posix.pipe();
+    defer {
+        posix.close(pipefds[0]);
+        posix.close(pipefds[1]);
+    }
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
+    pipe_writer(pipefds[1]);
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 1), state);
+}
+
+const OneshotState = struct {
+    io_events: u32 = 0,
+};
+
+fn oneshotBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*OneshotState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    if (msg_ptr.tag == c.JZX_TAG_SYS_IO) {
+        state.io_events += 1;
+        c.jzx_loop_free(ctx_ptr.loop, msg_ptr.data);
+        // Leave the pipe unread: a level-triggered watch would fire every tick.
+        _ = c.jzx_send_after(ctx_ptr.loop, ctx_ptr.self, 20, null, 0, 1, null);
+        return c.JZX_BEHAVIOR_OK;
+    }
+    return c.JZX_BEHAVIOR_STOP;
+}
+
+test "oneshot io watch disarms after one event" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state = OneshotState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = oneshotBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const pipefds = try posix.pipe();
+    defer {
+        posix.close(pipefds[0]);
+        posix.close(pipefds[1]);
+    }
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ | c.JZX_IO_ONESHOT));
+    pipe_writer(pipefds[1]);
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 1), state.io_events);
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 1), stats.io_events);
+}
+
+fn ioCountBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*OneshotState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    if (msg_ptr.tag == c.JZX_TAG_SYS_IO) {
+        state.io_events += 1;
+        c.jzx_loop_free(ctx_ptr.loop, msg_ptr.data);
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+test "oneshot io watch stays quiet on an undrained fd until rearmed" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state = OneshotState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = ioCountBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const pipefds = try posix.pipe();
+    defer {
+        posix.close(pipefds[0]);
+        posix.close(pipefds[1]);
+    }
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ | c.JZX_IO_ONESHOT));
+    _ = try posix.write(pipefds[1], "x");
+    var i: u32 = 0;
+    while (i < 3) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 1), state.io_events);
+
+    // The pipe is still readable, but the loop must block rather than spin.
+    const start = std.time.milliTimestamp();
+    _ = try loop.runOnce(30);
+    try std.testing.expect(std.time.milliTimestamp() - start >= 20);
+    try std.testing.expectEqual(@as(u32, 1), state.io_events);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_rearm_fd(loop.ptr, pipefds[0]));
+    i = 0;
+    while (i < 3) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 2), state.io_events);
+}
+
+test "io rapid watch and unwatch" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = increment_behavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
+
+    const pipefds = try posix.pipe();
+    defer {
+        posix.close(pipefds[0]);
+        posix.close(pipefds[1]);
+    }
+
+    for (0..8) |_| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_unwatch_fd(loop.ptr, pipefds[0]));
+    }
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
+    var writer = try std.Thread.spawn(.{}, pipe_writer, .{pipefds[1]});
+    writer.join();
+
+    try loop.run();
+    try std.testing.expect(state >= 1);
+}
+
+test "mailbox watch notifies once the target drains" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var target_state = OneshotState{};
+    var target_opts = c.jzx_spawn_opts{ .behavior = ioCountBehavior, .state = &target_state, .supervisor = 0, .mailbox_cap = 8 };
+    var target: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &target_opts, &target));
+    var watcher_state = TimerState{ .target = 100 };
+    var watcher_opts = c.jzx_spawn_opts{ .behavior = timer_behavior, .state = &watcher_state, .supervisor = 0, .mailbox_cap = 0 };
+    var watcher: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &watcher_opts, &watcher));
+
+    for (0..8) |_| try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, target, null, 0, 1));
+    try std.testing.expectEqual(c.JZX_ERR_MAILBOX_FULL, c.jzx_send(loop.ptr, target, null, 0, 1));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_mailbox(loop.ptr, target, 0, watcher, 77));
+    var i: u32 = 0;
+    while (i < 4) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 1), watcher_state.hits);
+
+    // A target that stops also fires its watches.
+    for (0..8) |_| try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, target, null, 0, 1));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_mailbox(loop.ptr, target, 0, watcher, 77));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_actor_stop(loop.ptr, target));
+    i = 0;
+    while (i < 4) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 2), watcher_state.hits);
+}
+
+const NetOwnerState = struct {
+    net: ?*c.jzx_net = null,
+    frames: u32 = 0,
+    bytes: usize = 0,
+    closed: bool = false,
+};
+
+fn netOwnerBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*NetOwnerState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    const frame = @as(*c.jzx_net_frame, @ptrCast(@alignCast(msg_ptr.data.?)));
+    defer c.jzx_net_frame_release(state.net, frame);
+    switch (msg_ptr.tag) {
+        c.JZX_TAG_NET_DATA => {
+            state.frames += 1;
+            state.bytes += frame.len;
+            if (state.frames == 3) {
+                _ = c.jzx_net_write(state.net, frame.conn, "done\n", 5);
+                _ = c.jzx_net_close(state.net, frame.conn);
+            }
+        },
+        c.JZX_TAG_NET_CLOSED => {
+            state.closed = true;
+            return c.JZX_BEHAVIOR_STOP;
+        },
+        else => {},
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+test "net connection frames lines and flushes writes before closing" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+    const net = c.jzx_net_create(loop.ptr, 0, 0);
+    defer c.jzx_net_destroy(net);
+
+    var state = NetOwnerState{ .net = net };
+    var opts = c.jzx_spawn_opts{
+        .behavior = netOwnerBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var owner: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &owner));
+
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    defer posix.close(fds[1]);
+    _ = try posix.write(fds[1], "one\ntwo\nthree\n");
+
+    var conn_opts = c.jzx_net_conn_opts{ .framing = c.JZX_NET_FRAME_LINE };
+    var conn: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_net_adopt(net, fds[0], owner, &conn_opts, &conn));
+
+    try loop.run();
+    try std.testing.expectEqual(@as(u32, 3), state.frames);
+    try std.testing.expectEqual(@as(usize, 11), state.bytes);
+    try std.testing.expect(state.closed);
+
+    var buf: [16]u8 = undefined;
+    const n = try posix.read(fds[1], &buf);
+    try std.testing.expectEqualStrings("done\n", buf[0..n]);
+}
+
+const XferOwnerState = struct {
+    loop: ?*c.jzx_loop = null,
+    done: bool = false,
+    sent: u64 = 0,
+    err: c_int = -1,
+};
+
+fn xferOwnerBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*XferOwnerState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    const ev = @as(*c.jzx_net_xfer_event, @ptrCast(@alignCast(msg_ptr.data.?)));
+    defer c.jzx_loop_free(state.loop, ev);
+    if (msg_ptr.tag == c.JZX_TAG_NET_XFER_DONE) {
+        state.done = true;
+        state.sent = ev.sent;
+        state.err = ev.@"error";
+        return c.JZX_BEHAVIOR_STOP;
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+test "net transfer streams a pipe into a socket until EOF" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+    const net = c.jzx_net_create(loop.ptr, 0, 0);
+    defer c.jzx_net_destroy(net);
+
+    var state = XferOwnerState{ .loop = loop.ptr };
+    var opts = c.jzx_spawn_opts{
+        .behavior = xferOwnerBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var owner: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &owner));
+
+    const pipe_fds = try posix.pipe();
+    defer posix.close(pipe_fds[0]);
+    var payload: [5000]u8 = undefined;
+    @memset(&payload, 'z');
+    _ = try posix.write(pipe_fds[1], &payload);
+    posix.close(pipe_fds[1]);
+
+    var fds: [2]c_int = undefined;
+    try std.testing.expectEqual(@as(c_int, 0), std.c.socketpair(posix.AF.UNIX, posix.SOCK.STREAM, 0, &fds));
+    defer posix.close(fds[0]);
+    defer posix.close(fds[1]);
+
+    var xopts = c.jzx_net_xfer_opts{ .in_fd = pipe_fds[0], .out_fd = fds[0], .owner = owner };
+    var xfer: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_net_transfer(net, &xopts, &xfer));
+
+    try loop.run();
+    try std.testing.expect(state.done);
+    try std.testing.expectEqual(@as(c_int, 0), state.err);
+    try std.testing.expectEqual(@as(u64, payload.len), state.sent);
+    // Both caller fds get their blocking mode back once the transfer ends.
+    const nonblock: usize = @as(u32, @bitCast(posix.O{ .NONBLOCK = true }));
+    try std.testing.expectEqual(@as(usize, 0), (try posix.fcntl(pipe_fds[0], posix.F.GETFL, 0)) & nonblock);
+    try std.testing.expectEqual(@as(usize, 0), (try posix.fcntl(fds[0], posix.F.GETFL, 0)) & nonblock);
+
+    var got: usize = 0;
+    var buf: [8192]u8 = undefined;
+    while (got < payload.len) {
+        const n = try posix.read(fds[1], &buf);
+        if (n == 0) break;
+        got += n;
+    }
+    try std.testing.expectEqual(payload.len, got);
+}
+
+const FileScanState = struct {
+    loop: ?*c.jzx_loop = null,
+    bytes: usize = 0,
+    next_offset: u64 = 0,
+    eof: bool = false,
+    in_order: bool = true,
+    // Keep the first chunk for the test to release.
+    hold_first: bool = false,
+    held: ?*c.jzx_file_chunk = null,
+};
+
+fn fileScanBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*FileScanState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    const chunk = @as(*c.jzx_file_chunk, @ptrCast(@alignCast(msg_ptr.data.?)));
+    if (msg_ptr.tag == c.JZX_TAG_FILE_EOF) {
+        c.jzx_file_chunk_release(state.loop, chunk);
+        state.eof = true;
+        return c.JZX_BEHAVIOR_STOP;
+    }
+    if (chunk.offset != state.next_offset or chunk.bytes[0] != 'a' + @as(u8, @intCast((chunk.offset / 4096) % 26))) {
+        state.in_order = false;
+    }
+    state.next_offset += chunk.len;
+    state.bytes += chunk.len;
+    if (state.hold_first and state.held == null) {
+        state.held = chunk;
+    } else {
+        c.jzx_file_chunk_release(state.loop, chunk);
+    }
+    return c.JZX_BEHAVIOR_OK;
+}
+
+test "file reader streams mapped chunks in order with bounded credits" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const file = try tmp.dir.createFile("segment", .{ .read = true });
+    defer file.close();
+    var page: [4096]u8 = undefined;
+    for (0..40) |i| {
+        @memset(&page, 'a' + @as(u8, @intCast(i % 26)));
+        try file.writeAll(&page);
+    }
+
+    var state = FileScanState{ .loop = loop.ptr };
+    var opts = c.jzx_spawn_opts{
+        .behavior = fileScanBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var owner: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &owner));
+
+    var ropts = c.jzx_file_read_opts{ .fd = file.handle, .owner = owner, .chunk_size = 4096, .credits = 2 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_file_read(loop.ptr, &ropts, null));
+
+    try loop.run();
+    try std.testing.expect(state.eof);
+    try std.testing.expect(state.in_order);
+    try std.testing.expectEqual(@as(usize, 40 * 4096), state.bytes);
+}
+
+test "file reader keeps a credit released while its mailbox is full" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const file = try tmp.dir.createFile("segment", .{ .read = true });
+    defer file.close();
+    var page: [4096]u8 = undefined;
+    for (0..8) |i| {
+        @memset(&page, 'a' + @as(u8, @intCast(i % 26)));
+        try file.writeAll(&page);
+    }
+
+    var state = FileScanState{ .loop = loop.ptr, .hold_first = true };
+    var opts = c.jzx_spawn_opts{
+        .behavior = fileScanBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var owner: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &owner));
+
+    var ropts = c.jzx_file_read_opts{ .fd = file.handle, .owner = owner, .chunk_size = 4096, .credits = 1 };
+    var reader: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_file_read(loop.ptr, &ropts, &reader));
+    var spins: usize = 0;
+    while (state.held == null and spins < 8) : (spins += 1) {
+        _ = c.jzx_loop_run_once(loop.ptr, 0);
+    }
+    try std.testing.expect(state.held != null);
+
+    // The CREDIT wake-up cannot be queued; the credit must still count.
+    while (c.jzx_send(loop.ptr, reader, null, 0, 7) == c.JZX_OK) {}
+    c.jzx_file_chunk_release(loop.ptr, state.held);
+
+    try loop.run();
+    try std.testing.expect(state.eof);
+    try std.testing.expectEqual(@as(usize, 8 * 4096), state.bytes);
+}
+
+test "file reader stopped mid-read closes its fd" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const file = try tmp.dir.createFile("segment", .{ .read = true });
+    defer file.close();
+    var page: [4096]u8 = undefined;
+    for (0..8) |i| {
+        @memset(&page, 'a' + @as(u8, @intCast(i % 26)));
+        try file.writeAll(&page);
+    }
+
+    var state = FileScanState{ .loop = loop.ptr, .hold_first = true };
+    var opts = c.jzx_spawn_opts{
+        .behavior = fileScanBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var owner: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &owner));
+
+    // The reader's dup takes the lowest free descriptor.
+    const probe = try posix.dup(file.handle);
+    posix.close(probe);
+    var ropts = c.jzx_file_read_opts{ .fd = file.handle, .owner = owner, .chunk_size = 4096, .credits = 1 };
+    var reader: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_file_read(loop.ptr, &ropts, &reader));
+    try std.testing.expect(std.c.fcntl(probe, posix.F.GETFD) != -1);
+    var spins: usize = 0;
+    while (state.held == null and spins < 8) : (spins += 1) {
+        _ = c.jzx_loop_run_once(loop.ptr, 0);
+    }
+    try std.testing.expect(state.held != null);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_actor_stop(loop.ptr, reader));
+    _ = c.jzx_loop_run_once(loop.ptr, 0);
+    try std.testing.expectEqual(@as(c_int, -1), std.c.fcntl(probe, posix.F.GETFD));
+    // The held chunk stays valid and frees the reader's state.
+    try std.testing.expectEqual(@as(u8, 'a'), state.held.?.bytes[0]);
+    c.jzx_file_chunk_release(loop.ptr, state.held);
+    try std.testing.expect(!state.eof);
+}
+
+const SignalState = struct {
+    loop: ?*c.jzx_loop = null,
+    signo: c_int = 0,
+    count: u32 = 0,
+};
+
+fn signalBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*SignalState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    if (msg_ptr.tag != c.JZX_TAG_SYS_SIGNAL) return c.JZX_BEHAVIOR_OK;
+    const ev = @as(*c.jzx_signal_event, @ptrCast(@alignCast(msg_ptr.data.?)));
+    defer c.jzx_loop_free(state.loop, ev);
+    state.signo = ev.signo;
+    state.count += ev.count;
+    return c.JZX_BEHAVIOR_STOP;
+}
+
+test "watched signal arrives as a message" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var state = SignalState{ .loop = loop.ptr };
+    var opts = c.jzx_spawn_opts{
+        .behavior = signalBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
+    try loop.watchSignal(posix.SIG.USR1, actor);
+
+    try posix.raise(posix.SIG.USR1);
+    try loop.run();
+    try std.testing.expectEqual(@as(c_int, posix.SIG.USR1), state.signo);
+    try std.testing.expectEqual(@as(u32, 1), state.count);
+}
+
+test "unwatching a signal the caller had blocked leaves it blocked" {
+    if (@import("builtin").os.tag != .linux) return error.SkipZigTest;
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var set = posix.empty_sigset;
+    std.os.linux.sigaddset(&set, posix.SIG.WINCH);
+    var old: posix.sigset_t = undefined;
+    posix.sigprocmask(posix.SIG.BLOCK, &set, &old);
+    defer posix.sigprocmask(posix.SIG.SETMASK, &old, null);
+
+    var state = SignalState{ .loop = loop.ptr };
+    var opts = c.jzx_spawn_opts{
+        .behavior = signalBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
+    try loop.watchSignal(posix.SIG.WINCH, actor);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_unwatch_signal(loop.ptr, posix.SIG.WINCH));
+
+    var now: posix.sigset_t = undefined;
+    posix.sigprocmask(posix.SIG.BLOCK, null, &now);
+    try std.testing.expect(std.os.linux.sigismember(&now, posix.SIG.WINCH));
+}
+
+fn hibernateBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const count = @as(*u32, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    count.* += 1;
+    return if (msg_ptr.tag == 2) c.JZX_BEHAVIOR_STOP else c.JZX_BEHAVIOR_HIBERNATE;
+}
+
+test "hibernated actor releases its mailbox and wakes on the next message" {
     var loop = try jzx.Loop.create(null);
     defer loop.deinit();
 
-    var counter = CounterState{};
-    var actor = try jzx.Actor(CounterState, *CounterMsg).spawn(
-        loop.ptr,
-        std.heap.c_allocator,
-        &counter,
-        &counterBehavior,
-        .{},
-    );
-    defer actor.destroy();
+    var count: u32 = 0;
+    var opts = c.jzx_spawn_opts{
+        .behavior = hibernateBehavior,
+        .state = &count,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+    };
+    var actor: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
 
-    var msg = CounterMsg{ .value = 8 };
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor.getId(), &msg, @sizeOf(CounterMsg), 0));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 1));
+    _ = try loop.runOnce(0);
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u32, 1), stats.actors_hibernated);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 2));
     try loop.run();
-    try std.testing.expectEqual(@as(u32, 8), counter.total);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u32, 2), count);
+    try std.testing.expectEqual(@as(u64, 1), stats.wakeups);
+    try std.testing.expectEqual(@as(u32, 0), stats.actors_hibernated);
 }
 
-fn io_behavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+fn idleCountBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    _ = msg;
     const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
-    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
-    if (msg_ptr.tag == c.JZX_TAG_SYS_IO and msg_ptr.data != null) {
-        const data_ptr = msg_ptr.data.?;
-        const state_ptr = @as(*u32, @ptrFromInt(@intFromPtr(ctx_ptr.state.?)));
-        const event = @as(*c.jzx_io_event, @ptrFromInt(@intFromPtr(data_ptr)));
-        if ((event.readiness & c.JZX_IO_READ) != 0) {
-            state_ptr.* += 1;
-        }
-        std.c.free(@ptrCast(data_ptr));
-        return c.JZX_BEHAVIOR_STOP;
-    }
+    const count = @as(*u32, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    count.* += 1;
     return c.JZX_BEHAVIOR_OK;
 }
 
-fn pipe_writer(fd: posix.fd_t) void {
-    const msg = "ping";
-    _ = posix.write(fd, msg) catch {};
+fn hibernatedCount(loop: *c.jzx_loop) !u32 {
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop, &stats));
+    return stats.actors_hibernated;
 }
 
-test "io watcher delivers readiness" {
-    var loop = try jzx.Loop.create(null);
+test "idle hibernation follows virtual time" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.virtual_time = 1;
+    var loop = try jzx.Loop.create(cfg);
     defer loop.deinit();
 
-    var state: u32 = 0;
+    var count: u32 = 0;
     var opts = c.jzx_spawn_opts{
-        .behavior = io_behavior,
-        .state = &state,
+        .behavior = idleCountBehavior,
+        .state = &count,
         .supervisor = 0,
         .mailbox_cap = 0,
+        .hibernate_after_ms = 500,
     };
-    var actor_id: c.jzx_actor_id = 0;
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
-
-    const pipefds = try posix.pipe();
-    defer {
-        posix.close(pipefds[0]);
-        posix.close(pipefds[1]);
-    }
-
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
-
-    var writer = try std.Thread.spawn(.{}, pipe_writer, .{pipefds[1]});
-    writer.join();
+    var actor: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
+
+    // Activity is stamped on the simulated clock, far from the real one.
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_advance_ns(loop.ptr, 2_000_000_000));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 1));
+    _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 1), count);
+    try std.testing.expectEqual(@as(u32, 0), try hibernatedCount(loop.ptr));
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_advance_ns(loop.ptr, 200_000_000));
+    _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 0), try hibernatedCount(loop.ptr));
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_advance_ns(loop.ptr, 400_000_000));
+    _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 1), try hibernatedCount(loop.ptr));
+}
 
-    try loop.run();
-    try std.testing.expectEqual(@as(u32, 1), state);
+fn stopOnFirst(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    _ = ctx;
+    _ = msg;
+    return c.JZX_BEHAVIOR_STOP;
 }
 
-test "io rapid watch and unwatch" {
+test "mailbox buffers are reused after teardown" {
     var loop = try jzx.Loop.create(null);
     defer loop.deinit();
 
-    var state: u32 = 0;
     var opts = c.jzx_spawn_opts{
-        .behavior = increment_behavior,
-        .state = &state,
+        .behavior = stopOnFirst,
+        .state = null,
         .supervisor = 0,
-        .mailbox_cap = 0,
+        .mailbox_cap = 8,
     };
-    var actor_id: c.jzx_actor_id = 0;
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor_id));
-
-    const pipefds = try posix.pipe();
-    defer {
-        posix.close(pipefds[0]);
-        posix.close(pipefds[1]);
+    var round: u32 = 0;
+    while (round < 3) : (round += 1) {
+        var actor: c.jzx_actor_id = 0;
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 1));
+        _ = try loop.runOnce(0);
     }
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    // The first spawn allocates the buffer; later ones reuse it.
+    try std.testing.expectEqual(@as(u64, 1), stats.pool_misses);
+    try std.testing.expectEqual(@as(u64, 2), stats.pool_hits);
+}
 
-    for (0..8) |_| {
-        try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
-        try std.testing.expectEqual(c.JZX_OK, c.jzx_unwatch_fd(loop.ptr, pipefds[0]));
+const MemState = struct {
+    held: ?*anyopaque = null,
+    notified: u32 = 0,
+};
+
+fn memBehavior(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*MemState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    const msg_ptr = @as(*const c.jzx_message, @ptrCast(msg));
+    switch (msg_ptr.tag) {
+        1 => state.held = c.jzx_ctx_alloc(ctx_ptr, 4096),
+        c.JZX_TAG_SYS_MEM_LIMIT => {
+            state.notified += 1;
+            c.jzx_loop_free(ctx_ptr.loop, msg_ptr.data);
+        },
+        else => {
+            c.jzx_loop_free(ctx_ptr.loop, state.held);
+            state.held = null;
+            return c.JZX_BEHAVIOR_STOP;
+        },
     }
+    return c.JZX_BEHAVIOR_OK;
+}
 
-    try std.testing.expectEqual(c.JZX_OK, c.jzx_watch_fd(loop.ptr, pipefds[0], actor_id, c.JZX_IO_READ));
-    var writer = try std.Thread.spawn(.{}, pipe_writer, .{pipefds[1]});
-    writer.join();
+test "memory accounting charges actor allocations and notifies over the limit" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.mem_accounting = 1;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
 
+    var state = MemState{};
+    var opts = c.jzx_spawn_opts{
+        .behavior = memBehavior,
+        .state = &state,
+        .supervisor = 0,
+        .mailbox_cap = 0,
+        .mem_limit = 2048,
+    };
+    var actor: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &actor));
+    var mem: c.jzx_actor_mem = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_actor_get_mem(loop.ptr, actor, &mem));
+    const mailbox_bytes = mem.bytes;
+    try std.testing.expect(mailbox_bytes > 0);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 1));
+    _ = try loop.runOnce(0);
+    _ = try loop.runOnce(0);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_actor_get_mem(loop.ptr, actor, &mem));
+    try std.testing.expectEqual(mailbox_bytes + 4096, mem.bytes);
+    try std.testing.expectEqual(@as(u32, 1), state.notified);
+
+    var top: [2]c.jzx_actor_mem = undefined;
+    try std.testing.expectEqual(@as(usize, 1), c.jzx_loop_mem_top(loop.ptr, &top, top.len));
+    try std.testing.expectEqual(actor, top[0].id);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, actor, null, 0, 2));
     try loop.run();
-    try std.testing.expect(state >= 1);
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 1), stats.mem_limit_hits);
+    try std.testing.expect(stats.mem_peak_bytes >= stats.mem_bytes + 4096);
 }
 
 const RestartState = struct {
@@ -475,6 +2008,323 @@ test "supervisor escalates when intensity exceeded" {
     try std.testing.expectEqual(@as(u32, 3), child_state.runs);
 }
 
+test "dynamic supervisor starts, restarts and terminates children" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var child_state = RestartState{};
+    var template = [_]c.jzx_child_spec{.{
+        .behavior = failThenStop,
+        .state = &child_state,
+        .mode = c.JZX_CHILD_TRANSIENT,
+        .mailbox_cap = 0,
+        .restart_delay_ms = 0,
+        .backoff = c.JZX_BACKOFF_NONE,
+    }};
+    var sup_init = c.jzx_supervisor_init{
+        .children = &template,
+        .child_count = template.len,
+        .supervisor = .{
+            .strategy = c.JZX_SUP_SIMPLE_ONE_FOR_ONE,
+            .intensity = 5,
+            .period_ms = 1000,
+            .backoff = c.JZX_BACKOFF_NONE,
+            .backoff_delay_ms = 0,
+        },
+    };
+
+    var sup_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn_supervisor(loop.ptr, &sup_init, 0, &sup_id));
+    var count: usize = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, sup_id, &count));
+    try std.testing.expectEqual(@as(usize, 0), count);
+
+    var ids = [_]c.jzx_actor_id{0} ** 4;
+    for (&ids) |*idptr| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_start_child(loop.ptr, sup_id, null, idptr));
+        try std.testing.expect(idptr.* != 0);
+    }
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_terminate_child(loop.ptr, sup_id, ids[0]));
+    try std.testing.expectEqual(c.JZX_ERR_NO_SUCH_ACTOR, c.jzx_supervisor_terminate_child(loop.ptr, sup_id, ids[0]));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, sup_id, &count));
+    try std.testing.expectEqual(@as(usize, 3), count);
+
+    var runner = try std.Thread.spawn(.{}, struct {
+        fn run(lp: *jzx.Loop) void {
+            _ = lp.run() catch {};
+        }
+    }.run, .{&loop});
+
+    // The first message fails the child; the supervisor restarts it in place.
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, ids[1], null, 0, 0));
+    std.Thread.sleep(20 * std.time.ns_per_ms);
+    loop.requestStop();
+    runner.join();
+
+    try std.testing.expectEqual(@as(u32, 1), child_state.runs);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, sup_id, &count));
+    try std.testing.expectEqual(@as(usize, 3), count);
+}
+
+test "supervisor apis accept self-qualified ids" {
+    var loop = try jzx.Loop.create(null);
+    defer loop.deinit();
+
+    var child_state = RestartState{};
+    var template = [_]c.jzx_child_spec{.{
+        .behavior = failThenStop,
+        .state = &child_state,
+        .mode = c.JZX_CHILD_TRANSIENT,
+        .mailbox_cap = 0,
+        .restart_delay_ms = 0,
+        .backoff = c.JZX_BACKOFF_NONE,
+    }};
+    var sup_init = c.jzx_supervisor_init{
+        .children = &template,
+        .child_count = template.len,
+        .supervisor = .{
+            .strategy = c.JZX_SUP_SIMPLE_ONE_FOR_ONE,
+            .intensity = 5,
+            .period_ms = 1000,
+            .backoff = c.JZX_BACKOFF_NONE,
+            .backoff_delay_ms = 0,
+        },
+    };
+    var sup_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn_supervisor(loop.ptr, &sup_init, 0, &sup_id));
+
+    var node_opts = c.jzx_node_opts{ .node_id = 1, .unix_path = null, .batch_bytes = 0, .max_queued = 0, .max_frame = 0, .owner = 0 };
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_node_start(loop.ptr, &node_opts));
+    const self_sup = c.jzx_node_actor(1, sup_id);
+
+    var child: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_start_child(loop.ptr, self_sup, null, &child));
+    var count: usize = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, self_sup, &count));
+    try std.testing.expectEqual(@as(usize, 1), count);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_terminate_child(loop.ptr, self_sup, c.jzx_node_actor(1, child)));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, sup_id, &count));
+    try std.testing.expectEqual(@as(usize, 0), count);
+    try std.testing.expectEqual(c.JZX_ERR_NO_SUCH_ACTOR, c.jzx_supervisor_count_children(loop.ptr, c.jzx_node_actor(2, sup_id), &count));
+
+    // Child exits are delivered locally, so only a local supervisor is accepted.
+    var opts = c.jzx_spawn_opts{
+        .behavior = failThenStop,
+        .state = &child_state,
+        .supervisor = self_sup,
+        .mailbox_cap = 0,
+    };
+    var plain: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &plain));
+    opts.supervisor = c.jzx_node_actor(2, sup_id);
+    try std.testing.expectEqual(c.JZX_ERR_INVALID_ARG, c.jzx_spawn(loop.ptr, &opts, &plain));
+
+    c.jzx_node_stop(loop.ptr);
+}
+
+test "dynamic child whose restart cannot spawn gives its slot back" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.max_actors = 2;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var child_state = RestartState{};
+    var template = [_]c.jzx_child_spec{.{
+        .behavior = alwaysFail,
+        .state = &child_state,
+        .mode = c.JZX_CHILD_PERMANENT,
+        .mailbox_cap = 0,
+        .restart_delay_ms = 5,
+        .backoff = c.JZX_BACKOFF_NONE,
+    }};
+    var sup_init = c.jzx_supervisor_init{
+        .children = &template,
+        .child_count = template.len,
+        .supervisor = .{
+            .strategy = c.JZX_SUP_SIMPLE_ONE_FOR_ONE,
+            .intensity = 5,
+            .period_ms = 1000,
+            .backoff = c.JZX_BACKOFF_NONE,
+            .backoff_delay_ms = 0,
+        },
+    };
+    var sup_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn_supervisor(loop.ptr, &sup_init, 0, &sup_id));
+    var child_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_start_child(loop.ptr, sup_id, null, &child_id));
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, child_id, null, 0, 0));
+    var i: u32 = 0;
+    while (i < 4) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(@as(u32, 1), child_state.runs);
+
+    // Take the failed child's table entry so its delayed restart cannot spawn.
+    var state: u32 = 0;
+    var opts = c.jzx_spawn_opts{ .behavior = stopOnFirst, .state = &state, .supervisor = 0, .mailbox_cap = 0 };
+    var blocker: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn(loop.ptr, &opts, &blocker));
+    i = 0;
+    while (i < 30) : (i += 1) {
+        std.Thread.sleep(std.time.ns_per_ms);
+        _ = try loop.runOnce(1);
+    }
+    var count: usize = 99;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_count_children(loop.ptr, sup_id, &count));
+    try std.testing.expectEqual(@as(usize, 0), count);
+
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, blocker, null, 0, 0));
+    i = 0;
+    while (i < 4) : (i += 1) _ = try loop.runOnce(0);
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_start_child(loop.ptr, sup_id, null, &child_id));
+}
+
+test "restart token bucket defers restarts beyond the loop-wide rate" {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.restart_rate_per_sec = 1;
+    cfg.restart_burst = 1;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var child_state = RestartState{};
+    var template = [_]c.jzx_child_spec{.{
+        .behavior = alwaysFail,
+        .state = &child_state,
+        .mode = c.JZX_CHILD_PERMANENT,
+        .mailbox_cap = 0,
+        .restart_delay_ms = 0,
+        .backoff = c.JZX_BACKOFF_NONE,
+    }};
+    var sup_init = c.jzx_supervisor_init{
+        .children = &template,
+        .child_count = template.len,
+        .supervisor = .{
+            .strategy = c.JZX_SUP_SIMPLE_ONE_FOR_ONE,
+            .intensity = 0,
+            .period_ms = 0,
+            .backoff = c.JZX_BACKOFF_NONE,
+            .backoff_delay_ms = 0,
+            .jitter = c.JZX_JITTER_FULL,
+            .backoff_max_ms = 0,
+        },
+    };
+    var sup_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn_supervisor(loop.ptr, &sup_init, 0, &sup_id));
+
+    var ids = [_]c.jzx_actor_id{0} ** 2;
+    for (&ids) |*idptr| {
+        try std.testing.expectEqual(c.JZX_OK, c.jzx_supervisor_start_child(loop.ptr, sup_id, null, idptr));
+    }
+
+    var runner = try std.Thread.spawn(.{}, struct {
+        fn run(lp: *jzx.Loop) void {
+            _ = lp.run() catch {};
+        }
+    }.run, .{&loop});
+
+    for (ids) |idval| {
+        _ = c.jzx_send(loop.ptr, idval, null, 0, 0);
+    }
+    std.Thread.sleep(20 * std.time.ns_per_ms);
+    loop.requestStop();
+    runner.join();
+
+    var stats: c.jzx_loop_stats = undefined;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_loop_get_stats(loop.ptr, &stats));
+    try std.testing.expectEqual(@as(u64, 2), stats.restarts);
+    try std.testing.expectEqual(@as(u64, 1), stats.restarts_deferred);
+}
+
+const JitterState = struct {
+    runs: u32 = 0,
+    at_ms: [12]u64 = [_]u64{0} ** 12,
+};
+
+fn jitterRecorder(ctx: [*c]c.jzx_context, msg: [*c]const c.jzx_message) callconv(.c) c.jzx_behavior_result {
+    _ = msg;
+    const ctx_ptr = @as(*c.jzx_context, @ptrCast(ctx));
+    const state = @as(*JitterState, @ptrCast(@alignCast(ctx_ptr.state.?)));
+    if (state.runs < state.at_ms.len) {
+        state.at_ms[state.runs] = c.jzx_loop_now_ms(ctx_ptr.loop.?);
+    }
+    state.runs += 1;
+    return c.JZX_BEHAVIOR_FAIL;
+}
+
+// Fails one child repeatedly on a seeded virtual-time loop and returns the
+// gaps between failures, i.e. the restart delays.
+fn jitterDelays(jitter: c.jzx_jitter_type, step_ms: u32, cap_ms: u32) ![11]u64 {
+    var cfg: c.jzx_config = undefined;
+    c.jzx_config_init(&cfg);
+    cfg.virtual_time = 1;
+    cfg.sched_seed = 7;
+    var loop = try jzx.Loop.create(cfg);
+    defer loop.deinit();
+
+    var state = JitterState{};
+    var child_spec = [_]c.jzx_child_spec{.{
+        .behavior = jitterRecorder,
+        .state = &state,
+        .mode = c.JZX_CHILD_PERMANENT,
+        .mailbox_cap = 0,
+        .restart_delay_ms = 0,
+        .backoff = c.JZX_BACKOFF_NONE,
+    }};
+    var sup_init = c.jzx_supervisor_init{
+        .children = &child_spec,
+        .child_count = child_spec.len,
+        .supervisor = .{
+            .strategy = c.JZX_SUP_ONE_FOR_ONE,
+            .intensity = 0,
+            .period_ms = 0,
+            .backoff = c.JZX_BACKOFF_EXPONENTIAL,
+            .backoff_delay_ms = step_ms,
+            .jitter = jitter,
+            .backoff_max_ms = cap_ms,
+        },
+    };
+    var sup_id: c.jzx_actor_id = 0;
+    try std.testing.expectEqual(c.JZX_OK, c.jzx_spawn_supervisor(loop.ptr, &sup_init, 0, &sup_id));
+    var last: c.jzx_actor_id = 0;
+    var spins: u32 = 0;
+    while (state.runs < state.at_ms.len) : (spins += 1) {
+        try std.testing.expect(spins < 1000);
+        var child: c.jzx_actor_id = 0;
+        _ = c.jzx_supervisor_child_id(loop.ptr, sup_id, 0, &child);
+        if (child != 0 and child != last) {
+            last = child;
+            try std.testing.expectEqual(c.JZX_OK, c.jzx_send(loop.ptr, child, null, 0, 0));
+        }
+        _ = try loop.runOnce(0);
+    }
+    var delays: [11]u64 = undefined;
+    for (&delays, 0..) |*d, i| d.* = state.at_ms[i + 1] - state.at_ms[i];
+    return delays;
+}
+
+test "restart jitter draws below the backoff cap" {
+    // The exponential backoff passes the 100ms cap on the first restart; the
+    // draw must still spread over [0, cap] rather than sit on it.
+    const full = try jitterDelays(c.JZX_JITTER_FULL, 1000, 100);
+    var at_cap: u32 = 0;
+    for (full) |d| {
+        try std.testing.expect(d <= 100);
+        if (d == 100) at_cap += 1;
+    }
+    try std.testing.expect(at_cap < 3);
+
+    const decorrelated = try jitterDelays(c.JZX_JITTER_DECORRELATED, 10, 100);
+    at_cap = 0;
+    for (decorrelated) |d| {
+        try std.testing.expect(d >= 10 and d <= 100);
+        if (d == 100) at_cap += 1;
+    }
+    try std.testing.expect(at_cap < 3);
+
+    // The same seed gives the same schedule.
+    try std.testing.expectEqualSlices(u64, &full, &(try jitterDelays(c.JZX_JITTER_FULL, 1000, 100)));
+}
+
 const BackoffState = struct {
     runs: u32 = 0,
     t1_ms: u64 = 0,